@@ -16,13 +16,69 @@
 
 #include "device_info.h"
 
+#include <atomic>
+
 #include "utils.h"
 
+namespace {
+
+const char kDisplayWidth[] = "DisplayWidth";
+const char kDisplayHeight[] = "DisplayHeight";
+const char kSystemLanguage[] = "SystemLanguage";
+
+bool IsSnapshotKey(const std::string& name) {
+  static const char* const kSnapshotKeys[] = {kDisplayWidth,
+                                              kDisplayHeight,
+                                              kSystemLanguage,
+                                              "HardwareScreenWidth",
+                                              "HardwareScreenHeight",
+                                              "ModelName",
+                                              "FirmwareVersion",
+                                              "boardType",
+                                              "LocalCountry",
+                                              "SmartServiceCountry",
+                                              "CountryGroup",
+                                              "TvSystemName",
+                                              "TvDeviceInfo",
+                                              "ScreenRotation",
+                                              "supportDolbyHDRContents"};
+  for (const char* key : kSnapshotKeys) {
+    if (name == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// platform versions are <major>.<minor>.<dot>
+void ParsePlatformVersion(DeviceSnapshot& snapshot) {
+  const std::string& version = snapshot.platform_version;
+  size_t major_pos = version.find_first_of('.');
+  size_t minor_pos = std::string::npos;
+  if (major_pos != std::string::npos) {
+    minor_pos = version.find_first_of('.', major_pos + 1);
+  }
+  if (minor_pos == std::string::npos) {
+    return;
+  }
+
+  snapshot.platform_version_major =
+      util::StrToIntWithDefault(version.substr(0, major_pos), 0);
+  snapshot.platform_version_minor = util::StrToIntWithDefault(
+      version.substr(major_pos + 1, minor_pos - major_pos - 1), 0);
+  snapshot.platform_version_dot =
+      util::StrToIntWithDefault(version.substr(minor_pos + 1), 0);
+}
+
+}  // namespace
+
+DeviceInfo::DeviceInfo() : snapshot_(std::make_shared<DeviceSnapshot>()) {}
+
 bool DeviceInfo::GetDisplayWidth(int& value) const {
   bool ret = false;
   std::string value_str;
 
-  ret = GetDeviceInfo("DisplayWidth", value_str);
+  ret = GetDeviceInfo(kDisplayWidth, value_str);
   if (ret) {
     ret = util::StrToInt(value_str, value);
   }
@@ -31,16 +87,14 @@ bool DeviceInfo::GetDisplayWidth(int& value) const {
 }
 
 void DeviceInfo::SetDisplayWidth(int value) {
-  if (!device_info_.emplace("DisplayWidth", std::to_string(value)).second) {
-    device_info_["DisplayWidth"] = std::to_string(value);
-  }
+  SetValue(kDisplayWidth, std::to_string(value));
 }
 
 bool DeviceInfo::GetDisplayHeight(int& value) const {
   bool ret = false;
   std::string value_str;
 
-  ret = GetDeviceInfo("DisplayHeight", value_str);
+  ret = GetDeviceInfo(kDisplayHeight, value_str);
   if (ret) {
     ret = util::StrToInt(value_str, value);
   }
@@ -49,19 +103,15 @@ bool DeviceInfo::GetDisplayHeight(int& value) const {
 }
 
 void DeviceInfo::SetDisplayHeight(int value) {
-  if (!device_info_.emplace("DisplayHeight", std::to_string(value)).second) {
-    device_info_["DisplayHeight"] = std::to_string(value);
-  }
+  SetValue(kDisplayHeight, std::to_string(value));
 }
 
 bool DeviceInfo::GetSystemLanguage(std::string& value) const {
-  return GetDeviceInfo("SystemLanguage", value);
+  return GetDeviceInfo(kSystemLanguage, value);
 }
 
 void DeviceInfo::SetSystemLanguage(const std::string& value) {
-  if (!device_info_.emplace("SystemLanguage", value).second) {
-    device_info_["SystemLanguage"] = value;
-  }
+  SetValue(kSystemLanguage, value);
 }
 
 bool DeviceInfo::GetDeviceInfo(const std::string& name,
@@ -77,7 +127,69 @@ bool DeviceInfo::GetDeviceInfo(const std::string& name,
 
 void DeviceInfo::SetDeviceInfo(const std::string& name,
                                const std::string& value) {
-  if (!device_info_.emplace(name, value).second) {
-    device_info_[name] = value;
+  SetValue(name, value);
+}
+
+std::shared_ptr<const DeviceSnapshot> DeviceInfo::Snapshot() const {
+  return std::atomic_load(&snapshot_);
+}
+
+void DeviceInfo::SetValue(const std::string& name, const std::string& value) {
+  auto info = device_info_.find(name);
+  if (info != device_info_.end()) {
+    if (info->second == value) {
+      return;
+    }
+    info->second = value;
+  } else {
+    device_info_.emplace(name, value);
+  }
+
+  if (IsSnapshotKey(name)) {
+    PublishSnapshot();
+  }
+}
+
+void DeviceInfo::PublishSnapshot() {
+  auto snapshot = std::make_shared<DeviceSnapshot>();
+  auto get = [this](const char* name) -> const std::string* {
+    auto info = device_info_.find(name);
+    return info != device_info_.end() ? &info->second : nullptr;
+  };
+  auto get_string = [&get](const char* name) {
+    const std::string* value = get(name);
+    return value ? *value : std::string();
+  };
+
+  if (const std::string* value = get(kDisplayWidth)) {
+    snapshot->display_width = util::StrToIntWithDefault(*value, 0);
+  }
+  if (const std::string* value = get(kDisplayHeight)) {
+    snapshot->display_height = util::StrToIntWithDefault(*value, 0);
+  }
+  if (const std::string* value = get("HardwareScreenWidth")) {
+    snapshot->hardware_screen_width = util::StrToIntWithDefault(*value, 0);
+  }
+  if (const std::string* value = get("HardwareScreenHeight")) {
+    snapshot->hardware_screen_height = util::StrToIntWithDefault(*value, 0);
   }
+
+  snapshot->model_name = get_string("ModelName");
+  snapshot->platform_version = get_string("FirmwareVersion");
+  ParsePlatformVersion(*snapshot);
+  snapshot->board_type = get_string("boardType");
+
+  snapshot->system_language = get_string(kSystemLanguage);
+  snapshot->local_country = get_string("LocalCountry");
+  snapshot->smart_service_country = get_string("SmartServiceCountry");
+  snapshot->country_group = get_string("CountryGroup");
+  snapshot->tv_system_name = get_string("TvSystemName");
+  snapshot->tv_device_info = get_string("TvDeviceInfo");
+  snapshot->screen_rotation = get_string("ScreenRotation");
+
+  snapshot->support_dolby_hdr_contents =
+      get_string("supportDolbyHDRContents") == "true";
+
+  std::atomic_store(&snapshot_,
+                    std::shared_ptr<const DeviceSnapshot>(std::move(snapshot)));
 }
@@ -17,11 +17,15 @@
 #ifndef CORE_DEVICE_INFO_H_
 #define CORE_DEVICE_INFO_H_
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
+#include "device_snapshot.h"
+
 class DeviceInfo {
  public:
+  DeviceInfo();
   virtual ~DeviceInfo() = default;
 
   virtual void Initialize() {}
@@ -39,8 +43,17 @@ class DeviceInfo {
   virtual bool GetDeviceInfo(const std::string& name, std::string& value) const;
   virtual void SetDeviceInfo(const std::string& name, const std::string& value);
 
+  // Never null. The returned snapshot is immutable, a new one replaces it
+  // when any of the values it holds is changed.
+  std::shared_ptr<const DeviceSnapshot> Snapshot() const;
+
  private:
+  void SetValue(const std::string& name, const std::string& value);
+  // Builds and publishes a new snapshot from the current values
+  void PublishSnapshot();
+
   std::unordered_map<std::string, std::string> device_info_;
+  std::shared_ptr<const DeviceSnapshot> snapshot_;
 };
 
 #endif  // CORE_DEVICE_INFO_H_
@@ -0,0 +1,45 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "device_snapshot.h"
+
+#include <cmath>
+#include <limits>
+
+float DeviceSnapshot::DevicePixelRatio(int app_width, int app_height) const {
+  if (app_width == 0 || app_height == 0) {
+    return 1.0f;
+  }
+
+  float ratio_x = static_cast<float>(DeviceWidth()) / app_width;
+  float ratio_y = static_cast<float>(DeviceHeight()) / app_height;
+  bool ratios_are_equal =
+      std::abs(ratio_x - ratio_y) < std::numeric_limits<float>::epsilon();
+  if (!ratios_are_equal) {
+    // device resolution : 5120x2160 (UHD 21:9 - D9)
+    // - app resolution : 1280x720 ==> 4:3 (have to take 3)
+    // - app resolution : 1920x1080 ==> 2.6:2 (have to take 2)
+    return (ratio_x < ratio_y) ? ratio_x : ratio_y;
+  }
+
+  // device resolution : 1920x1080
+  // - app resolution : 1280x720 ==> 1.5:1.5
+  // - app resolution : 1920x1080 ==> 1:1
+  // device resolution : 3840x2160
+  // - app resolution : 1280x720 ==> 3:3
+  // - app resolution : 1920x1080 ==> 2:2
+  return ratio_x;
+}
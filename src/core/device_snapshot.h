@@ -0,0 +1,67 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_DEVICE_SNAPSHOT_H_
+#define CORE_DEVICE_SNAPSHOT_H_
+
+#include <optional>
+#include <string>
+
+// Typed, read-only view of the device information. A new snapshot is
+// published by DeviceInfo whenever one of its values changes (locale,
+// display, ...), so a consumer can keep the handle it got for the duration
+// of a task without doing string lookups and re-parsing for every field.
+struct DeviceSnapshot {
+  int display_width = 0;
+  int display_height = 0;
+  std::optional<int> hardware_screen_width;
+  std::optional<int> hardware_screen_height;
+
+  std::string model_name;
+  std::string platform_version;
+  int platform_version_major = -1;
+  int platform_version_minor = -1;
+  int platform_version_dot = -1;
+  std::string board_type;
+
+  std::string system_language;
+  std::string local_country;
+  std::string smart_service_country;
+  std::string country_group;
+  std::string tv_system_name;
+  std::string tv_device_info;
+  std::string screen_rotation;
+
+  bool support_dolby_hdr_contents = false;
+
+  bool HasHardwareResolution() const {
+    return hardware_screen_width.has_value() &&
+           hardware_screen_height.has_value();
+  }
+  // Falls back to the display size when the hardware resolution is unknown
+  int DeviceWidth() const {
+    return HasHardwareResolution() ? *hardware_screen_width : display_width;
+  }
+  int DeviceHeight() const {
+    return HasHardwareResolution() ? *hardware_screen_height : display_height;
+  }
+
+  // Ratio between the device resolution and an app resolution of
+  // |app_width| x |app_height|, 1.0 when the app resolution is unknown.
+  float DevicePixelRatio(int app_width, int app_height) const;
+};
+
+#endif  // CORE_DEVICE_SNAPSHOT_H_
@@ -0,0 +1,272 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "launch_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <json/value.h>
+
+#include "log_manager.h"
+
+namespace {
+
+// Launches have no completion event here, loading pages are polled
+const int kLoadingPollIntervalMs = 100;
+// Long enough for a CPU idle sample to mean something
+const int kDeferredPreloadPollIntervalMs = 500;
+
+}  // namespace
+
+LaunchScheduler::LaunchScheduler(LoadingCheck is_loading)
+    : is_loading_(std::move(is_loading)) {}
+
+void LaunchScheduler::SetMaxConcurrentLaunches(int max_concurrent_launches) {
+  max_concurrent_launches_ = std::max(max_concurrent_launches, 0);
+  StartTimerIfNeeded(0);
+}
+
+void LaunchScheduler::SetLoadTimeoutMs(int load_timeout_ms) {
+  load_timeout_ = std::chrono::milliseconds(std::max(load_timeout_ms, 0));
+}
+
+void LaunchScheduler::SetPreloadDeferral(CpuIdleSampler cpu_idle,
+                                         int idle_threshold,
+                                         int release_interval_ms) {
+  cpu_idle_ = std::move(cpu_idle);
+  preload_idle_threshold_ = std::clamp(idle_threshold, 0, 100);
+  preload_release_interval_ =
+      std::chrono::milliseconds(std::max(release_interval_ms, 0));
+  StartTimerIfNeeded(0);
+}
+
+void LaunchScheduler::SetBootDone(bool boot_done) {
+  if (boot_done_ == boot_done) {
+    return;
+  }
+  boot_done_ = boot_done;
+  StartTimerIfNeeded(0);
+}
+
+bool LaunchScheduler::Admit(const std::string& instance_id,
+                            Priority priority) {
+  if (priority <= kRelaunch) {
+    // The user is waiting, a queued background launch of the same instance
+    // is superseded
+    Cancel(instance_id);
+    return true;
+  }
+
+  if (IsQueued(instance_id)) {
+    return false;
+  }
+  // Only launches of the same or a higher class are ahead in the queue,
+  // held back preloads don't delay anything else
+  bool queued_ahead = std::any_of(
+      queue_.begin(), queue_.end(),
+      [priority](const Entry& entry) { return entry.priority <= priority; });
+  return !queued_ahead && HasFreeSlot(priority);
+}
+
+void LaunchScheduler::Started(const std::string& instance_id,
+                              Priority priority) {
+  wait_ms_[priority].Record(0);
+  if (priority == kPreload) {
+    last_preload_release_ = Clock::now();
+  }
+  PruneFinishedLaunches();
+  loading_.push_back(Loading{instance_id, Clock::now()});
+}
+
+void LaunchScheduler::Enqueue(const std::string& instance_id,
+                              Priority priority,
+                              LaunchTask task,
+                              int rank) {
+  auto queued = std::find_if(
+      queue_.begin(), queue_.end(),
+      [&instance_id](const Entry& entry) {
+        return entry.instance_id == instance_id;
+      });
+
+  Clock::time_point queued_at = Clock::now();
+  if (queued != queue_.end()) {
+    priority = std::min(priority, queued->priority);
+    queued_at = queued->queued_at;
+    queue_.erase(queued);
+  }
+
+  auto position = std::find_if(
+      queue_.begin(), queue_.end(), [priority, rank](const Entry& entry) {
+        return entry.priority > priority ||
+               (entry.priority == priority && entry.rank > rank);
+      });
+  queue_.insert(position, Entry{instance_id, priority, rank, std::move(task),
+                                queued_at});
+
+  LOG_DEBUG("[%s] Launch queued as %s, %zu queued, %zu loading",
+            instance_id.c_str(), PriorityName(priority), queue_.size(),
+            loading_.size());
+  StartTimerIfNeeded(kLoadingPollIntervalMs);
+}
+
+bool LaunchScheduler::Cancel(const std::string& instance_id) {
+  auto queued = std::find_if(
+      queue_.begin(), queue_.end(),
+      [&instance_id](const Entry& entry) {
+        return entry.instance_id == instance_id;
+      });
+  if (queued == queue_.end()) {
+    return false;
+  }
+
+  queue_.erase(queued);
+  if (queue_.empty() && run_timer_.IsRunning()) {
+    run_timer_.Stop();
+  }
+  return true;
+}
+
+void LaunchScheduler::Clear() {
+  if (run_timer_.IsRunning()) {
+    run_timer_.Stop();
+  }
+  queue_.clear();
+  loading_.clear();
+}
+
+bool LaunchScheduler::IsQueued(const std::string& instance_id) const {
+  return std::any_of(queue_.begin(), queue_.end(),
+                     [&instance_id](const Entry& entry) {
+                       return entry.instance_id == instance_id;
+                     });
+}
+
+Json::Value LaunchScheduler::ToJson() const {
+  Json::Value json(Json::objectValue);
+  json["maxConcurrent"] = max_concurrent_launches_;
+  json["queued"] = static_cast<Json::UInt64>(queue_.size());
+  json["loading"] = static_cast<Json::UInt64>(loading_.size());
+  json["deferPreloads"] = static_cast<bool>(cpu_idle_);
+  json["bootDone"] = boot_done_;
+  json["preloadsQueued"] = static_cast<Json::UInt64>(
+      std::count_if(queue_.begin(), queue_.end(), [](const Entry& entry) {
+        return entry.priority == kPreload;
+      }));
+
+  Json::Value wait(Json::objectValue);
+  for (int priority = 0; priority < kPriorityCount; ++priority) {
+    wait[PriorityName(static_cast<Priority>(priority))] =
+        wait_ms_[priority].ToJson();
+  }
+  json["waitMs"] = std::move(wait);
+  return json;
+}
+
+void LaunchScheduler::ResetStats() {
+  for (Histogram& histogram : wait_ms_) {
+    histogram.Reset();
+  }
+}
+
+const char* LaunchScheduler::PriorityName(Priority priority) {
+  switch (priority) {
+    case kForeground:
+      return "foreground";
+    case kRelaunch:
+      return "relaunch";
+    case kKeepAliveRestore:
+      return "keepAliveRestore";
+    case kPreload:
+      return "preload";
+    default:
+      return "unknown";
+  }
+}
+
+bool LaunchScheduler::HasFreeSlot(Priority priority) {
+  if (priority <= kRelaunch) {
+    return true;
+  }
+  if (max_concurrent_launches_ > 0) {
+    PruneFinishedLaunches();
+    if (loading_.size() >= static_cast<size_t>(max_concurrent_launches_)) {
+      return false;
+    }
+  }
+  return priority != kPreload || CanReleasePreload();
+}
+
+bool LaunchScheduler::CanReleasePreload() {
+  if (!cpu_idle_) {
+    return true;
+  }
+  if (!boot_done_ ||
+      Clock::now() - last_preload_release_ < preload_release_interval_) {
+    return false;
+  }
+  // Sampled last, so that the sample spans the time since the last check
+  return cpu_idle_() >= preload_idle_threshold_;
+}
+
+void LaunchScheduler::PruneFinishedLaunches() {
+  const Clock::time_point now = Clock::now();
+  loading_.erase(std::remove_if(loading_.begin(), loading_.end(),
+                                [this, now](const Loading& loading) {
+                                  return now - loading.started_at >=
+                                             load_timeout_ ||
+                                         !is_loading_(loading.instance_id);
+                                }),
+                 loading_.end());
+}
+
+void LaunchScheduler::RunQueuedLaunches() {
+  while (!queue_.empty() && HasFreeSlot(queue_.front().priority)) {
+    Entry entry = std::move(queue_.front());
+    queue_.pop_front();
+
+    RecordWait(entry.priority, entry.queued_at);
+    if (entry.priority == kPreload) {
+      last_preload_release_ = Clock::now();
+    }
+    LOG_DEBUG("[%s] Run queued %s launch", entry.instance_id.c_str(),
+              PriorityName(entry.priority));
+    if (entry.task()) {
+      loading_.push_back(Loading{entry.instance_id, Clock::now()});
+    }
+  }
+
+  bool preloads_deferred =
+      cpu_idle_ && !queue_.empty() && queue_.front().priority == kPreload;
+  StartTimerIfNeeded(preloads_deferred ? kDeferredPreloadPollIntervalMs
+                                       : kLoadingPollIntervalMs);
+}
+
+void LaunchScheduler::StartTimerIfNeeded(int delay_ms) {
+  if (queue_.empty() || run_timer_.IsRunning()) {
+    return;
+  }
+  run_timer_.StartWithReceiver(delay_ms, this,
+                               &LaunchScheduler::RunQueuedLaunches);
+}
+
+void LaunchScheduler::RecordWait(Priority priority,
+                                 Clock::time_point queued_at) {
+  wait_ms_[priority].Record(
+      std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                            queued_at)
+          .count());
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LAUNCH_SCHEDULER_H_
+#define CORE_LAUNCH_SCHEDULER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "service_stats.h"
+#include "timer.h"
+
+namespace Json {
+class Value;
+}
+
+// Admits app launches, which each start loading a page, by priority and no
+// more than |max_concurrent_launches| loading at a time. A burst of
+// background launches (preloads after boot, keep alive apps being restored)
+// is queued instead of competing with the launch the user is waiting for.
+// User initiated launches and relaunches are never held back; they only go
+// ahead of queued background launches and count against the limit.
+//
+// Preloads can additionally be deferred until boot is done and the CPU is
+// idle enough, and are then released one at a time.
+class LaunchScheduler {
+ public:
+  enum Priority {
+    kForeground = 0,
+    kRelaunch,
+    kKeepAliveRestore,
+    kPreload,
+    kPriorityCount
+  };
+
+  // Starts a queued launch. Returns true if a page is loading for it.
+  using LaunchTask = std::function<bool()>;
+  // Whether the page launched for |instance_id| is still loading
+  using LoadingCheck = std::function<bool(const std::string& instance_id)>;
+  // Percentage of CPU time spent idle since the previous call
+  using CpuIdleSampler = std::function<int()>;
+
+  explicit LaunchScheduler(LoadingCheck is_loading);
+  LaunchScheduler(const LaunchScheduler&) = delete;
+  LaunchScheduler& operator=(const LaunchScheduler&) = delete;
+  ~LaunchScheduler() = default;
+
+  // 0 admits every launch right away
+  void SetMaxConcurrentLaunches(int max_concurrent_launches);
+  // A launch stops counting as loading after this long in any case
+  void SetLoadTimeoutMs(int load_timeout_ms);
+
+  // Holds preloads until SetBootDone(true) and until |cpu_idle| reports at
+  // least |idle_threshold| percent, then releases them no faster than one
+  // per |release_interval_ms|. Passing a null |cpu_idle| stops deferring.
+  void SetPreloadDeferral(CpuIdleSampler cpu_idle,
+                          int idle_threshold,
+                          int release_interval_ms);
+  void SetBootDone(bool boot_done);
+
+  // Returns true if the launch of |instance_id| may start now, in which case
+  // the caller reports it with Started(). Otherwise it has to be queued with
+  // Enqueue(). An admitted launch replaces a queued one of the same instance.
+  bool Admit(const std::string& instance_id, Priority priority);
+  void Started(const std::string& instance_id, Priority priority);
+  // Queues |task| by |priority|, then by |rank| and FIFO among equal ranks.
+  // Queueing an instance which is already queued replaces its task and keeps
+  // the higher of both priorities.
+  void Enqueue(const std::string& instance_id,
+               Priority priority,
+               LaunchTask task,
+               int rank = 0);
+  // Drops the queued launch of |instance_id|, e.g. when it is killed
+  bool Cancel(const std::string& instance_id);
+  void Clear();
+
+  bool IsQueued(const std::string& instance_id) const;
+  size_t QueuedCount() const { return queue_.size(); }
+  size_t LoadingCount() const { return loading_.size(); }
+
+  // {"maxConcurrent", "queued", "loading", "deferPreloads", "bootDone",
+  //  "preloadsQueued", "waitMs": {class: Histogram}}
+  Json::Value ToJson() const;
+  void ResetStats();
+
+  static const char* PriorityName(Priority priority);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::string instance_id;
+    Priority priority;
+    int rank;
+    LaunchTask task;
+    Clock::time_point queued_at;
+  };
+  struct Loading {
+    std::string instance_id;
+    Clock::time_point started_at;
+  };
+
+  bool HasFreeSlot(Priority priority);
+  bool CanReleasePreload();
+  void PruneFinishedLaunches();
+  void RunQueuedLaunches();
+  void StartTimerIfNeeded(int delay_ms);
+  void RecordWait(Priority priority, Clock::time_point queued_at);
+
+  LoadingCheck is_loading_;
+  std::list<Entry> queue_;
+  std::vector<Loading> loading_;
+
+  int max_concurrent_launches_ = 0;
+  std::chrono::milliseconds load_timeout_{5000};
+
+  CpuIdleSampler cpu_idle_;
+  int preload_idle_threshold_ = 0;
+  std::chrono::milliseconds preload_release_interval_{0};
+  bool boot_done_ = false;
+  Clock::time_point last_preload_release_;
+
+  Histogram wait_ms_[kPriorityCount];
+
+  OneShotTimer<LaunchScheduler> run_timer_;
+};
+
+#endif  // CORE_LAUNCH_SCHEDULER_H_
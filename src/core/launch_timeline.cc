@@ -0,0 +1,117 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "launch_timeline.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <json/value.h>
+
+LaunchTimelineRecorder::LaunchTimelineRecorder(size_t capacity)
+    : capacity_(capacity) {}
+
+void LaunchTimelineRecorder::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  Clear();
+}
+
+void LaunchTimelineRecorder::Record(const std::string& instance_id,
+                                    const LaunchTiming& timing,
+                                    Outcome outcome) {
+  if (!capacity_) {
+    return;
+  }
+
+  Timeline timeline{instance_id, timing, outcome};
+  if (timelines_.size() < capacity_) {
+    timelines_.push_back(std::move(timeline));
+  } else {
+    timelines_[next_] = std::move(timeline);
+  }
+  next_ = (next_ + 1) % capacity_;
+}
+
+void LaunchTimelineRecorder::Clear() {
+  timelines_.clear();
+  timelines_.reserve(capacity_);
+  next_ = 0;
+}
+
+int64_t LaunchTimelineRecorder::Percentile(std::vector<int64_t> values,
+                                           double percentile) {
+  if (values.empty()) {
+    return 0;
+  }
+
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+  rank = std::clamp<size_t>(rank, 1, values.size());
+  std::nth_element(values.begin(), values.begin() + (rank - 1), values.end());
+  return values[rank - 1];
+}
+
+Json::Value LaunchTimelineRecorder::ToJson() const {
+  Json::Value json(Json::objectValue);
+  json["capacity"] = static_cast<Json::UInt64>(capacity_);
+
+  std::array<std::vector<int64_t>, LaunchTiming::kStageCount> stage_ms;
+  Json::Value timelines(Json::arrayValue);
+  size_t size = timelines_.size();
+  for (size_t i = 1; i <= size; ++i) {
+    const Timeline& timeline = timelines_[(next_ + size - i) % size];
+
+    Json::Value entry(Json::objectValue);
+    entry["appId"] = timeline.timing.AppId();
+    entry["instanceId"] = timeline.instance_id;
+    entry["outcome"] = timeline.outcome == kShown ? "shown" : "closed";
+    entry["stages"] = timeline.timing.ToJson();
+    timelines.append(std::move(entry));
+
+    for (int stage = 0; stage < LaunchTiming::kStageCount; ++stage) {
+      auto current = static_cast<LaunchTiming::Stage>(stage);
+      if (!timeline.timing.Reached(current)) {
+        continue;
+      }
+      LaunchTiming::Stage previous = timeline.timing.PreviousReached(current);
+      int64_t since = previous == LaunchTiming::kStageCount
+                          ? 0
+                          : timeline.timing.ElapsedMs(previous);
+      stage_ms[stage].push_back(timeline.timing.ElapsedMs(current) - since);
+    }
+  }
+  json["timelines"] = std::move(timelines);
+
+  Json::Value stages(Json::objectValue);
+  for (int stage = 0; stage < LaunchTiming::kStageCount; ++stage) {
+    const std::vector<int64_t>& values = stage_ms[stage];
+    if (values.empty()) {
+      continue;
+    }
+    Json::Value percentiles(Json::objectValue);
+    percentiles["count"] = static_cast<Json::UInt64>(values.size());
+    percentiles["p50"] = static_cast<Json::Int64>(Percentile(values, 50));
+    percentiles["p90"] = static_cast<Json::Int64>(Percentile(values, 90));
+    percentiles["p99"] = static_cast<Json::Int64>(Percentile(values, 99));
+    percentiles["max"] = static_cast<Json::Int64>(
+        *std::max_element(values.begin(), values.end()));
+    stages[LaunchTiming::StageName(static_cast<LaunchTiming::Stage>(stage))] =
+        std::move(percentiles);
+  }
+  json["stageMs"] = std::move(stages);
+  return json;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LAUNCH_TIMELINE_H_
+#define CORE_LAUNCH_TIMELINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "launch_timing.h"
+
+namespace Json {
+class Value;
+}
+
+// Keeps the timelines of the last |capacity| launches in a ring buffer, to
+// tell which stage the time of slow launches went to.
+class LaunchTimelineRecorder {
+ public:
+  enum Outcome { kShown = 0, kClosed };
+
+  explicit LaunchTimelineRecorder(size_t capacity = 50);
+  LaunchTimelineRecorder(const LaunchTimelineRecorder&) = delete;
+  LaunchTimelineRecorder& operator=(const LaunchTimelineRecorder&) = delete;
+  ~LaunchTimelineRecorder() = default;
+
+  // Drops the recorded timelines. 0 disables recording.
+  void SetCapacity(size_t capacity);
+  size_t Capacity() const { return capacity_; }
+  size_t Size() const { return timelines_.size(); }
+
+  void Record(const std::string& instance_id,
+              const LaunchTiming& timing,
+              Outcome outcome);
+  void Clear();
+
+  // Nearest rank |percentile| of |values|, 0 if empty
+  static int64_t Percentile(std::vector<int64_t> values, double percentile);
+
+  // {"capacity",
+  //  "timelines": [{"appId", "instanceId", "outcome", "stages"}],
+  //  "stageMs": {stage: {"count", "p50", "p90", "p99", "max"}}}
+  // Timelines are newest first. stageMs covers the time each stage took
+  // from the one reached before it, or from the request for the first one.
+  Json::Value ToJson() const;
+
+ private:
+  struct Timeline {
+    std::string instance_id;
+    LaunchTiming timing;
+    Outcome outcome;
+  };
+
+  size_t capacity_;
+  // Slot the next timeline is written to
+  size_t next_ = 0;
+  std::vector<Timeline> timelines_;
+};
+
+#endif  // CORE_LAUNCH_TIMELINE_H_
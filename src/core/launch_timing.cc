@@ -0,0 +1,77 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "launch_timing.h"
+
+#include <string>
+
+#include <json/value.h>
+
+void LaunchTiming::Mark(Stage stage) {
+  if (Reached(stage)) {
+    return;
+  }
+  stage_ms_[stage] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         Clock::now() - received_)
+                         .count();
+}
+
+LaunchTiming::Stage LaunchTiming::PreviousReached(Stage stage) const {
+  for (int previous = stage - 1; previous >= 0; --previous) {
+    if (stage_ms_[previous] >= 0) {
+      return static_cast<Stage>(previous);
+    }
+  }
+  return kStageCount;
+}
+
+Json::Value LaunchTiming::ToJson() const {
+  Json::Value json(Json::objectValue);
+  for (int stage = 0; stage < kStageCount; ++stage) {
+    if (stage_ms_[stage] >= 0) {
+      json[std::string(StageName(static_cast<Stage>(stage))) + "Ms"] =
+          static_cast<Json::Int64>(stage_ms_[stage]);
+    }
+  }
+  return json;
+}
+
+const char* LaunchTiming::StageName(Stage stage) {
+  switch (stage) {
+    case kDescriptionParsed:
+      return "descriptionParsed";
+    case kParamsParsed:
+      return "paramsParsed";
+    case kAdmitted:
+      return "admitted";
+    case kWindowCreated:
+      return "windowCreated";
+    case kPageCreated:
+      return "pageCreated";
+    case kLoadStarted:
+      return "loadStarted";
+    case kLoadIssued:
+      return "loadIssued";
+    case kFirstPaint:
+      return "firstPaint";
+    case kLoadFinished:
+      return "loadFinished";
+    case kFirstFrame:
+      return "firstFrame";
+    default:
+      return "unknown";
+  }
+}
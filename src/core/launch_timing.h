@@ -0,0 +1,81 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LAUNCH_TIMING_H_
+#define CORE_LAUNCH_TIMING_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Json {
+class Value;
+}
+
+// When each stage of an app launch was reached, counted on the monotonic
+// clock from the moment WAM received the launch request.
+class LaunchTiming {
+ public:
+  // In launch order
+  enum Stage {
+    kDescriptionParsed = 0,  // ApplicationDescription built from appDesc
+    kParamsParsed,
+    kAdmitted,  // left the launch queue, if it was queued at all
+    kWindowCreated,
+    kPageCreated,  // includes WebPageBase::Init()
+    kLoadStarted,
+    kLoadIssued,  // WebPageBase::Load() returned
+    kFirstPaint,  // first visually non empty frame committed
+    kLoadFinished,
+    kFirstFrame,  // first frame swapped to the screen
+    kStageCount
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  LaunchTiming() : received_(Clock::now()) {}
+
+  const std::string& AppId() const { return app_id_; }
+  void SetAppId(const std::string& app_id) { app_id_ = app_id; }
+
+  // Only the first time a stage is reached counts
+  void Mark(Stage stage);
+  bool Reached(Stage stage) const { return stage_ms_[stage] >= 0; }
+  // Milliseconds from the request to |stage|, or -1 if not reached
+  int64_t ElapsedMs(Stage stage) const { return stage_ms_[stage]; }
+
+  // The stage reached last before |stage|, or kStageCount if none was
+  Stage PreviousReached(Stage stage) const;
+
+  // {"descriptionParsedMs", "paramsParsedMs", ...} for the stages reached
+  Json::Value ToJson() const;
+
+  static const char* StageName(Stage stage);
+
+ private:
+  Clock::time_point received_;
+  std::string app_id_;
+  std::array<int64_t, kStageCount> stage_ms_ = NotReached();
+
+  static std::array<int64_t, kStageCount> NotReached() {
+    std::array<int64_t, kStageCount> stage_ms;
+    stage_ms.fill(-1);
+    return stage_ms;
+  }
+};
+
+#endif  // CORE_LAUNCH_TIMING_H_
@@ -0,0 +1,102 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "launch_tracker.h"
+
+#include <utility>
+
+#include <json/value.h>
+
+#include "log_manager.h"
+
+LaunchTracker::LaunchTracker(InFlightCheck is_in_flight)
+    : is_in_flight_(std::move(is_in_flight)) {}
+
+void LaunchTracker::Started(const std::string& app_id,
+                            const std::string& instance_id,
+                            DisplayId display) {
+  PruneLanded();
+  in_flight_.emplace(app_id, Entry{instance_id, display, Clock::now()});
+}
+
+std::string LaunchTracker::InFlightInstance(const std::string& app_id,
+                                            DisplayId display,
+                                            const std::string& instance_id) {
+  PruneLanded();
+  auto range = in_flight_.equal_range(app_id);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.display == display &&
+        (instance_id.empty() || it->second.instance_id == instance_id)) {
+      return it->second.instance_id;
+    }
+  }
+  return std::string();
+}
+
+void LaunchTracker::Coalesced(const std::string& app_id) {
+  ++coalesced_;
+  LOG_DEBUG("[%s] Launch coalesced into the one in flight, %llu so far",
+            app_id.c_str(), static_cast<unsigned long long>(coalesced_));
+}
+
+bool LaunchTracker::Cancel(const std::string& instance_id) {
+  for (auto it = in_flight_.begin(); it != in_flight_.end(); ++it) {
+    if (it->second.instance_id != instance_id) {
+      continue;
+    }
+
+    bool in_flight = is_in_flight_(instance_id);
+    if (in_flight) {
+      ++cancelled_;
+      wasted_load_ms_.Record(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              Clock::now() - it->second.started_at)
+              .count());
+    }
+    in_flight_.erase(it);
+    return in_flight;
+  }
+  return false;
+}
+
+void LaunchTracker::Clear() {
+  in_flight_.clear();
+}
+
+Json::Value LaunchTracker::ToJson() const {
+  Json::Value json(Json::objectValue);
+  json["inFlight"] = static_cast<Json::UInt64>(in_flight_.size());
+  json["coalesced"] = static_cast<Json::UInt64>(coalesced_);
+  json["cancelled"] = static_cast<Json::UInt64>(cancelled_);
+  json["wastedLoadMs"] = wasted_load_ms_.ToJson();
+  return json;
+}
+
+void LaunchTracker::ResetStats() {
+  coalesced_ = 0;
+  cancelled_ = 0;
+  wasted_load_ms_.Reset();
+}
+
+void LaunchTracker::PruneLanded() {
+  for (auto it = in_flight_.begin(); it != in_flight_.end();) {
+    if (is_in_flight_(it->second.instance_id)) {
+      ++it;
+    } else {
+      it = in_flight_.erase(it);
+    }
+  }
+}
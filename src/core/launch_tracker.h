@@ -0,0 +1,92 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LAUNCH_TRACKER_H_
+#define CORE_LAUNCH_TRACKER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include "display_id.h"
+#include "service_stats.h"
+
+namespace Json {
+class Value;
+}
+
+// Tracks launches, by app id, from the moment their page starts loading
+// until it has painted or finished loading. A second launch of an app which
+// is still in flight on the same display, without asking for another
+// instance, is coalesced into a relaunch of the loading instance instead of
+// starting another load, and a kill arriving before the first paint drops
+// the load at once unless the app is kept alive. Both are counted, as saved
+// and as wasted work respectively.
+class LaunchTracker {
+ public:
+  // Whether the page launched for |instance_id| is still in flight
+  using InFlightCheck = std::function<bool(const std::string& instance_id)>;
+
+  explicit LaunchTracker(InFlightCheck is_in_flight);
+  LaunchTracker(const LaunchTracker&) = delete;
+  LaunchTracker& operator=(const LaunchTracker&) = delete;
+  ~LaunchTracker() = default;
+
+  void Started(const std::string& app_id,
+               const std::string& instance_id,
+               DisplayId display);
+  // Returns the instance of |app_id| in flight on |display| which a launch
+  // of |instance_id| coalesces into, or an empty string. That is the same
+  // instance, or any one when no |instance_id| was requested. The caller
+  // relaunches it and reports that with Coalesced().
+  std::string InFlightInstance(const std::string& app_id,
+                               DisplayId display,
+                               const std::string& instance_id);
+  void Coalesced(const std::string& app_id);
+  // Stops tracking |instance_id|. Returns true if it was still in flight, in
+  // which case the time spent loading is accounted as wasted.
+  bool Cancel(const std::string& instance_id);
+  void Clear();
+
+  size_t InFlightCount() const { return in_flight_.size(); }
+
+  // {"inFlight", "coalesced", "cancelled", "wastedLoadMs": Histogram}
+  Json::Value ToJson() const;
+  void ResetStats();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::string instance_id;
+    DisplayId display;
+    Clock::time_point started_at;
+  };
+
+  void PruneLanded();
+
+  InFlightCheck is_in_flight_;
+  // Keyed by app id
+  std::unordered_multimap<std::string, Entry> in_flight_;
+
+  uint64_t coalesced_ = 0;
+  uint64_t cancelled_ = 0;
+  Histogram wasted_load_ms_;
+};
+
+#endif  // CORE_LAUNCH_TRACKER_H_
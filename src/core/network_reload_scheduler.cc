@@ -0,0 +1,176 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "network_reload_scheduler.h"
+
+#include <algorithm>
+
+#include "log_manager.h"
+#include "timer_wheel.h"
+#include "web_page_base.h"
+
+namespace {
+
+const int kLoadCompleteProgress = 100;
+
+}  // namespace
+
+void NetworkReloadScheduler::SetMaxConcurrentReloads(
+    int max_concurrent_reloads) {
+  max_concurrent_reloads_ = std::max(max_concurrent_reloads, 1);
+}
+
+void NetworkReloadScheduler::SetReloadIntervalMs(int reload_interval_ms) {
+  reload_interval_ms_ = std::max(reload_interval_ms, 0);
+}
+
+void NetworkReloadScheduler::SetReloadTimeoutMs(int reload_timeout_ms) {
+  reload_timeout_ms_ = std::max(reload_timeout_ms, 0);
+}
+
+void NetworkReloadScheduler::Schedule(WebPageBase* page, Priority priority) {
+  if (!page) {
+    return;
+  }
+
+  deferred_.erase(page);
+
+  auto queued = std::find_if(
+      pending_.begin(), pending_.end(),
+      [page](const Entry& entry) { return entry.page == page; });
+  if (queued != pending_.end()) {
+    if (queued->priority <= priority) {
+      return;
+    }
+    pending_.erase(queued);
+  }
+
+  // Keep FIFO order among pages of the same priority
+  auto position = std::find_if(
+      pending_.begin(), pending_.end(),
+      [priority](const Entry& entry) { return entry.priority > priority; });
+  pending_.insert(position, Entry{page, priority});
+
+  StartTimerIfNeeded(0);
+}
+
+void NetworkReloadScheduler::Defer(WebPageBase* page) {
+  if (!page) {
+    return;
+  }
+
+  pending_.remove_if([page](const Entry& entry) { return entry.page == page; });
+  deferred_.insert(page);
+}
+
+void NetworkReloadScheduler::PageShown(WebPageBase* page) {
+  if (deferred_.erase(page)) {
+    Schedule(page, kForeground);
+  }
+}
+
+void NetworkReloadScheduler::PageRemoved(WebPageBase* page) {
+  pending_.remove_if([page](const Entry& entry) { return entry.page == page; });
+  deferred_.erase(page);
+  in_flight_.erase(std::remove_if(in_flight_.begin(), in_flight_.end(),
+                                  [page](const Reload& reload) {
+                                    return reload.page == page;
+                                  }),
+                   in_flight_.end());
+
+  if (pending_.empty() && reload_timer_.IsRunning()) {
+    reload_timer_.Stop();
+  }
+}
+
+void NetworkReloadScheduler::Clear() {
+  if (reload_timer_.IsRunning()) {
+    reload_timer_.Stop();
+  }
+  pending_.clear();
+  deferred_.clear();
+  in_flight_.clear();
+}
+
+bool NetworkReloadScheduler::IsScheduled(WebPageBase* page) const {
+  return std::any_of(
+      pending_.begin(), pending_.end(),
+      [page](const Entry& entry) { return entry.page == page; });
+}
+
+bool NetworkReloadScheduler::IsDeferred(WebPageBase* page) const {
+  return deferred_.find(page) != deferred_.end();
+}
+
+void NetworkReloadScheduler::StartTimerIfNeeded(int delay_ms) {
+  if (pending_.empty() || reload_timer_.IsRunning()) {
+    return;
+  }
+  reload_timer_.StartWithReceiver(delay_ms, this,
+                                  &NetworkReloadScheduler::ReloadNext);
+}
+
+void NetworkReloadScheduler::PruneFinishedReloads() {
+  const int64_t now = TimerWheel::Default()->Now();
+  auto finished = [this, now](const Reload& reload) {
+    if (reload.page->Progress() >= kLoadCompleteProgress) {
+      return true;
+    }
+    if (now - reload.started_ms < reload_timeout_ms_) {
+      return false;
+    }
+    LOG_INFO(MSGID_WAM_DEBUG, 2,
+             PMLOGKS("APP_ID", reload.page->AppId().c_str()),
+             PMLOGKS("INSTANCE_ID", reload.page->InstanceId().c_str()),
+             "Reload of failed URL still loading after %d ms, freeing its "
+             "slot",
+             reload_timeout_ms_);
+    return true;
+  };
+  in_flight_.erase(
+      std::remove_if(in_flight_.begin(), in_flight_.end(), finished),
+      in_flight_.end());
+}
+
+void NetworkReloadScheduler::ReloadNext() {
+  PruneFinishedReloads();
+
+  // At most one reload per tick, so consecutive reloads are spaced by
+  // |reload_interval_ms_| even when the concurrency limit allows more.
+  while (!pending_.empty() &&
+         in_flight_.size() < static_cast<size_t>(max_concurrent_reloads_)) {
+    Entry entry = pending_.front();
+    pending_.pop_front();
+
+    WebPageBase* page = entry.page;
+    // The page may have recovered on its own meanwhile (user reload,
+    // net error reload timer, relaunch)
+    if (page->IsClosing() || !page->IsLoadErrorPageFinish()) {
+      continue;
+    }
+
+    LOG_INFO(MSGID_WAM_DEBUG, 3, PMLOGKS("APP_ID", page->AppId().c_str()),
+             PMLOGKS("INSTANCE_ID", page->InstanceId().c_str()),
+             PMLOGKFV("PRIORITY", "%d", entry.priority),
+             "Reload failed URL '%s' on restore connection",
+             page->FailedUrl().c_str());
+    page->LoadUrl(page->FailedUrl());
+    in_flight_.push_back(Reload{page, TimerWheel::Default()->Now()});
+    break;
+  }
+
+  StartTimerIfNeeded(reload_interval_ms_);
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_NETWORK_RELOAD_SCHEDULER_H_
+#define CORE_NETWORK_RELOAD_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_set>
+#include <vector>
+
+#include "timer.h"
+
+class WebPageBase;
+
+// Reloads pages which failed while the network was down once connectivity is
+// back. Reloads are issued one by one in priority order, no more than
+// |max_concurrent_reloads| at a time and at least |reload_interval_ms| apart,
+// so that restoring the connection does not stall the main loop, the renderers
+// and the fresh connection with dozens of simultaneous loads. A reload holds
+// its slot until the page is loaded, or for |reload_timeout_ms| at most so
+// that a reload which stalls or fails again doesn't starve the others.
+class NetworkReloadScheduler {
+ public:
+  enum Priority { kForeground = 0, kVisible, kBackground };
+
+  NetworkReloadScheduler() = default;
+  NetworkReloadScheduler(const NetworkReloadScheduler&) = delete;
+  NetworkReloadScheduler& operator=(const NetworkReloadScheduler&) = delete;
+  ~NetworkReloadScheduler() = default;
+
+  void SetMaxConcurrentReloads(int max_concurrent_reloads);
+  void SetReloadIntervalMs(int reload_interval_ms);
+  void SetReloadTimeoutMs(int reload_timeout_ms);
+
+  // Queues |page| for reload. Scheduling a page which is already queued
+  // only raises its priority.
+  void Schedule(WebPageBase* page, Priority priority);
+  // Keeps |page| failed until PageShown() is called for it.
+  void Defer(WebPageBase* page);
+  void PageShown(WebPageBase* page);
+  void PageRemoved(WebPageBase* page);
+  // Drops every pending reload, e.g. when connectivity is lost again.
+  void Clear();
+
+  bool IsScheduled(WebPageBase* page) const;
+  bool IsDeferred(WebPageBase* page) const;
+  size_t PendingCount() const { return pending_.size(); }
+  size_t InFlightCount() const { return in_flight_.size(); }
+
+ private:
+  struct Entry {
+    WebPageBase* page;
+    Priority priority;
+  };
+
+  struct Reload {
+    WebPageBase* page;
+    int64_t started_ms;
+  };
+
+  void ReloadNext();
+  void StartTimerIfNeeded(int delay_ms);
+  void PruneFinishedReloads();
+
+  std::list<Entry> pending_;
+  std::unordered_set<WebPageBase*> deferred_;
+  std::vector<Reload> in_flight_;
+
+  int max_concurrent_reloads_ = 2;
+  int reload_interval_ms_ = 300;
+  int reload_timeout_ms_ = 10000;
+
+  OneShotTimer<NetworkReloadScheduler> reload_timer_;
+};
+
+#endif  // CORE_NETWORK_RELOAD_SCHEDULER_H_
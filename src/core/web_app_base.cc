@@ -241,6 +241,8 @@ void WebAppBase::Relaunch(const std::string& args,
 }
 
 void WebAppBase::WebPageLoadFinished() {
+  WebAppManager::Instance()->MarkLaunchStage(InstanceId(),
+                                             LaunchTiming::kLoadFinished);
   DoPendingRelaunch();
 }
 
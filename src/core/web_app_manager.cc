@@ -29,7 +29,13 @@
 
 #include "application_description.h"
 #include "device_info.h"
+#include "error_page_index.h"
+#include "launch_scheduler.h"
+#include "launch_timeline.h"
+#include "launch_tracker.h"
 #include "log_manager.h"
+#include "main_loop_watchdog.h"
+#include "network_reload_scheduler.h"
 #include "network_status_manager.h"
 #include "platform_module_factory.h"
 #include "service_sender.h"
@@ -40,11 +46,26 @@
 #include "web_app_manager_config.h"
 #include "web_app_manager_service.h"
 #include "web_app_manager_tracer.h"
+#include "web_app_manager_utils.h"
 #include "web_page_base.h"
 #include "web_process_manager.h"
 #include "window_types.h"
 
 static const int kContinuousReloadingLimit = 3;
+static const int kLoadCompleteProgress = 100;
+static const int kLaunchBatchHoldTimeoutMs = 1000;
+static const int kFirstFrameReplyTimeoutMs = 10000;
+
+// Hidden launches are preloads, see WebAppBase::SetPreloadState()
+static LaunchScheduler::Priority LaunchPriority(const Json::Value& params) {
+  if (params["preload"].isString() || params["launchedHidden"].asBool()) {
+    return LaunchScheduler::kPreload;
+  }
+  if (params["keepAlive"].asBool()) {
+    return LaunchScheduler::kKeepAliveRestore;
+  }
+  return LaunchScheduler::kForeground;
+}
 
 WebAppManager* WebAppManager::Instance() {
   // not a leak -- static variable initializations are only ever done once
@@ -53,7 +74,19 @@ WebAppManager* WebAppManager::Instance() {
 }
 
 WebAppManager::WebAppManager()
-    : network_status_manager_(std::make_unique<NetworkStatusManager>()) {}
+    : network_status_manager_(std::make_unique<NetworkStatusManager>()),
+      network_reload_scheduler_(std::make_unique<NetworkReloadScheduler>()),
+      launch_scheduler_(std::make_unique<LaunchScheduler>(
+          [this](const std::string& instance_id) {
+            return IsLaunchLoading(instance_id);
+          })),
+      launch_tracker_(std::make_unique<LaunchTracker>(
+          [this](const std::string& instance_id) {
+            return IsLaunchInFlight(instance_id);
+          })),
+      launch_timelines_(std::make_unique<LaunchTimelineRecorder>()),
+      error_page_index_(std::make_unique<ErrorPageIndex>()),
+      main_loop_watchdog_(std::make_unique<MainLoopWatchdog>()) {}
 
 WebAppManager::~WebAppManager() {
   if (device_info_) {
@@ -115,6 +148,55 @@ void WebAppManager::LoadEnvironmentVariable() {
   max_custom_suspend_delay_ =
       web_app_manager_config_->GetMaxCustomSuspendDelayTime();
   web_app_manager_config_->PostInitConfiguration();
+
+  network_reload_scheduler_->SetMaxConcurrentReloads(
+      web_app_manager_config_->GetNetworkReloadMaxConcurrent());
+  network_reload_scheduler_->SetReloadIntervalMs(
+      web_app_manager_config_->GetNetworkReloadIntervalMs());
+  network_status_manager_->SetDebounceIntervalMs(
+      web_app_manager_config_->GetNetworkStatusDebounceIntervalMs());
+  launch_scheduler_->SetMaxConcurrentLaunches(
+      web_app_manager_config_->GetMaxConcurrentLaunches());
+  launch_scheduler_->SetLoadTimeoutMs(
+      web_app_manager_config_->GetLaunchFinishAssureTimeoutMs());
+  launch_timelines_->SetCapacity(
+      static_cast<size_t>(web_app_manager_config_->GetLaunchTimelineCount()));
+  error_page_index_->SetErrorPage(
+      util::UriToLocal(web_app_manager_config_->GetErrorPageUrl()));
+  main_loop_watchdog_->SetThresholdMs(
+      web_app_manager_config_->GetMainLoopLagThresholdMs());
+
+  LaunchScheduler::CpuIdleSampler cpu_idle;
+  if (web_app_manager_config_->IsDeferPreloadsEnabled()) {
+    // Per mille idle since the previous sample
+    cpu_idle = [] { return WebAppManagerUtils::UpdateAndGetCpuIdle() / 10; };
+  }
+  launch_scheduler_->SetPreloadDeferral(
+      std::move(cpu_idle), web_app_manager_config_->GetPreloadIdleThreshold(),
+      web_app_manager_config_->GetPreloadReleaseIntervalMs());
+
+  preload_order_.clear();
+  const std::string preload_order = web_app_manager_config_->GetPreloadOrder();
+  for (std::string_view type : util::Split(preload_order, ',')) {
+    std::string_view trimmed = util::Trim(type);
+    if (!trimmed.empty()) {
+      preload_order_.emplace_back(trimmed);
+    }
+  }
+}
+
+bool WebAppManager::ReloadConfiguration() {
+  if (!web_app_manager_config_ || !web_app_manager_config_->Reload()) {
+    return false;
+  }
+
+  LOG_INFO(MSGID_WAM_DEBUG, 1,
+           PMLOGKS("PATH", web_app_manager_config_->GetOverridePath().c_str()),
+           "Configuration reloaded");
+  // Values cached at startup follow the new configuration, those read at
+  // app/page creation apply to apps launched from now on
+  LoadEnvironmentVariable();
+  return true;
 }
 
 void WebAppManager::SetUiSize(int width, int height) {
@@ -125,19 +207,37 @@ void WebAppManager::SetUiSize(int width, int height) {
 }
 
 int WebAppManager::CurrentUiWidth() {
-  int width = 0;
-  if (device_info_) {
-    device_info_->GetDisplayWidth(width);
-  }
-  return width;
+  return GetDeviceSnapshot()->display_width;
 }
 
 int WebAppManager::CurrentUiHeight() {
-  int height = 0;
-  if (device_info_) {
-    device_info_->GetDisplayHeight(height);
+  return GetDeviceSnapshot()->display_height;
+}
+
+std::shared_ptr<const DeviceSnapshot> WebAppManager::GetDeviceSnapshot() {
+  if (!device_info_) {
+    static const std::shared_ptr<const DeviceSnapshot> kEmptySnapshot =
+        std::make_shared<DeviceSnapshot>();
+    return kEmptySnapshot;
+  }
+  return device_info_->Snapshot();
+}
+
+void WebAppManager::SetActiveInstanceId(const std::string& id) {
+  active_instance_id_ = id;
+
+  // A page kept failed while frozen in background gets its turn once shown
+  WebAppBase* app = FindAppByInstanceId(id);
+  if (app && app->Page()) {
+    network_reload_scheduler_->PageShown(app->Page());
+  }
+
+  auto stale = stale_preferences_.find(app);
+  if (stale != stale_preferences_.end()) {
+    int preferences = stale->second;
+    stale_preferences_.erase(stale);
+    ApplyPreferences(app, preferences);
   }
-  return height;
 }
 
 bool WebAppManager::GetSystemLanguage(std::string& value) {
@@ -147,6 +247,16 @@ bool WebAppManager::GetSystemLanguage(std::string& value) {
   return device_info_->GetSystemLanguage(value);
 }
 
+std::string WebAppManager::GetErrorPagePath() {
+  if (error_page_index_->ErrorPage().empty()) {
+    return std::string();
+  }
+
+  std::string language;
+  GetSystemLanguage(language);
+  return error_page_index_->Resolve(language);
+}
+
 bool WebAppManager::GetDeviceInfo(const std::string& name, std::string& value) {
   if (!device_info_) {
     return false;
@@ -228,6 +338,16 @@ void WebAppManager::OnShutdownEvent() {
 bool WebAppManager::OnKillApp(const std::string& app_id,
                               const std::string& instance_id,
                               bool force) {
+  if (launch_scheduler_->Cancel(instance_id)) {
+    LOG_INFO(MSGID_KILL_APP, 2, PMLOGKS("APP_ID", app_id.c_str()),
+             PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+             "Queued launch dropped");
+    DropLaunchTiming(instance_id);
+    FinishQueuedLaunch(instance_id, kErrCodeNoRunningApp,
+                       kErrClosedBeforeLaunch);
+    return true;
+  }
+
   WebAppBase* app = FindAppByInstanceId(instance_id);
   if (app == nullptr || (app->AppId() != app_id)) {
     LOG_INFO(MSGID_KILL_APP, 2, PMLOGKS("APP_ID", app_id.c_str()),
@@ -236,6 +356,16 @@ bool WebAppManager::OnKillApp(const std::string& app_id,
     return false;
   }
 
+  // Nothing was shown yet, so the load is dropped at once. A keep alive app
+  // is only hidden, as with any other kill which is not forced.
+  if ((force || !app->KeepAlive()) && launch_tracker_->Cancel(instance_id)) {
+    LOG_INFO(MSGID_KILL_APP, 2, PMLOGKS("APP_ID", app_id.c_str()),
+             PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+             "Load cancelled before first paint");
+    ForceCloseAppInternal(app);
+    return true;
+  }
+
   if (force) {
     ForceCloseAppInternal(app);
   } else {
@@ -300,10 +430,12 @@ WebAppBase* WebAppManager::OnLaunchUrl(
     err_msg = kErrUnsupportedType;
     return nullptr;
   }
+  MarkLaunchStage(instance_id, LaunchTiming::kWindowCreated);
 
   WebPageBase* page =
       factory->CreateWebPage(win_type.c_str(), wam::Url(url.c_str()), app_desc,
                              app_desc->SubType().c_str(), args.c_str());
+  MarkLaunchStage(instance_id, LaunchTiming::kPageCreated);
 
   // set use launching time optimization true while app loading.
   page->SetUseLaunchOptimization(true);
@@ -326,7 +458,9 @@ WebAppBase* WebAppManager::OnLaunchUrl(
   app->Attach(page);
   app->SetPreloadState(args);
 
+  MarkLaunchStage(instance_id, LaunchTiming::kLoadStarted);
   page->Load();
+  MarkLaunchStage(instance_id, LaunchTiming::kLoadIssued);
   WebPageAdded(page);
 
   app_list_.push_back(app);
@@ -418,6 +552,19 @@ void WebAppManager::CloseAppInternal(WebAppBase* app,
 }
 
 bool WebAppManager::CloseAllApps(uint32_t pid) {
+  if (!pid) {
+    launch_scheduler_->Clear();
+    launch_tracker_->Clear();
+    ReleaseRunningAppList();
+    while (!launch_timings_.empty()) {
+      DropLaunchTiming(launch_timings_.begin()->first);
+    }
+    while (!queued_launch_replies_.empty()) {
+      FinishQueuedLaunch(queued_launch_replies_.begin()->first,
+                         kErrCodeNoRunningApp, kErrClosedBeforeLaunch);
+    }
+  }
+
   AppList running_apps;
 
   for (WebAppBase* app : app_list_) {
@@ -452,6 +599,8 @@ void WebAppManager::WebPageAdded(WebPageBase* page) {
 }
 
 void WebAppManager::WebPageRemoved(WebPageBase* page) {
+  network_reload_scheduler_->PageRemoved(page);
+
   if (!deleting_pages_) {
     // Remove from list of pending delete pages
     PageList::iterator iter = std::find(pages_to_delete_list_.begin(),
@@ -509,6 +658,8 @@ void WebAppManager::AppDeleted(WebAppBase* app) {
   }
 
   app_list_.remove(app);
+  stale_preferences_.erase(app);
+  DropLaunchTiming(app->InstanceId());
 }
 
 void WebAppManager::SetSystemLanguage(const std::string& language) {
@@ -517,10 +668,8 @@ void WebAppManager::SetSystemLanguage(const std::string& language) {
   }
 
   device_info_->SetSystemLanguage(language);
-
-  for (WebAppBase* app : app_list_) {
-    app->SetPreferredLanguages(language);
-  }
+  error_page_index_->Invalidate();
+  BroadcastPreference(kStaleLanguage);
 
   LOG_DEBUG("New system language: %s", language.c_str());
 }
@@ -659,11 +808,14 @@ std::string WebAppManager::Launch(const std::string& app_desc_string,
   LOG_DEBUG("WAM compiled with gcc - Start app");
 #endif  // defined(__clang__)
 
+  LaunchTiming timing;
   std::shared_ptr<ApplicationDescription> desc(
       ApplicationDescription::FromJsonString(app_desc_string.c_str()));
   if (!desc) {
     return std::string();
   }
+  timing.Mark(LaunchTiming::kDescriptionParsed);
+  timing.SetAppId(desc->Id());
 
   std::string url = desc->EntryPoint();
   std::string win_type = WindowTypeFromString(desc->DefaultWindowType());
@@ -677,6 +829,7 @@ std::string WebAppManager::Launch(const std::string& app_desc_string,
                 params.c_str());
     return std::string();
   }
+  timing.Mark(LaunchTiming::kParamsParsed);
 
   Json::Value affinity = json["displayAffinity"];
   if (affinity.isInt()) {
@@ -699,17 +852,330 @@ std::string WebAppManager::Launch(const std::string& app_desc_string,
   if (IsRunningApp(instance_id)) {
     OnRelaunchApp(instance_id, desc->Id().c_str(), params.c_str(),
                   launching_app_id.c_str());
-  } else {
-    // Run as a normal app
-    if (!OnLaunchUrl(url, win_type, std::move(desc), instance_id, params,
-                     launching_app_id, err_code, err_msg)) {
-      return std::string();
-    }
+    return instance_id;
+  }
+
+  // A second launch of an app still loading on the same display relaunches
+  // the loading instance instead of starting another load, unless another
+  // instance was asked for
+  std::string in_flight_id = launch_tracker_->InFlightInstance(
+      desc->Id(), desc->GetDisplayAffinity(), instance_id);
+  if (!in_flight_id.empty()) {
+    LOG_INFO(MSGID_APP_LAUNCH, 2, PMLOGKS("APP_ID", desc->Id().c_str()),
+             PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+             "Coalesced into the launch of %s", in_flight_id.c_str());
+    launch_tracker_->Coalesced(desc->Id());
+    OnRelaunchApp(in_flight_id, desc->Id(), params, launching_app_id);
+    return in_flight_id;
+  }
+
+  LaunchScheduler::Priority priority = LaunchPriority(json);
+  if (launch_scheduler_->IsQueued(instance_id) &&
+      priority == LaunchScheduler::kForeground) {
+    priority = LaunchScheduler::kRelaunch;
+  }
+
+  launch_timings_.emplace(instance_id, timing);
+  if (!launch_scheduler_->Admit(instance_id, priority)) {
+    // Callers waiting with ReplyWhenLaunched() learn how the launch went
+    LOG_INFO(MSGID_APP_LAUNCH, 2, PMLOGKS("APP_ID", desc->Id().c_str()),
+             PMLOGKS("INSTANCE_ID", instance_id.c_str()), "Launch queued (%s)",
+             LaunchScheduler::PriorityName(priority));
+    launch_scheduler_->Enqueue(
+        instance_id, priority,
+        [this, url, win_type, desc, instance_id, params, launching_app_id]() {
+          int err_code = 0;
+          std::string err_msg;
+          MarkLaunchStage(instance_id, LaunchTiming::kAdmitted);
+          if (!OnLaunchUrl(url, win_type, desc, instance_id, params,
+                           launching_app_id, err_code, err_msg)) {
+            LOG_WARNING(MSGID_APP_LAUNCH, 2,
+                        PMLOGKS("APP_ID", desc->Id().c_str()),
+                        PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+                        "Queued launch failed: %s", err_msg.c_str());
+            DropLaunchTiming(instance_id);
+            FinishQueuedLaunch(instance_id, err_code, err_msg);
+            return false;
+          }
+          launch_tracker_->Started(desc->Id(), instance_id,
+                                   desc->GetDisplayAffinity());
+          FinishQueuedLaunch(instance_id, 0, std::string());
+          return true;
+        },
+        priority == LaunchScheduler::kPreload ? PreloadRank(json) : 0);
+    return instance_id;
+  }
+
+  // Run as a normal app
+  MarkLaunchStage(instance_id, LaunchTiming::kAdmitted);
+  if (!OnLaunchUrl(url, win_type, desc, instance_id, params, launching_app_id,
+                   err_code, err_msg)) {
+    launch_timings_.erase(instance_id);
+    FinishQueuedLaunch(instance_id, err_code, err_msg);
+    return std::string();
   }
+  launch_scheduler_->Started(instance_id, priority);
+  launch_tracker_->Started(desc->Id(), instance_id, desc->GetDisplayAffinity());
+  // Took the place of a queued launch of the same instance
+  FinishQueuedLaunch(instance_id, 0, std::string());
 
   return instance_id;
 }
 
+void WebAppManager::BeginLaunchBatch() {
+  running_app_list_held_ = true;
+}
+
+void WebAppManager::EndLaunchBatch(
+    const std::vector<std::string>& instance_ids) {
+  for (const std::string& instance_id : instance_ids) {
+    WebAppBase* app = FindAppByInstanceId(instance_id);
+    if (app && app->Page() && !app->Page()->GetWebProcessPID()) {
+      batch_awaiting_process_.insert(instance_id);
+    }
+  }
+
+  if (batch_awaiting_process_.empty()) {
+    ReleaseRunningAppList();
+    return;
+  }
+  if (!launch_batch_timer_.IsRunning()) {
+    launch_batch_timer_.StartWithReceiver(
+        kLaunchBatchHoldTimeoutMs, this, &WebAppManager::ReleaseRunningAppList);
+  }
+}
+
+void WebAppManager::ReleaseRunningAppList() {
+  if (launch_batch_timer_.IsRunning()) {
+    launch_batch_timer_.Stop();
+  }
+  batch_awaiting_process_.clear();
+  running_app_list_held_ = false;
+
+  if (running_app_list_stale_) {
+    running_app_list_stale_ = false;
+    PostRunningAppList();
+  }
+}
+
+bool WebAppManager::IsAwaitingFirstFrame(
+    const std::string& instance_id) const {
+  auto timing = launch_timings_.find(instance_id);
+  return timing != launch_timings_.end() &&
+         !timing->second.Reached(LaunchTiming::kFirstFrame);
+}
+
+bool WebAppManager::ReplyOnFirstFrame(const std::string& instance_id,
+                                      LaunchReplyCallback send) {
+  if (!IsAwaitingFirstFrame(instance_id)) {
+    return false;
+  }
+
+  // A relaunch before the first frame takes over the reply, the earlier
+  // caller still gets one
+  if (pending_launch_replies_.count(instance_id)) {
+    Json::Value result;
+    result["firstFrame"] = false;
+    SendLaunchReply(instance_id, result);
+  }
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(kFirstFrameReplyTimeoutMs);
+  pending_launch_replies_[instance_id] =
+      PendingLaunchReply{std::move(send), deadline};
+  if (!launch_reply_timer_.IsRunning()) {
+    launch_reply_timer_.StartWithReceiver(kFirstFrameReplyTimeoutMs, this,
+                                          &WebAppManager::ExpireLaunchReplies);
+  }
+  return true;
+}
+
+bool WebAppManager::IsLaunchQueued(const std::string& instance_id) const {
+  return launch_scheduler_->IsQueued(instance_id);
+}
+
+bool WebAppManager::ReplyWhenLaunched(const std::string& instance_id,
+                                      LaunchReplyCallback send) {
+  if (!IsLaunchQueued(instance_id)) {
+    return false;
+  }
+  // Requeueing the same instance keeps a single launch, every caller gets
+  // its outcome
+  queued_launch_replies_[instance_id].push_back(std::move(send));
+  return true;
+}
+
+void WebAppManager::MarkLaunchStage(const std::string& instance_id,
+                                    LaunchTiming::Stage stage) {
+  // Called for every swapped frame, keep the common case cheap
+  if (launch_timings_.empty()) {
+    return;
+  }
+  auto timing = launch_timings_.find(instance_id);
+  if (timing == launch_timings_.end()) {
+    return;
+  }
+
+  timing->second.Mark(stage);
+  if (stage != LaunchTiming::kFirstFrame) {
+    return;
+  }
+
+  LOG_INFO(MSGID_APP_LAUNCH, 2, PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+           PMLOGKFV("FIRST_FRAME_MS", "%lld",
+                    static_cast<long long>(
+                        timing->second.ElapsedMs(LaunchTiming::kFirstFrame))),
+           "First frame of launch");
+  if (pending_launch_replies_.count(instance_id)) {
+    Json::Value result;
+    result["firstFrame"] = true;
+    SendLaunchReply(instance_id, result);
+  }
+  launch_timelines_->Record(instance_id, timing->second,
+                            LaunchTimelineRecorder::kShown);
+  launch_timings_.erase(timing);
+}
+
+void WebAppManager::DropLaunchTiming(const std::string& instance_id) {
+  if (pending_launch_replies_.count(instance_id)) {
+    Json::Value result;
+    result["returnValue"] = false;
+    result["errorCode"] = kErrCodeNoRunningApp;
+    result["errorText"] = kErrClosedBeforeFirstFrame;
+    SendLaunchReply(instance_id, result);
+  }
+
+  auto timing = launch_timings_.find(instance_id);
+  if (timing != launch_timings_.end()) {
+    launch_timelines_->Record(instance_id, timing->second,
+                              LaunchTimelineRecorder::kClosed);
+    launch_timings_.erase(timing);
+  }
+}
+
+void WebAppManager::SendLaunchReply(const std::string& instance_id,
+                                    Json::Value result) {
+  auto pending = pending_launch_replies_.find(instance_id);
+  if (pending == pending_launch_replies_.end()) {
+    return;
+  }
+  LaunchReplyCallback send = std::move(pending->second.send);
+  pending_launch_replies_.erase(pending);
+
+  auto timing = launch_timings_.find(instance_id);
+  if (timing != launch_timings_.end()) {
+    result["timings"] = timing->second.ToJson();
+  }
+  send(result);
+}
+
+void WebAppManager::FinishQueuedLaunch(const std::string& instance_id,
+                                       int err_code,
+                                       const std::string& err_msg) {
+  auto pending = queued_launch_replies_.find(instance_id);
+  if (pending == queued_launch_replies_.end()) {
+    return;
+  }
+  std::vector<LaunchReplyCallback> sends = std::move(pending->second);
+  queued_launch_replies_.erase(pending);
+
+  Json::Value result;
+  result["returnValue"] = err_code == 0;
+  if (err_code != 0) {
+    result["errorCode"] = err_code;
+    result["errorText"] = err_msg;
+  }
+  for (LaunchReplyCallback& send : sends) {
+    send(result);
+  }
+}
+
+void WebAppManager::ExpireLaunchReplies() {
+  auto now = std::chrono::steady_clock::now();
+  auto next_deadline = std::chrono::steady_clock::time_point::max();
+  std::vector<std::string> expired;
+  for (const auto& pending : pending_launch_replies_) {
+    if (pending.second.deadline <= now) {
+      expired.push_back(pending.first);
+    } else {
+      next_deadline = std::min(next_deadline, pending.second.deadline);
+    }
+  }
+
+  for (const std::string& instance_id : expired) {
+    LOG_INFO(MSGID_APP_LAUNCH, 1, PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+             "No first frame in %d ms, reply anyway",
+             kFirstFrameReplyTimeoutMs);
+    Json::Value result;
+    result["firstFrame"] = false;
+    result["timedOut"] = true;
+    SendLaunchReply(instance_id, result);
+  }
+
+  if (!pending_launch_replies_.empty()) {
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        next_deadline - now);
+    launch_reply_timer_.StartWithReceiver(
+        static_cast<int>(delay.count()) + 1, this,
+        &WebAppManager::ExpireLaunchReplies);
+  }
+}
+
+bool WebAppManager::IsLaunchLoading(const std::string& instance_id) {
+  WebAppBase* app = FindAppByInstanceId(instance_id);
+  if (!app || !app->Page()) {
+    return false;
+  }
+  WebPageBase* page = app->Page();
+  return !page->IsClosing() && page->Progress() < kLoadCompleteProgress;
+}
+
+bool WebAppManager::IsLaunchInFlight(const std::string& instance_id) {
+  WebAppBase* app = FindAppByInstanceId(instance_id);
+  return app && app->Page() && !app->Page()->HasBeenShown() &&
+         IsLaunchLoading(instance_id);
+}
+
+int WebAppManager::PreloadRank(const Json::Value& params) const {
+  // Same mapping as WebAppBase::SetPreloadState()
+  std::string type = params["preload"].asString();
+  if (type.empty() && params["launchedHidden"].asBool()) {
+    type = "partial";
+  }
+  auto found = std::find(preload_order_.begin(), preload_order_.end(), type);
+  return static_cast<int>(found - preload_order_.begin());
+}
+
+Json::Value WebAppManager::GetLaunchTimelines(bool reset) {
+  Json::Value timelines = launch_timelines_->ToJson();
+  if (reset) {
+    launch_timelines_->Clear();
+  }
+  return timelines;
+}
+
+Json::Value WebAppManager::GetMainLoopLag(bool reset) {
+  Json::Value lag = main_loop_watchdog_->ToJson();
+  if (reset) {
+    main_loop_watchdog_->Reset();
+  }
+  return lag;
+}
+
+void WebAppManager::SetBootDone(bool boot_done) {
+  launch_scheduler_->SetBootDone(boot_done);
+}
+
+Json::Value WebAppManager::GetLaunchStats(bool reset) {
+  Json::Value stats = launch_scheduler_->ToJson();
+  stats["coalescing"] = launch_tracker_->ToJson();
+  if (reset) {
+    launch_scheduler_->ResetStats();
+    launch_tracker_->ResetStats();
+  }
+  return stats;
+}
+
 bool WebAppManager::IsRunningApp(const std::string& id) {
   std::list<const WebAppBase*> running = RunningApps();
 
@@ -735,8 +1201,8 @@ std::vector<ApplicationInfo> WebAppManager::List(bool include_system_apps) {
   return list;
 }
 
-Json::Value WebAppManager::GetWebProcessProfiling() {
-  return web_process_manager_->GetWebProcessProfiling();
+void WebAppManager::GetWebProcessProfiling(JsonWriter* reply) {
+  web_process_manager_->GetWebProcessProfiling(reply);
 }
 
 void WebAppManager::CloseApp(const std::string& app_id) {
@@ -749,6 +1215,10 @@ void WebAppManager::PostRunningAppList() {
   if (!service_sender_) {
     return;
   }
+  if (running_app_list_held_) {
+    running_app_list_stale_ = true;
+    return;
+  }
 
   std::vector<ApplicationInfo> apps = List(true);
   service_sender_->PostlistRunningApps(apps);
@@ -762,6 +1232,10 @@ void WebAppManager::PostWebProcessCreated(const std::string& app_id,
   }
 
   PostRunningAppList();
+  if (batch_awaiting_process_.erase(instance_id) &&
+      batch_awaiting_process_.empty()) {
+    ReleaseRunningAppList();
+  }
 
   if (!web_app_manager_config_->IsPostWebProcessCreatedDisabled()) {
     service_sender_->PostWebProcessCreated(app_id, instance_id, pid);
@@ -793,15 +1267,42 @@ void WebAppManager::SetAccessibilityEnabled(bool enabled) {
     return;
   }
 
+  is_accessibility_enabled_ = enabled;
+  BroadcastPreference(kStaleAccessibility);
+}
+
+void WebAppManager::BroadcastPreference(StalePreference preference) {
   for (WebAppBase* app : app_list_) {
-    // set audion guidance on/off on settings app
-    if (app->Page()) {
-      app->Page()->SetAudioGuidanceOn(enabled);
+    if (app->IsActivated()) {
+      ApplyPreferences(app, preference);
     }
-    app->SetUseAccessibility(enabled);
   }
 
-  is_accessibility_enabled_ = enabled;
+  for (WebAppBase* app : app_list_) {
+    if (!app->IsActivated()) {
+      stale_preferences_[app] |= preference;
+    }
+  }
+}
+
+void WebAppManager::ApplyPreferences(WebAppBase* app, int preferences) {
+  WebPageBase* page = app->Page();
+  if (!page) {
+    return;
+  }
+
+  page->BeginPreferenceUpdate();
+  if (preferences & kStaleLanguage) {
+    std::string language;
+    GetSystemLanguage(language);
+    app->SetPreferredLanguages(language);
+  }
+  if (preferences & kStaleAccessibility) {
+    // set audio guidance on/off on settings app
+    page->SetAudioGuidanceOn(is_accessibility_enabled_);
+    app->SetUseAccessibility(is_accessibility_enabled_);
+  }
+  page->EndPreferenceUpdate();
 }
 
 void WebAppManager::SendEventToAllAppsAndAllFrames(
@@ -828,21 +1329,46 @@ void WebAppManager::ServiceCall(const std::string& url,
 void WebAppManager::UpdateNetworkStatus(const Json::Value& object) {
   NetworkStatus status;
   status.FromJsonObject(object);
+  bool connected = status.IsInternetConnectionAvailable();
 
-  webos::Runtime::GetInstance()->SetNetworkConnected(
-      status.IsInternetConnectionAvailable());
-  network_status_manager_->UpdateNetworkStatus(status);
-
-  if (status.IsInternetConnectionAvailable()) {
-    for (auto& page : app_page_map_) {
-      if (page.second->IsLoadErrorPageFinish()) {
-        LOG_INFO(MSGID_WAM_DEBUG, 2,
-                 PMLOGKS("APP_ID", page.second->AppId().c_str()),
-                 PMLOGKS("INSTANCE_ID", page.second->InstanceId().c_str()),
-                 "Reload failed URL '%s' on restore connection",
-                 page.second->FailedUrl().c_str());
-        page.second->LoadUrl(page.second->FailedUrl());
-      }
+  webos::Runtime::GetInstance()->SetNetworkConnected(connected);
+  // Only logs the fields which changed, once per burst of events
+  network_status_manager_->UpdateNetworkStatus(std::move(status));
+
+  // Every connected event retries the failed pages, whether or not anything
+  // changed since the previous one
+  if (!connected) {
+    network_reload_scheduler_->Clear();
+    return;
+  }
+  ScheduleFailedPageReloads();
+}
+
+void WebAppManager::ScheduleFailedPageReloads() {
+  // Foreground app first, then other visible apps, then background ones.
+  // Frozen background pages keep their error page until they are shown.
+  for (auto& it : app_page_map_) {
+    WebPageBase* page = it.second;
+    if (!page->IsLoadErrorPageFinish()) {
+      continue;
+    }
+
+    WebAppBase* app = FindAppByInstanceId(page->InstanceId());
+    if (page->InstanceId() == active_instance_id_) {
+      network_reload_scheduler_->Schedule(page,
+                                          NetworkReloadScheduler::kForeground);
+    } else if (app && app->IsActivated()) {
+      network_reload_scheduler_->Schedule(page,
+                                          NetworkReloadScheduler::kVisible);
+    } else if (page->IsSuspended()) {
+      LOG_INFO(MSGID_WAM_DEBUG, 2, PMLOGKS("APP_ID", page->AppId().c_str()),
+               PMLOGKS("INSTANCE_ID", page->InstanceId().c_str()),
+               "Defer reload of failed URL '%s' until shown",
+               page->FailedUrl().c_str());
+      network_reload_scheduler_->Defer(page);
+    } else {
+      network_reload_scheduler_->Schedule(page,
+                                          NetworkReloadScheduler::kBackground);
     }
   }
 }
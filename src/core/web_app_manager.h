@@ -17,17 +17,31 @@
 #ifndef CORE_WEB_APP_MANAGER_H_
 #define CORE_WEB_APP_MANAGER_H_
 
+#include <chrono>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "webos/webview_base.h"
 
+#include "launch_timing.h"
+#include "timer.h"
+
 class ApplicationDescription;
 class DeviceInfo;
+class ErrorPageIndex;
+class JsonWriter;
+class LaunchScheduler;
+class LaunchTimelineRecorder;
+class LaunchTracker;
+class MainLoopWatchdog;
+struct DeviceSnapshot;
+class NetworkReloadScheduler;
 class NetworkStatusManager;
 class PlatformModuleFactory;
 class ServiceSender;
@@ -61,7 +75,11 @@ class WebAppManager {
   static WebAppManager* Instance();
 
   bool GetSystemLanguage(std::string& value);
+  // Local path of the error page localized for the system language, empty
+  // if there is no error page
+  std::string GetErrorPagePath();
   bool GetDeviceInfo(const std::string& name, std::string& value);
+  std::shared_ptr<const DeviceSnapshot> GetDeviceSnapshot();
   void BroadcastWebAppMessage(WebAppMessageType type,
                               const std::string& message);
 
@@ -87,15 +105,48 @@ class WebAppManager {
                      const std::string& launching_app_id,
                      int& err_code,
                      std::string& err_msg);
+  // Running app list updates are held from BeginLaunchBatch() until every
+  // instance the batch launched has its web process, or for at most
+  // kLaunchBatchHoldTimeoutMs, so that subscribers get a single update.
+  void BeginLaunchBatch();
+  void EndLaunchBatch(const std::vector<std::string>& instance_ids);
+
+  // Receives the fields to add to a held launch reply: "firstFrame",
+  // "timedOut" and "timings", or the error if the app went away first
+  using LaunchReplyCallback = std::function<void(const Json::Value& result)>;
+  // Calls |send| once the first frame of |instance_id| is swapped, or after
+  // kFirstFrameReplyTimeoutMs at the latest. Returns false, without calling
+  // |send|, if the launch has no first frame to wait for.
+  bool ReplyOnFirstFrame(const std::string& instance_id,
+                         LaunchReplyCallback send);
+  // Whether the launch of |instance_id| is queued by admission control
+  bool IsLaunchQueued(const std::string& instance_id) const;
+  // Calls |send| once the queued launch of |instance_id| has started, with
+  // {"returnValue": true}, or with the error if it failed or was dropped.
+  // Returns false, without calling |send|, if no launch of it is queued.
+  bool ReplyWhenLaunched(const std::string& instance_id,
+                         LaunchReplyCallback send);
+  void MarkLaunchStage(const std::string& instance_id,
+                       LaunchTiming::Stage stage);
 
   std::vector<ApplicationInfo> List(bool include_system_apps = false);
 
-  Json::Value GetWebProcessProfiling();
+  void GetWebProcessProfiling(JsonWriter* reply);
+  // Queue state and per class wait times of launch admission control, and
+  // the launches coalesced or cancelled while in flight
+  Json::Value GetLaunchStats(bool reset = false);
+  // Stage timelines of the last WAM_LAUNCH_TIMELINE_COUNT launches
+  Json::Value GetLaunchTimelines(bool reset = false);
+  // Main loop lag and the callbacks slower than
+  // WAM_MAIN_LOOP_LAG_THRESHOLD_IN_MS
+  Json::Value GetMainLoopLag(bool reset = false);
+  // Releases deferred preloads, see WAM_DEFER_PRELOADS
+  void SetBootDone(bool boot_done);
   int CurrentUiWidth();
   int CurrentUiHeight();
   void SetUiSize(int width, int height);
 
-  void SetActiveInstanceId(const std::string& id) { active_instance_id_ = id; }
+  void SetActiveInstanceId(const std::string& id);
   const std::string GetActiveInstanceId() const { return active_instance_id_; }
 
   void OnGlobalProperties(int key);
@@ -109,6 +160,8 @@ class WebAppManager {
   void SetSystemLanguage(const std::string& value);
   void SetDeviceInfo(const std::string& name, const std::string& value);
   WebAppManagerConfig* Config() { return web_app_manager_config_.get(); }
+  // Applies the system override file again, see WebAppManagerConfig
+  bool ReloadConfiguration();
 
   const std::string WindowTypeFromString(const std::string& str);
 
@@ -131,6 +184,7 @@ class WebAppManager {
 
   void AppDeleted(WebAppBase* app);
   void PostRunningAppList();
+  void ReleaseRunningAppList();
   std::string GenerateInstanceId();
   void RemoveClosingAppList(const std::string& instance_id);
 
@@ -163,6 +217,16 @@ class WebAppManager {
  private:
   WebAppFactoryManager* GetWebAppFactory();
   void LoadEnvironmentVariable();
+  void ScheduleFailedPageReloads();
+
+  // Preferences broadcast to every app apply to foreground apps right away
+  // and to background apps when they are shown next
+  enum StalePreference {
+    kStaleLanguage = 1 << 0,
+    kStaleAccessibility = 1 << 1,
+  };
+  void BroadcastPreference(StalePreference preference);
+  void ApplyPreferences(WebAppBase* app, int preferences);
 
   WebAppBase* OnLaunchUrl(const std::string& url,
                           const std::string& win_type,
@@ -176,6 +240,25 @@ class WebAppManager {
                      const std::string& app_id,
                      const std::string& args,
                      const std::string& launching_app_id);
+  bool IsLaunchLoading(const std::string& instance_id);
+  bool IsLaunchInFlight(const std::string& instance_id);
+  // Position of the preload type of |params| in WAM_PRELOAD_ORDER
+  int PreloadRank(const Json::Value& params) const;
+
+  bool IsAwaitingFirstFrame(const std::string& instance_id) const;
+  struct PendingLaunchReply {
+    LaunchReplyCallback send;
+    std::chrono::steady_clock::time_point deadline;
+  };
+  // Fails the reply still waiting for the first frame of |instance_id|
+  void DropLaunchTiming(const std::string& instance_id);
+  void SendLaunchReply(const std::string& instance_id, Json::Value result);
+  void ExpireLaunchReplies();
+  // Answers every ReplyWhenLaunched() of |instance_id|, a zero |err_code|
+  // meaning the launch started
+  void FinishQueuedLaunch(const std::string& instance_id,
+                          int err_code,
+                          const std::string& err_msg);
 
   WebAppManager();
 
@@ -199,12 +282,31 @@ class WebAppManager {
   std::unique_ptr<DeviceInfo> device_info_;
   std::unique_ptr<WebAppManagerConfig> web_app_manager_config_;
   std::unique_ptr<NetworkStatusManager> network_status_manager_;
+  std::unique_ptr<NetworkReloadScheduler> network_reload_scheduler_;
+  std::unique_ptr<LaunchScheduler> launch_scheduler_;
+  std::unique_ptr<LaunchTracker> launch_tracker_;
+  std::unique_ptr<LaunchTimelineRecorder> launch_timelines_;
+  std::unique_ptr<ErrorPageIndex> error_page_index_;
+  std::unique_ptr<MainLoopWatchdog> main_loop_watchdog_;
   std::unique_ptr<WebAppFactoryManager> web_app_factory_;
 
   std::unordered_map<std::string, int> last_crashed_app_ids_;
+  std::unordered_map<WebAppBase*, int> stale_preferences_;
 
   int suspend_delay_ = 0;
   int max_custom_suspend_delay_ = 0;
+  std::vector<std::string> preload_order_;
+
+  bool running_app_list_held_ = false;
+  bool running_app_list_stale_ = false;
+  std::unordered_set<std::string> batch_awaiting_process_;
+  OneShotTimer<WebAppManager> launch_batch_timer_;
+
+  std::unordered_map<std::string, LaunchTiming> launch_timings_;
+  std::unordered_map<std::string, PendingLaunchReply> pending_launch_replies_;
+  OneShotTimer<WebAppManager> launch_reply_timer_;
+  std::unordered_map<std::string, std::vector<LaunchReplyCallback>>
+      queued_launch_replies_;
 
   std::map<std::string, std::string> app_version_;
 
@@ -18,9 +18,25 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+
+#include <json/value.h>
+
+#include "file_contents.h"
 #include "utils.h"
 
-WebAppManagerConfig::WebAppManagerConfig() {
+const char WebAppManagerConfig::kOverrideFilePath[] =
+    "/var/luna/preferences/wam_config.json";
+
+WebAppManagerConfig::WebAppManagerConfig()
+    : WebAppManagerConfig(kOverrideFilePath) {}
+
+WebAppManagerConfig::WebAppManagerConfig(const std::string& override_path) {
+  // Overrides outlive restarts; without a readable file the environment
+  // alone is used
+  if (!override_path.empty() && ReadOverrides(override_path, &overrides_)) {
+    override_path_ = override_path;
+  }
   InitConfiguration();
 }
 
@@ -28,60 +44,136 @@ std::string WebAppManagerConfig::WamGetEnv(const char* name) {
   return util::GetEnvVar(name);
 }
 
+std::string WebAppManagerConfig::GetValue(const char* name) {
+  auto value = overrides_.find(name);
+  if (value != overrides_.end()) {
+    return value->second;
+  }
+  return WamGetEnv(name);
+}
+
 void WebAppManagerConfig::InitConfiguration() {
-  web_app_factory_plugin_types_ = WamGetEnv("WEBAPPFACTORY");
+  web_app_factory_plugin_types_ = GetValue("WEBAPPFACTORY");
 
-  web_app_factory_plugin_path_ = WamGetEnv("WEBAPPFACTORY_PLUGIN_PATH");
+  web_app_factory_plugin_path_ = GetValue("WEBAPPFACTORY_PLUGIN_PATH");
   if (web_app_factory_plugin_path_.empty()) {
     web_app_factory_plugin_path_ = "/usr/lib/webappmanager/plugins";
   }
 
-  std::string suspend_delay = WamGetEnv("WAM_SUSPEND_DELAY_IN_MS");
+  std::string suspend_delay = GetValue("WAM_SUSPEND_DELAY_IN_MS");
   int suspend_delay_int = util::StrToIntWithDefault(suspend_delay, 0);
   suspend_delay_time_ = std::max(suspend_delay_int, 1);
 
   std::string max_custom_suspend_delay =
-      WamGetEnv("MAX_CUSTOM_SUSPEND_DELAY_IN_MS");
+      GetValue("MAX_CUSTOM_SUSPEND_DELAY_IN_MS");
   int max_custom_suspend_delay_int =
       util::StrToIntWithDefault(max_custom_suspend_delay, 0);
   max_custom_suspend_delay_time_ = std::max(max_custom_suspend_delay_int, 0);
 
-  web_process_config_path_ = WamGetEnv("WEBPROCESS_CONFIGURATION_PATH");
+  web_process_config_path_ = GetValue("WEBPROCESS_CONFIGURATION_PATH");
   if (web_process_config_path_.empty()) {
     web_process_config_path_ = "/etc/wam/com.webos.wam.json";
   }
 
-  error_page_url_ = WamGetEnv("WAM_ERROR_PAGE");
+  error_page_url_ = GetValue("WAM_ERROR_PAGE");
 
   dynamic_pluggable_load_enabled_ =
-      WamGetEnv("LOAD_DYNAMIC_PLUGGABLE").compare("1") == 0;
+      GetValue("LOAD_DYNAMIC_PLUGGABLE").compare("1") == 0;
 
   post_web_process_created_disabled_ =
-      WamGetEnv("POST_WEBPROCESS_CREATED_DISABLED").compare("1") == 0;
+      GetValue("POST_WEBPROCESS_CREATED_DISABLED").compare("1") == 0;
 
-  check_launch_time_enabled_ = WamGetEnv("LAUNCH_TIME_CHECK").compare("1") == 0;
+  check_launch_time_enabled_ = GetValue("LAUNCH_TIME_CHECK").compare("1") == 0;
 
   use_system_app_optimization_ =
-      WamGetEnv("USE_SYSTEM_APP_OPTIMIZATION").compare("1") == 0;
+      GetValue("USE_SYSTEM_APP_OPTIMIZATION").compare("1") == 0;
 
   launch_optimization_enabled_ =
-      WamGetEnv("ENABLE_LAUNCH_OPTIMIZATION").compare("1") == 0;
+      GetValue("ENABLE_LAUNCH_OPTIMIZATION").compare("1") == 0;
+
+  std::string network_reload_max_concurrent =
+      GetValue("WAM_NETWORK_RELOAD_MAX_CONCURRENT");
+  network_reload_max_concurrent_ =
+      std::max(util::StrToIntWithDefault(network_reload_max_concurrent, 2), 1);
+
+  std::string network_reload_interval =
+      GetValue("WAM_NETWORK_RELOAD_INTERVAL_IN_MS");
+  network_reload_interval_ms_ =
+      std::max(util::StrToIntWithDefault(network_reload_interval, 300), 0);
+
+  std::string network_status_debounce_interval =
+      GetValue("WAM_NETWORK_STATUS_DEBOUNCE_IN_MS");
+  network_status_debounce_interval_ms_ = std::max(
+      util::StrToIntWithDefault(network_status_debounce_interval, 500), 0);
 
-  user_script_path_ = WamGetEnv("USER_SCRIPT_PATH");
+  max_concurrent_launches_ = std::max(
+      util::StrToIntWithDefault(GetValue("WAM_MAX_CONCURRENT_LAUNCHES"), 0),
+      0);
+
+  defer_preloads_enabled_ = GetValue("WAM_DEFER_PRELOADS").compare("1") == 0;
+
+  preload_idle_threshold_ = std::clamp(
+      util::StrToIntWithDefault(GetValue("WAM_PRELOAD_IDLE_THRESHOLD"), 50), 0,
+      100);
+
+  std::string preload_release_interval =
+      GetValue("WAM_PRELOAD_RELEASE_INTERVAL_IN_MS");
+  preload_release_interval_ms_ =
+      std::max(util::StrToIntWithDefault(preload_release_interval, 1000), 0);
+
+  preload_order_ = GetValue("WAM_PRELOAD_ORDER");
+  if (preload_order_.empty()) {
+    preload_order_ = "full,semi-full,partial,minimal";
+  }
+
+  launch_timeline_count_ = std::max(
+      util::StrToIntWithDefault(GetValue("WAM_LAUNCH_TIMELINE_COUNT"), 50), 0);
+
+  std::string main_loop_lag_threshold =
+      GetValue("WAM_MAIN_LOOP_LAG_THRESHOLD_IN_MS");
+  main_loop_lag_threshold_ms_ =
+      std::max(util::StrToIntWithDefault(main_loop_lag_threshold, 0), 0);
+
+  luna_dispatch_thread_enabled_ =
+      GetValue("WAM_LUNA_DISPATCH_THREAD").compare("1") == 0;
+
+  user_script_path_ = GetValue("USER_SCRIPT_PATH");
   if (user_script_path_.empty()) {
     user_script_path_ = "webOSUserScripts/userScript.js";
   }
 
-  name_ = WamGetEnv("WAM_NAME");
+  name_ = GetValue("WAM_NAME");
+
+  privileged_plugin_path_ = GetValue("PRIVILEGED_PLUGIN_PATH");
+
+  default_allow_third_party_cookies_ =
+      GetValue("WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES").compare("0") != 0;
+
+  keep_rtc_connections_on_suspend_ =
+      GetValue("WAM_KEEP_RTC_CONNECTIONS_ON_SUSPEND").compare("1") == 0;
+
+  launch_finish_assure_timeout_ms_ = util::StrToIntWithDefault(
+      GetValue("LAUNCH_FINISH_ASSURE_TIMEOUT"), 0);
+  if (launch_finish_assure_timeout_ms_ <= 0) {
+    launch_finish_assure_timeout_ms_ = 5000;
+  }
+
+  cursor_enabled_by_default_ =
+      GetValue("ENABLE_CURSOR_BY_DEFAULT").compare("1") == 0;
+}
+
+bool WebAppManagerConfig::PreferenceExists(const char* path) {
+  return access(path, F_OK) == 0;
 }
 
 void WebAppManagerConfig::PostInitConfiguration() {
-  if (access("/var/luna/preferences/debug_system_apps", F_OK) == 0) {
+  if (PreferenceExists("/var/luna/preferences/debug_system_apps")) {
     inspector_enabled_ = true;
   }
 
-  if (access("/var/luna/preferences/devmode_enabled", F_OK) == 0) {
+  if (PreferenceExists("/var/luna/preferences/devmode_enabled")) {
     dev_mode_enabled_ = true;
+    // Devmode only, so not taken from the override file
     tellurium_nub_path_ = WamGetEnv("TELLURIUM_NUB_PATH");
   }
 }
@@ -97,6 +189,20 @@ void WebAppManagerConfig::ResetConfiguration() {
   check_launch_time_enabled_ = false;
   use_system_app_optimization_ = false;
   launch_optimization_enabled_ = false;
+  network_reload_max_concurrent_ = 0;
+  network_reload_interval_ms_ = 0;
+  network_status_debounce_interval_ms_ = 0;
+  max_concurrent_launches_ = 0;
+  defer_preloads_enabled_ = false;
+  preload_idle_threshold_ = 0;
+  preload_release_interval_ms_ = 0;
+  launch_timeline_count_ = 0;
+  main_loop_lag_threshold_ms_ = 0;
+  luna_dispatch_thread_enabled_ = false;
+  default_allow_third_party_cookies_ = true;
+  keep_rtc_connections_on_suspend_ = false;
+  launch_finish_assure_timeout_ms_ = 0;
+  cursor_enabled_by_default_ = false;
 
   web_app_factory_plugin_types_.clear();
   web_app_factory_plugin_path_.clear();
@@ -105,6 +211,104 @@ void WebAppManagerConfig::ResetConfiguration() {
   tellurium_nub_path_.clear();
   user_script_path_.clear();
   name_.clear();
+  privileged_plugin_path_.clear();
+  preload_order_.clear();
 
   InitConfiguration();
 }
+
+Json::Value WebAppManagerConfig::ToJson() const {
+  Json::Value config(Json::objectValue);
+  config["WEBAPPFACTORY"] = web_app_factory_plugin_types_;
+  config["WEBAPPFACTORY_PLUGIN_PATH"] = web_app_factory_plugin_path_;
+  config["WAM_SUSPEND_DELAY_IN_MS"] = suspend_delay_time_;
+  config["MAX_CUSTOM_SUSPEND_DELAY_IN_MS"] = max_custom_suspend_delay_time_;
+  config["WEBPROCESS_CONFIGURATION_PATH"] = web_process_config_path_;
+  config["WAM_ERROR_PAGE"] = error_page_url_;
+  config["LOAD_DYNAMIC_PLUGGABLE"] = dynamic_pluggable_load_enabled_;
+  config["POST_WEBPROCESS_CREATED_DISABLED"] =
+      post_web_process_created_disabled_;
+  config["LAUNCH_TIME_CHECK"] = check_launch_time_enabled_;
+  config["USE_SYSTEM_APP_OPTIMIZATION"] = use_system_app_optimization_;
+  config["ENABLE_LAUNCH_OPTIMIZATION"] = launch_optimization_enabled_;
+  config["USER_SCRIPT_PATH"] = user_script_path_;
+  config["WAM_NAME"] = name_;
+  config["WAM_NETWORK_RELOAD_MAX_CONCURRENT"] = network_reload_max_concurrent_;
+  config["WAM_NETWORK_RELOAD_INTERVAL_IN_MS"] = network_reload_interval_ms_;
+  config["WAM_NETWORK_STATUS_DEBOUNCE_IN_MS"] =
+      network_status_debounce_interval_ms_;
+  config["WAM_MAX_CONCURRENT_LAUNCHES"] = max_concurrent_launches_;
+  config["WAM_DEFER_PRELOADS"] = defer_preloads_enabled_;
+  config["WAM_PRELOAD_IDLE_THRESHOLD"] = preload_idle_threshold_;
+  config["WAM_PRELOAD_RELEASE_INTERVAL_IN_MS"] = preload_release_interval_ms_;
+  config["WAM_PRELOAD_ORDER"] = preload_order_;
+  config["WAM_LAUNCH_TIMELINE_COUNT"] = launch_timeline_count_;
+  config["WAM_MAIN_LOOP_LAG_THRESHOLD_IN_MS"] = main_loop_lag_threshold_ms_;
+  config["WAM_LUNA_DISPATCH_THREAD"] = luna_dispatch_thread_enabled_;
+  config["PRIVILEGED_PLUGIN_PATH"] = privileged_plugin_path_;
+  config["WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES"] =
+      default_allow_third_party_cookies_;
+  config["WAM_KEEP_RTC_CONNECTIONS_ON_SUSPEND"] =
+      keep_rtc_connections_on_suspend_;
+  config["LAUNCH_FINISH_ASSURE_TIMEOUT"] = launch_finish_assure_timeout_ms_;
+  config["ENABLE_CURSOR_BY_DEFAULT"] = cursor_enabled_by_default_;
+  config["TELLURIUM_NUB_PATH"] = tellurium_nub_path_;
+  config["inspectorEnabled"] = inspector_enabled_;
+  config["devModeEnabled"] = dev_mode_enabled_;
+  return config;
+}
+
+bool WebAppManagerConfig::ReadOverrides(
+    const std::string& path,
+    std::unordered_map<std::string, std::string>* overrides) {
+  auto contents = FileContents::Read(path);
+  Json::Value json;
+  if (!contents || !util::StringToJson(contents->View(), json) ||
+      !json.isObject()) {
+    return false;
+  }
+
+  // Values use the same textual form as the environment variables, so
+  // booleans become "1"/"0"
+  std::unordered_map<std::string, std::string> values;
+  for (const auto& name : json.getMemberNames()) {
+    const Json::Value& value = json[name];
+    if (value.isBool()) {
+      values.emplace(name, value.asBool() ? "1" : "0");
+    } else if (value.isString() || value.isNumeric()) {
+      values.emplace(name, value.asString());
+    } else {
+      return false;
+    }
+  }
+  *overrides = std::move(values);
+  return true;
+}
+
+bool WebAppManagerConfig::LoadFromFile(const std::string& path) {
+  std::unordered_map<std::string, std::string> overrides;
+  if (!path.empty() && !ReadOverrides(path, &overrides)) {
+    return false;
+  }
+
+  overrides_ = std::move(overrides);
+  override_path_ = path;
+
+  // Set at startup or from the devmode and debug preferences, not by the
+  // override file
+  bool dev_mode_enabled = dev_mode_enabled_;
+  bool inspector_enabled = inspector_enabled_;
+  std::string tellurium_nub_path = tellurium_nub_path_;
+  ResetConfiguration();
+  dev_mode_enabled_ = dev_mode_enabled;
+  inspector_enabled_ = inspector_enabled;
+  tellurium_nub_path_ = tellurium_nub_path;
+  return true;
+}
+
+bool WebAppManagerConfig::Reload() {
+  if (access(kOverrideFilePath, F_OK) != 0) {
+    return LoadFromFile(std::string());
+  }
+  return LoadFromFile(kOverrideFilePath);
+}
@@ -18,7 +18,52 @@
 #define CORE_WEB_APP_MANAGER_CONFIG_H_
 
 #include <string>
+#include <unordered_map>
 
+namespace Json {
+class Value;
+}
+
+// Runtime configuration of WAM, resolved once from the environment and the
+// optional JSON override file kOverrideFilePath (see Reload()) into typed
+// values.
+//
+// Schema (key : type, default):
+//   WEBAPPFACTORY                         : string, ""
+//   WEBAPPFACTORY_PLUGIN_PATH             : string,
+//                                           "/usr/lib/webappmanager/plugins"
+//   WAM_SUSPEND_DELAY_IN_MS               : int >= 1, 1
+//   MAX_CUSTOM_SUSPEND_DELAY_IN_MS        : int >= 0, 0
+//   WEBPROCESS_CONFIGURATION_PATH         : string,
+//                                           "/etc/wam/com.webos.wam.json"
+//   WAM_ERROR_PAGE                        : string, ""
+//   LOAD_DYNAMIC_PLUGGABLE                : bool ("1"), false
+//   POST_WEBPROCESS_CREATED_DISABLED      : bool ("1"), false
+//   LAUNCH_TIME_CHECK                     : bool ("1"), false
+//   USE_SYSTEM_APP_OPTIMIZATION           : bool ("1"), false
+//   ENABLE_LAUNCH_OPTIMIZATION            : bool ("1"), false
+//   USER_SCRIPT_PATH                      : string,
+//                                           "webOSUserScripts/userScript.js"
+//   WAM_NAME                              : string, ""
+//   WAM_NETWORK_RELOAD_MAX_CONCURRENT     : int >= 1, 2
+//   WAM_NETWORK_RELOAD_INTERVAL_IN_MS     : int >= 0, 300
+//   WAM_NETWORK_STATUS_DEBOUNCE_IN_MS     : int >= 0, 500
+//   WAM_MAX_CONCURRENT_LAUNCHES           : int >= 0, 0 (no limit)
+//   WAM_DEFER_PRELOADS                    : bool ("1"), false
+//   WAM_PRELOAD_IDLE_THRESHOLD            : int 0..100, 50 (% CPU idle)
+//   WAM_PRELOAD_RELEASE_INTERVAL_IN_MS    : int >= 0, 1000
+//   WAM_PRELOAD_ORDER                     : string,
+//                                           "full,semi-full,partial,minimal"
+//   WAM_LAUNCH_TIMELINE_COUNT             : int >= 0, 50 (0 disables)
+//   WAM_MAIN_LOOP_LAG_THRESHOLD_IN_MS     : int >= 0, 0 (disabled)
+//   WAM_LUNA_DISPATCH_THREAD              : bool ("1"), false (startup only)
+//   PRIVILEGED_PLUGIN_PATH                : string, ""
+//   WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES : bool (not "0"), true
+//   WAM_KEEP_RTC_CONNECTIONS_ON_SUSPEND   : bool ("1"), false
+//   LAUNCH_FINISH_ASSURE_TIMEOUT          : int > 0, 5000
+//   ENABLE_CURSOR_BY_DEFAULT              : bool ("1"), false
+//   TELLURIUM_NUB_PATH                    : string, "" (devmode only, not
+//                                           overridable)
 class WebAppManagerConfig {
  public:
   WebAppManagerConfig();
@@ -63,12 +108,84 @@ class WebAppManagerConfig {
     return launch_optimization_enabled_;
   }
 
+  virtual int GetNetworkReloadMaxConcurrent() const {
+    return network_reload_max_concurrent_;
+  }
+  virtual int GetNetworkReloadIntervalMs() const {
+    return network_reload_interval_ms_;
+  }
+  virtual int GetNetworkStatusDebounceIntervalMs() const {
+    return network_status_debounce_interval_ms_;
+  }
+  virtual int GetMaxConcurrentLaunches() const {
+    return max_concurrent_launches_;
+  }
+  virtual bool IsDeferPreloadsEnabled() const {
+    return defer_preloads_enabled_;
+  }
+  virtual int GetPreloadIdleThreshold() const {
+    return preload_idle_threshold_;
+  }
+  virtual int GetPreloadReleaseIntervalMs() const {
+    return preload_release_interval_ms_;
+  }
+  virtual std::string GetPreloadOrder() const { return preload_order_; }
+  virtual int GetLaunchTimelineCount() const { return launch_timeline_count_; }
+  virtual int GetMainLoopLagThresholdMs() const {
+    return main_loop_lag_threshold_ms_;
+  }
+  virtual bool IsLunaDispatchThreadEnabled() const {
+    return luna_dispatch_thread_enabled_;
+  }
+
+  virtual std::string GetPrivilegedPluginPath() const {
+    return privileged_plugin_path_;
+  }
+  virtual bool IsDefaultAllowThirdPartyCookies() const {
+    return default_allow_third_party_cookies_;
+  }
+  virtual bool IsKeepRtcConnectionsOnSuspend() const {
+    return keep_rtc_connections_on_suspend_;
+  }
+  virtual int GetLaunchFinishAssureTimeoutMs() const {
+    return launch_finish_assure_timeout_ms_;
+  }
+  virtual bool IsCursorEnabledByDefault() const {
+    return cursor_enabled_by_default_;
+  }
+
+  // Dumps the resolved configuration, keyed as in the schema above
+  Json::Value ToJson() const;
+  // Resolves the configuration again with the values of the JSON object in
+  // |path| taking precedence over the environment. An empty |path| drops
+  // previously loaded overrides. Returns false and keeps the current
+  // configuration if the file can't be read or isn't a flat JSON object.
+  // Inspector and devmode state is kept as it is.
+  bool LoadFromFile(const std::string& path);
+  // LoadFromFile() with the system override file, kOverrideFilePath, or
+  // without overrides when there is none. The path is fixed since the
+  // overrides choose where plugins and scripts are loaded from.
+  bool Reload();
+  std::string GetOverridePath() const { return override_path_; }
+
+  static const char kOverrideFilePath[];
+
  protected:
+  // Resolves with the overrides in |override_path| if it can be read, for
+  // tests. An empty path reads no overrides.
+  explicit WebAppManagerConfig(const std::string& override_path);
+
   virtual std::string WamGetEnv(const char* name);
+  virtual bool PreferenceExists(const char* path);
   void ResetConfiguration();
 
  private:
+  // Reads the flat JSON object in |path| into |overrides|
+  static bool ReadOverrides(
+      const std::string& path,
+      std::unordered_map<std::string, std::string>* overrides);
   void InitConfiguration();
+  std::string GetValue(const char* name);
 
   std::string web_app_factory_plugin_types_;
   std::string web_app_factory_plugin_path_;
@@ -84,8 +201,27 @@ class WebAppManagerConfig {
   bool check_launch_time_enabled_ = false;
   bool use_system_app_optimization_ = false;
   bool launch_optimization_enabled_ = false;
+  int network_reload_max_concurrent_ = 0;
+  int network_reload_interval_ms_ = 0;
+  int network_status_debounce_interval_ms_ = 0;
+  int max_concurrent_launches_ = 0;
+  bool defer_preloads_enabled_ = false;
+  int preload_idle_threshold_ = 0;
+  int preload_release_interval_ms_ = 0;
+  std::string preload_order_;
+  int launch_timeline_count_ = 0;
+  int main_loop_lag_threshold_ms_ = 0;
+  bool luna_dispatch_thread_enabled_ = false;
+  std::string privileged_plugin_path_;
+  bool default_allow_third_party_cookies_ = true;
+  bool keep_rtc_connections_on_suspend_ = false;
+  int launch_finish_assure_timeout_ms_ = 0;
+  bool cursor_enabled_by_default_ = false;
   std::string user_script_path_;
   std::string name_;
+
+  std::string override_path_;
+  std::unordered_map<std::string, std::string> overrides_;
 };
 
 #endif  // CORE_WEB_APP_MANAGER_CONFIG_H_
@@ -20,6 +20,7 @@
 
 #include "log_manager.h"
 #include "web_app_base.h"
+#include "web_app_manager_config.h"
 #include "web_app_manager_tracer.h"
 
 WebAppManagerService::WebAppManagerService() = default;
@@ -34,6 +35,33 @@ std::string WebAppManagerService::OnLaunch(const std::string& app_desc_string,
                                            launching_app_id, err_code, err_msg);
 }
 
+void WebAppManagerService::OnLaunchBatchBegin() {
+  WebAppManager::Instance()->BeginLaunchBatch();
+}
+
+void WebAppManagerService::OnLaunchBatchEnd(
+    const std::vector<std::string>& instance_ids) {
+  WebAppManager::Instance()->EndLaunchBatch(instance_ids);
+}
+
+bool WebAppManagerService::OnReplyOnFirstFrame(
+    const std::string& instance_id,
+    WebAppManager::LaunchReplyCallback send) {
+  return WebAppManager::Instance()->ReplyOnFirstFrame(instance_id,
+                                                      std::move(send));
+}
+
+bool WebAppManagerService::IsLaunchQueued(const std::string& instance_id) {
+  return WebAppManager::Instance()->IsLaunchQueued(instance_id);
+}
+
+bool WebAppManagerService::OnReplyWhenLaunched(
+    const std::string& instance_id,
+    WebAppManager::LaunchReplyCallback send) {
+  return WebAppManager::Instance()->ReplyWhenLaunched(instance_id,
+                                                      std::move(send));
+}
+
 bool WebAppManagerService::OnKillApp(const std::string& app_id,
                                      const std::string& instance_id,
                                      bool force) {
@@ -64,8 +92,35 @@ bool WebAppManagerService::OnCloseAllApps(uint32_t pid) {
   return WebAppManager::Instance()->CloseAllApps(pid);
 }
 
-Json::Value WebAppManagerService::GetWebProcessProfiling() {
-  return WebAppManager::Instance()->GetWebProcessProfiling();
+void WebAppManagerService::GetWebProcessProfiling(JsonWriter* reply) {
+  WebAppManager::Instance()->GetWebProcessProfiling(reply);
+}
+
+Json::Value WebAppManagerService::GetLaunchStats(bool reset) {
+  return WebAppManager::Instance()->GetLaunchStats(reset);
+}
+
+Json::Value WebAppManagerService::GetLaunchTimelines(bool reset) {
+  return WebAppManager::Instance()->GetLaunchTimelines(reset);
+}
+
+Json::Value WebAppManagerService::GetMainLoopLag(bool reset) {
+  return WebAppManager::Instance()->GetMainLoopLag(reset);
+}
+
+Json::Value WebAppManagerService::GetConfiguration() {
+  WebAppManagerConfig* config = WebAppManager::Instance()->Config();
+  return config ? config->ToJson() : Json::Value(Json::objectValue);
+}
+
+std::string WebAppManagerService::GetConfigurationOverridePath() {
+  WebAppManagerConfig* config = WebAppManager::Instance()->Config();
+  return config ? config->GetOverridePath() : std::string();
+}
+
+bool WebAppManagerService::OnReloadConfiguration() {
+  LOG_INFO(MSGID_LUNA_API, 1, PMLOGKS("API", "reloadConfig"), "");
+  return WebAppManager::Instance()->ReloadConfiguration();
 }
 
 void WebAppManagerService::OnClearBrowsingData(
@@ -131,6 +186,12 @@ void WebAppManagerService::SetAccessibilityEnabled(bool enable) {
   WebAppManager::Instance()->SetAccessibilityEnabled(enable);
 }
 
+void WebAppManagerService::OnBootDone(bool boot_done) {
+  LOG_INFO(MSGID_LUNA_API, 1,
+           PMLOGKS("BOOT_DONE", boot_done ? "true" : "false"), "");
+  WebAppManager::Instance()->SetBootDone(boot_done);
+}
+
 uint32_t WebAppManagerService::GetWebProcessId(const std::string& app_id,
                                                const std::string& instance_id) {
   return WebAppManager::Instance()->GetWebProcessId(app_id, instance_id);
@@ -28,6 +28,8 @@ namespace Json {
 class Value;
 }
 
+class JsonWriter;
+
 enum ErrorCode {
   kErrCodeLaunchappMissParam = 1000,
   kErrCodeLaunchappUnsupportedType = 1001,
@@ -36,6 +38,7 @@ enum ErrorCode {
   kErrCodeClearDataBrawsingEmptyArray = 3000,
   kErrCodeClearDataBrawsingInvalidValue = 3001,
   kErrCodeClearDataBrawsingUnknownData = 3002,
+  kErrCodeReloadConfigFailed = 4000,
   kErrCodeInvalidParam = 5000
 };
 
@@ -48,12 +51,17 @@ const std::string kErrInvalidTrustLevel =
     "Invalid trust level (Check trustLevel)";
 
 const std::string kErrNoRunningApp = "App is not running";
+const std::string kErrClosedBeforeFirstFrame = "App closed before first frame";
+const std::string kErrClosedBeforeLaunch = "App closed before it was launched";
 
 const std::string kErrEmptyArray = "Empty array is not allowed.";
 const std::string kErrInvalidValue = "Invalid value";
 const std::string kErrUnknownData = "Unknown data";
 const std::string kErrOnlyAllowedForString = "Only allowed for string type";
 
+const std::string kErrReloadConfigFailed =
+    "Failed to load configuration (Check the file is a flat JSON object)";
+
 class WebAppBase;
 
 class WebAppManagerService {
@@ -64,17 +72,27 @@ class WebAppManagerService {
   virtual bool StartService() = 0;
   // methods published to the bus
   virtual Json::Value launchApp(const Json::Value& request) = 0;
+  virtual Json::Value launchApps(const Json::Value& request) = 0;
   virtual Json::Value killApp(const Json::Value& request) = 0;
   virtual Json::Value pauseApp(const Json::Value& request) = 0;
   virtual Json::Value logControl(const Json::Value& request) = 0;
   virtual Json::Value setInspectorEnable(const Json::Value& request) = 0;
   virtual Json::Value closeAllApps(const Json::Value& request) = 0;
-  virtual Json::Value listRunningApps(const Json::Value& request,
-                                      bool subscribed) = 0;
-  virtual Json::Value getWebProcessSize(const Json::Value& request) = 0;
+  // Large replies are written straight into |reply|, as the members of the
+  // reply object
+  virtual void listRunningApps(const Json::Value& request,
+                               bool subscribed,
+                               JsonWriter* reply) = 0;
+  virtual void getWebProcessSize(const Json::Value& request,
+                                 JsonWriter* reply) = 0;
   virtual Json::Value clearBrowsingData(const Json::Value& request) = 0;
   virtual Json::Value webProcessCreated(const Json::Value& request,
                                         bool subscribed) = 0;
+  virtual Json::Value getConfig(const Json::Value& request) = 0;
+  virtual Json::Value reloadConfig(const Json::Value& request) = 0;
+  virtual Json::Value getServiceStats(const Json::Value& request) = 0;
+  virtual Json::Value getLaunchTimelines(const Json::Value& request) = 0;
+  virtual Json::Value getMainLoopLag(const Json::Value& request) = 0;
 
  protected:
   std::string OnLaunch(const std::string& app_desc_string,
@@ -82,6 +100,13 @@ class WebAppManagerService {
                        const std::string& launching_app_id,
                        int& err_code,
                        std::string& err_msg);
+  void OnLaunchBatchBegin();
+  void OnLaunchBatchEnd(const std::vector<std::string>& instance_ids);
+  bool OnReplyOnFirstFrame(const std::string& instance_id,
+                           WebAppManager::LaunchReplyCallback send);
+  bool IsLaunchQueued(const std::string& instance_id);
+  bool OnReplyWhenLaunched(const std::string& instance_id,
+                           WebAppManager::LaunchReplyCallback send);
 
   bool OnKillApp(const std::string& app_id,
                  const std::string& instance_id,
@@ -89,7 +114,13 @@ class WebAppManagerService {
   bool OnPauseApp(const std::string& instance_id);
   Json::Value OnLogControl(const std::string& keys, const std::string& value);
   bool OnCloseAllApps(uint32_t pid = 0);
-  Json::Value GetWebProcessProfiling();
+  void GetWebProcessProfiling(JsonWriter* reply);
+  Json::Value GetLaunchStats(bool reset);
+  Json::Value GetLaunchTimelines(bool reset);
+  Json::Value GetMainLoopLag(bool reset);
+  Json::Value GetConfiguration();
+  std::string GetConfigurationOverridePath();
+  bool OnReloadConfiguration();
   int MaskForBrowsingDataType(const char* type);
   void OnClearBrowsingData(const int remove_browsing_data_mask);
   void OnAppInstalled(const std::string& app_id);
@@ -106,6 +137,7 @@ class WebAppManagerService {
   void UpdateNetworkStatus(const Json::Value& object);
   void NotifyMemoryPressure(webos::WebViewBase::MemoryPressureLevel level);
   void SetAccessibilityEnabled(bool enable);
+  void OnBootDone(bool boot_done);
   uint32_t GetWebProcessId(const std::string& app_id,
                            const std::string& instance_id);
 
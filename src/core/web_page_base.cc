@@ -18,11 +18,12 @@
 
 #include <filesystem>
 #include <memory>
-#include <sstream>
 
 #include <json/value.h>
 
 #include "application_description.h"
+#include "device_snapshot.h"
+#include "js_template.h"
 #include "log_manager.h"
 #include "utils.h"
 #include "web_app_manager.h"
@@ -66,6 +67,11 @@ std::string WebPageBase::LaunchParams() const {
   return launch_params_;
 }
 
+std::string_view WebPageBase::LaunchParamsOrEmptyObject() const {
+  return launch_params_.empty() ? std::string_view("{}")
+                                : std::string_view(launch_params_);
+}
+
 void WebPageBase::SetLaunchParams(const std::string& params) {
   launch_params_ = params;
 }
@@ -100,29 +106,28 @@ void WebPageBase::Load() {
 }
 
 void WebPageBase::SetupLaunchEvent() {
-  std::stringstream launch_event;
-  std::string params = LaunchParams().empty() ? "{}" : LaunchParams();
-  launch_event
-      << "(function() {"
-      << "    var dispatchLaunchEvent = function() {"
-      << "        var launchEvent = new CustomEvent('webOSLaunch', { detail: "
-      << params << " });"
-      << "        setTimeout(function() {"
-      << "            document.dispatchEvent(launchEvent);"
-      << "        }, 1);"
-      << "    };"
-      << "    if (document.readyState === 'complete') {"
-      << "        dispatchLaunchEvent();"
-      << "    } else {"
-      << "        document.onreadystatechange = function() {"
-      << "            if (document.readyState === 'complete') {"
-      << "                dispatchLaunchEvent();"
-      << "            }"
-      << "        };"
-      << "    }"
-      << "})();";
-
-  AddUserScript(launch_event.str());
+  static const JsTemplate kLaunchEvent(
+      "(function() {"
+      "    var dispatchLaunchEvent = function() {"
+      "        var launchEvent = new CustomEvent('webOSLaunch', { detail: "
+      "$0 });"
+      "        setTimeout(function() {"
+      "            document.dispatchEvent(launchEvent);"
+      "        }, 1);"
+      "    };"
+      "    if (document.readyState === 'complete') {"
+      "        dispatchLaunchEvent();"
+      "    } else {"
+      "        document.onreadystatechange = function() {"
+      "            if (document.readyState === 'complete') {"
+      "                dispatchLaunchEvent();"
+      "            }"
+      "        };"
+      "    }"
+      "})();");
+
+  kLaunchEvent.Render(script_buffer_, {LaunchParamsOrEmptyObject()});
+  AddUserScript(script_buffer_);
 }
 
 void WebPageBase::SendLocaleChangeEvent(const std::string& /*language*/) {
@@ -266,16 +271,15 @@ void WebPageBase::SendRelaunchEvent() {
   // Send the relaunch event on the next tick after javascript is loaded
   // This is a workaround for a problem where WebKit can't free the page
   // if we don't use a timeout here.
-  std::stringstream relaunch_event;
-  std::string detail = LaunchParams().empty() ? "{}" : LaunchParams();
-  relaunch_event
-      << "setTimeout(function () {"
-      << "    console.log('[WAM] fires webOSRelaunch event');"
-      << "    var launchEvent=new CustomEvent('webOSRelaunch', { detail: "
-      << detail << " });"
-      << "    document.dispatchEvent(launchEvent);"
-      << "}, 1);";
-  EvaluateJavaScript(relaunch_event.str().c_str());
+  static const JsTemplate kRelaunchEvent(
+      "setTimeout(function () {"
+      "    console.log('[WAM] fires webOSRelaunch event');"
+      "    var launchEvent=new CustomEvent('webOSRelaunch', { detail: "
+      "$0 });"
+      "    document.dispatchEvent(launchEvent);"
+      "}, 1);");
+  kRelaunchEvent.Render(script_buffer_, {LaunchParamsOrEmptyObject()});
+  EvaluateJavaScript(script_buffer_);
 }
 
 void WebPageBase::HandleLoadStarted() {
@@ -330,6 +334,10 @@ bool WebPageBase::GetDeviceInfo(const std::string& name, std::string& value) {
   return WebAppManager::Instance()->GetDeviceInfo(name, value);
 }
 
+std::shared_ptr<const DeviceSnapshot> WebPageBase::GetDeviceSnapshot() {
+  return WebAppManager::Instance()->GetDeviceSnapshot();
+}
+
 int WebPageBase::CurrentUiWidth() {
   return WebAppManager::Instance()->CurrentUiWidth();
 }
@@ -365,17 +373,18 @@ std::string WebPageBase::TelluriumNubPath() {
 bool WebPageBase::HasLoadErrorPolicy(bool is_http_response_error,
                                      int error_code) {
   if (load_error_policy_ == "event") {
-    std::stringstream jss;
-    std::string generic_error = is_http_response_error ? "false" : "true";
-    jss << "{"
-        << "    console.log('[WAM3] create webOSLoadError event');"
-        << "    var launchEvent=new CustomEvent('webOSLoadError',"
-        << "        { detail : { genericError : " << generic_error
-        << ", errorCode : " << error_code << " }});"
-        << "    document.dispatchEvent(launchEvent);"
-        << "}";
+    static const JsTemplate kLoadErrorEvent(
+        "{"
+        "    console.log('[WAM3] create webOSLoadError event');"
+        "    var launchEvent=new CustomEvent('webOSLoadError',"
+        "        { detail : { genericError : $0, errorCode : $1 }});"
+        "    document.dispatchEvent(launchEvent);"
+        "}");
+    kLoadErrorEvent.Render(script_buffer_,
+                           {is_http_response_error ? "false" : "true",
+                            std::to_string(error_code)});
     // App has load error policy, do not show platform load error page
-    EvaluateJavaScript(jss.str());
+    EvaluateJavaScript(script_buffer_);
     return true;
   }
   return false;
@@ -408,45 +417,41 @@ void WebPageBase::PostWebProcessCreated(uint32_t pid) {
 void WebPageBase::SetBackgroundColorOfBody(const std::string& color) {
   // for error page only, set default background color to white by executing
   // javascript
-  std::stringstream background_color_of_body;
-  background_color_of_body
-      << "(function() {"
-      << "    if(document.readyState === 'complete' || document.readyState === "
-         "'interactive') { "
-      << "       if(document.body.style.backgroundColor)"
-      << "           console.log('[Server Error] Already set "
-         "document.body.style.backgroundColor');"
-      << "       else {"
-      << "           console.log('[Server Error] set background Color of body "
-         "to "
-      << color << "');"
-      << "           document.body.style.backgroundColor = '" << color << "';"
-      << "       }"
-      << "     } else {"
-      << "        document.addEventListener('DOMContentLoaded', function() {"
-      << "           if(document.body.style.backgroundColor)"
-      << "               console.log('[Server Error] Already set "
-         "document.body.style.backgroundColor');"
-      << "           else {"
-      << "               console.log('[Server Error] set background Color of "
-         "body to "
-      << color << "');"
-      << "               document.body.style.backgroundColor = '" << color
-      << "';"
-      << "           }"
-      << "        });"
-      << "    }"
-      << "})();";
-
-  EvaluateJavaScript(background_color_of_body.str());
+  static const JsTemplate kSetBackgroundColorOfBody(
+      "(function() {"
+      "    if(document.readyState === 'complete' || document.readyState === "
+      "'interactive') { "
+      "       if(document.body.style.backgroundColor)"
+      "           console.log('[Server Error] Already set "
+      "document.body.style.backgroundColor');"
+      "       else {"
+      "           console.log('[Server Error] set background Color of body "
+      "to ' + $'0);"
+      "           document.body.style.backgroundColor = $'0;"
+      "       }"
+      "     } else {"
+      "        document.addEventListener('DOMContentLoaded', function() {"
+      "           if(document.body.style.backgroundColor)"
+      "               console.log('[Server Error] Already set "
+      "document.body.style.backgroundColor');"
+      "           else {"
+      "               console.log('[Server Error] set background Color of "
+      "body to ' + $'0);"
+      "               document.body.style.backgroundColor = $'0;"
+      "           }"
+      "        });"
+      "    }"
+      "})();");
+
+  kSetBackgroundColorOfBody.Render(script_buffer_, {color});
+  EvaluateJavaScript(script_buffer_);
 }
 
 std::string WebPageBase::DefaultFont() {
   std::string default_font = "LG Display-Regular";
-  std::string language;
-  std::string country;
-  GetSystemLanguage(language);
-  GetDeviceInfo("LocalCountry", country);
+  std::shared_ptr<const DeviceSnapshot> device = GetDeviceSnapshot();
+  const std::string& language = device->system_language;
+  const std::string& country = device->local_country;
 
   // for the model
   if (country == "JPN") {
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "webos/webview_base.h"
 
@@ -26,6 +27,7 @@
 #include "util/url.h"
 
 class ApplicationDescription;
+struct DeviceSnapshot;
 class WebAppBase;
 class WebAppManagerConfig;
 class WebPageObserver;
@@ -102,6 +104,7 @@ class WebPageBase {
   virtual void SuspendWebPageMedia() = 0;
   virtual void ResumeWebPageMedia() = 0;
   virtual void ResumeWebPagePaintingAndJSExecution() = 0;
+  virtual bool IsSuspended() const { return false; }
   virtual bool IsRegisteredCloseCallback() { return false; }
   virtual void ExecuteCloseCallback(bool /*forced*/) {}
   virtual void ReloadExtensionData() {}
@@ -116,6 +119,10 @@ class WebPageBase {
   virtual void ForwardEvent(void* event) = 0;
   virtual void SetAudioGuidanceOn(bool /*on*/) {}
   virtual bool IsInputMethodActive() const { return false; }
+  // Preference changes made between these calls reach the web view as a
+  // single update once the outermost transaction ends
+  virtual void BeginPreferenceUpdate() {}
+  virtual void EndPreferenceUpdate() {}
 
   std::string LaunchParams() const;
   void SetApplicationDescription(std::shared_ptr<ApplicationDescription> desc);
@@ -170,6 +177,7 @@ class WebPageBase {
   void HandleLoadFinished();
   void HandleLoadFailed(int error_code);
   bool GetDeviceInfo(const std::string& name, std::string& value);
+  std::shared_ptr<const DeviceSnapshot> GetDeviceSnapshot();
   bool GetSystemLanguage(std::string& value);
   int CurrentUiWidth();
   int CurrentUiHeight();
@@ -200,10 +208,14 @@ class WebPageBase {
   std::string launch_params_;
   std::string load_error_policy_ = "default";
   ObserverList<WebPageObserver> observers_;
+  // Reused for injected scripts, see JsTemplate
+  std::string script_buffer_;
 
  private:
   void SetBackgroundColorOfBody(const std::string& color);
   void SetupLaunchEvent();
+  // Launch parameters as an event detail
+  std::string_view LaunchParamsOrEmptyObject() const;
 
   bool cleaning_resources_ = false;
   bool is_preload_ = false;
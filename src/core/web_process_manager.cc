@@ -27,6 +27,7 @@
 #include <json/json.h>
 
 #include "application_description.h"
+#include "file_contents.h"
 #include "log_manager.h"
 #include "utils.h"
 #include "web_app_base.h"
@@ -106,7 +107,7 @@ std::string WebProcessManager::GetWebProcessMemSize(uint32_t pid) const {
   std::string line;
   while (std::getline(in, line)) {
     if (line.find("VmRSS:", 0, 6) != std::string::npos) {
-      return util::TrimString(std::string(line, 6)).c_str();
+      return std::string(util::Trim(std::string_view(line).substr(6)));
     }
   }
   return {};
@@ -115,10 +116,12 @@ std::string WebProcessManager::GetWebProcessMemSize(uint32_t pid) const {
 void WebProcessManager::ReadWebProcessPolicy() {
   std::string config_path =
       WebAppManager::Instance()->Config()->GetWebProcessConfigPath();
-  Json::Value web_process_environment =
-      util::StringToJson(util::ReadFile(config_path));
+  auto contents = FileContents::Read(config_path);
+  Json::Value web_process_environment;
 
-  if (web_process_environment.isNull()) {
+  if (!contents ||
+      !util::StringToJson(contents->View(), web_process_environment) ||
+      web_process_environment.isNull()) {
     LOG_ERROR(MSGID_WEBPROCESSENV_READ_FAIL, 1,
               PMLOGKS("PATH", config_path.c_str()), "JSON parsing failed");
     return;
@@ -198,21 +201,25 @@ std::string WebProcessManager::GetProcessKey(
       key = desc->Id();
     }
   } else {
+    // Ids of the groups seen so far are matched against every later group
     std::vector<std::string> id_list;
+    std::string replaced_app_id;
     for (const std::string& app_id : web_process_group_app_id_list_) {
       if (app_id.find('*') != std::string::npos) {
-        std::string replaced_app_id = app_id;
-        util::ReplaceSubstr(replaced_app_id, "*");
-        auto l = util::SplitString(replaced_app_id, ',');
-        id_list.insert(id_list.end(), l.begin(), l.end());
+        replaced_app_id.clear();
+        util::ReplaceAll(app_id, {{"*", ""}}, replaced_app_id);
+        for (std::string_view id : util::Split(replaced_app_id, ',')) {
+          id_list.emplace_back(id);
+        }
         for (const auto& id : id_list) {
           if (!desc->Id().compare(0, id.size(), id)) {
             key = app_id;
           }
         }
       } else {
-        auto l = util::SplitString(app_id, ',');
-        id_list.insert(id_list.end(), l.begin(), l.end());
+        for (std::string_view id : util::Split(app_id, ',')) {
+          id_list.emplace_back(id);
+        }
         for (const auto& id : id_list) {
           if (id == desc->Id()) {
             return app_id;
@@ -224,11 +231,13 @@ std::string WebProcessManager::GetProcessKey(
       return key;
     }
 
-    std::vector<std::string> trust_level_list;
+    // Views into the member list, which outlives the loop
+    std::vector<std::string_view> trust_level_list;
     for (const std::string& trust_level : web_process_group_trust_level_list_) {
-      auto l = util::SplitString(trust_level, ',');
-      trust_level_list.insert(trust_level_list.end(), l.begin(), l.end());
-      for (const auto& trust : trust_level_list) {
+      for (std::string_view trust : util::Split(trust_level, ',')) {
+        trust_level_list.push_back(trust);
+      }
+      for (std::string_view trust : trust_level_list) {
         if (trust == desc->TrustLevel()) {
           return trust_level;
         }
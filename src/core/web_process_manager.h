@@ -28,6 +28,7 @@ class Value;
 }
 
 class ApplicationDescription;
+class JsonWriter;
 class WebPageBase;
 class WebAppBase;
 
@@ -47,7 +48,8 @@ class WebProcessManager {
   void ReadWebProcessPolicy();
   std::string GetProcessKey(const ApplicationDescription* desc) const;
 
-  virtual Json::Value GetWebProcessProfiling() = 0;
+  // Writes the members of the getWebProcessSize reply
+  virtual void GetWebProcessProfiling(JsonWriter* reply) = 0;
   virtual uint32_t GetWebProcessPID(const WebAppBase* app) const = 0;
   virtual uint32_t GetInitialWebViewProxyID() const = 0;
   virtual void ClearBrowsingData(const int remove_browsing_data_mask) = 0;
@@ -26,6 +26,8 @@
 #include "application_description.h"
 #include "log_manager.h"
 #include "utils.h"
+#include "web_app_manager.h"
+#include "web_app_manager_config.h"
 #include "web_app_wayland_window.h"
 #include "web_app_window_impl.h"
 #include "web_page_base.h"
@@ -34,8 +36,6 @@
 
 namespace {
 
-static int kLaunchFinishAssureTimeoutMs = 5000;
-
 const std::unordered_map<std::string, webos::WebOSKeyMask>& GetKeyMaskTable() {
   static const std::unordered_map<std::string, webos::WebOSKeyMask> map_table{
       {"KeyMaskNone", static_cast<webos::WebOSKeyMask>(0)},
@@ -164,11 +164,8 @@ void WebAppWayland::Init(std::optional<int> width, std::optional<int> height) {
     LOG_DEBUG("App window for display[%d]", display_id_);
   }
 
-  int timeout = util::StrToIntWithDefault(
-      util::GetEnvVar("LAUNCH_FINISH_ASSURE_TIMEOUT"), 0);
-  if (timeout != 0) {
-    kLaunchFinishAssureTimeoutMs = timeout;
-  }
+  launch_finish_assure_timeout_ms_ =
+      WebAppManager::Instance()->Config()->GetLaunchFinishAssureTimeoutMs();
 
   if (!webos::WebOSPlatform::GetInstance()->GetInputPointer()) {
     // Create InputManager instance.
@@ -184,12 +181,14 @@ void WebAppWayland::StartLaunchTimer() {
 }
 
 void WebAppWayland::OnDelegateWindowFrameSwapped() {
+  WebAppManager::Instance()->MarkLaunchStage(InstanceId(),
+                                             LaunchTiming::kFirstFrame);
   if (elapsed_launch_timer_.IsRunning()) {
     last_swapped_time_ = elapsed_launch_timer_.ElapsedMs();
 
-    launch_timeout_timer_.Stop();
-    launch_timeout_timer_.StartWithReceiver(kLaunchFinishAssureTimeoutMs, this,
-                                            &WebAppWayland::OnLaunchTimeout);
+    launch_timeout_timer_.ExtendWithReceiver(launch_finish_assure_timeout_ms_,
+                                             this,
+                                             &WebAppWayland::OnLaunchTimeout);
   }
 }
 
@@ -699,6 +698,8 @@ void WebAppWayland::TitleChanged() {
 }
 
 void WebAppWayland::FirstFrameVisuallyCommitted() {
+  WebAppManager::Instance()->MarkLaunchStage(InstanceId(),
+                                             LaunchTiming::kFirstPaint);
   LOG_INFO(MSGID_WAM_DEBUG, 3, PMLOGKS("APP_ID", AppId().c_str()),
            PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
            PMLOGKFV("PID", "%d", Page()->GetWebProcessPID()),
@@ -744,6 +745,8 @@ void WebAppWayland::WebViewRecreated() {
 }
 
 void WebAppWayland::DidSwapPageCompositorFrame() {
+  WebAppManager::Instance()->MarkLaunchStage(InstanceId(),
+                                             LaunchTiming::kFirstFrame);
   if (!did_activate_stage_ && !GetHiddenWindow() &&
       preload_state_ == kNonePreload) {
     LOG_INFO(MSGID_WAM_DEBUG, 2, PMLOGKS("APP_ID", AppId().c_str()),
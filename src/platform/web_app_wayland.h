@@ -167,6 +167,7 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
   std::unique_ptr<WebAppWindow> app_window_;
   std::string window_type_;
   int last_swapped_time_ = 0;
+  int launch_finish_assure_timeout_ms_ = 0;
   bool did_activate_stage_ = false;
 
   std::vector<gfx::Rect> input_region_;
@@ -176,7 +177,8 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
   float vkb_height_ = 0;
 
   ElapsedTimer elapsed_launch_timer_;
-  OneShotTimer<WebAppWayland> launch_timeout_timer_;
+  // Pushed back on every swapped frame while the launch time is checked
+  DeadlineTimer<WebAppWayland> launch_timeout_timer_;
 
   int display_id_;
   std::string location_hint_;
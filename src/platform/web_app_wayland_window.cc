@@ -17,7 +17,10 @@
 #include "web_app_wayland_window.h"
 #include "application_description.h"
 #include "log_manager.h"
+#include "main_loop_watchdog.h"
 #include "utils.h"
+#include "web_app_manager.h"
+#include "web_app_manager_config.h"
 #include "web_app_wayland.h"
 
 WebAppWaylandWindow* WebAppWaylandWindow::instance_ = nullptr;
@@ -64,7 +67,8 @@ WebAppWaylandWindow* WebAppWaylandWindow::CreateWindow() {
 }
 
 WebAppWaylandWindow::WebAppWaylandWindow()
-    : cursor_enabled_(util::GetEnvVar("ENABLE_CURSOR_BY_DEFAULT") == "1") {}
+    : cursor_enabled_(
+          WebAppManager::Instance()->Config()->IsCursorEnabledByDefault()) {}
 
 void WebAppWaylandWindow::HideWindow() {
   LOG_INFO(MSGID_WAM_DEBUG, 2, PMLOGKS("APP_ID", web_app_->AppId().c_str()),
@@ -123,6 +127,7 @@ bool WebAppWaylandWindow::event(WebOSEvent* event) {
   }
 
   LogEventDebugging(event);
+  MainLoopWatchdog::Scope scope("window", "WebOSEvent", event->GetType());
 
   // TODO: Implement each event handler and
   // remove above event() function used for qtwebengine.
@@ -14,14 +14,15 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
-#include <set>
-#include <unordered_map>
-
-#include <json/json.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "blink_web_process_manager.h"
 #include "blink_web_view.h"
 #include "blink_web_view_profile_helper.h"
+#include "json_writer.h"
 #include "log_manager.h"
 #include "web_app_base.h"
 #include "web_app_manager_utils.h"
@@ -32,43 +33,41 @@ uint32_t BlinkWebProcessManager::GetWebProcessPID(const WebAppBase* app) const {
   return static_cast<WebPageBlink*>(app->Page())->RenderProcessPid();
 }
 
-Json::Value BlinkWebProcessManager::GetWebProcessProfiling() {
-  Json::Value reply;
-  Json::Value process_array(Json::arrayValue);
-  Json::Value process_object;
-
-  std::set<uint32_t> process_id_list;
-  std::unordered_multimap<uint32_t, WebAppBase*> running_app_list;
-
-  const std::list<const WebAppBase*>& running = RunningApps();
-
-  for (const auto& elem : running) {
-    WebAppBase* app = FindAppByInstanceId((elem)->InstanceId());
-    const uint32_t pid = GetWebProcessPID(app);
-    process_id_list.insert(pid);
-    running_app_list.emplace(pid, app);
+void BlinkWebProcessManager::GetWebProcessProfiling(JsonWriter* reply) {
+  // Apps grouped by their web process, in ascending pid order
+  std::vector<std::pair<uint32_t, WebAppBase*>> running_apps;
+  for (const WebAppBase* elem : RunningApps()) {
+    WebAppBase* app = FindAppByInstanceId(elem->InstanceId());
+    running_apps.emplace_back(GetWebProcessPID(app), app);
   }
+  std::stable_sort(
+      running_apps.begin(), running_apps.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
 
-  for (uint32_t pid : process_id_list) {
-    Json::Value app_object;
-    Json::Value app_array(Json::arrayValue);
-
-    process_object["pid"] = std::to_string(pid);
-    process_object["webProcessSize"] = GetWebProcessMemSize(pid);
-    process_object["tileSize"] = 0;
-    auto processes = running_app_list.equal_range(pid);
-    for (auto app = processes.first; app != processes.second; app++) {
-      app_object["id"] = app->second->AppId();
-      app_object["instanceId"] = app->second->InstanceId();
-      app_array.append(app_object);
+  reply->Key("WebProcesses").BeginArray();
+  for (auto process = running_apps.begin(); process != running_apps.end();) {
+    const uint32_t pid = process->first;
+    reply->BeginObject()
+        .Key("pid")
+        .String(std::to_string(pid))
+        .Key("webProcessSize")
+        .String(GetWebProcessMemSize(pid))
+        .Key("tileSize")
+        .Int(0)
+        .Key("runningApps")
+        .BeginArray();
+    for (; process != running_apps.end() && process->first == pid; ++process) {
+      reply->BeginObject()
+          .Key("id")
+          .String(process->second->AppId())
+          .Key("instanceId")
+          .String(process->second->InstanceId())
+          .EndObject();
     }
-    process_object["runningApps"] = std::move(app_array);
-    process_array.append(process_object);
+    reply->EndArray().EndObject();
   }
-
-  reply["WebProcesses"] = std::move(process_array);
-  reply["returnValue"] = true;
-  return reply;
+  reply->EndArray();
+  reply->Key("returnValue").Bool(true);
 }
 
 uint32_t BlinkWebProcessManager::GetInitialWebViewProxyID() const {
@@ -30,7 +30,7 @@ class WebAppBase;
 class BlinkWebProcessManager : public WebProcessManager {
  public:
   // WebProcessManager
-  Json::Value GetWebProcessProfiling() override;
+  void GetWebProcessProfiling(JsonWriter* reply) override;
   uint32_t GetWebProcessPID(const WebAppBase* app) const override;
   uint32_t GetInitialWebViewProxyID() const override;
   void ClearBrowsingData(const int remove_browsing_data_mask) override;
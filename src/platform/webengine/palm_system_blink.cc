@@ -17,6 +17,7 @@
 #include "json/json.h"
 
 #include "application_description.h"
+#include "device_snapshot.h"
 #include "log_manager.h"
 #include "palm_system_blink.h"
 #include "utils.h"
@@ -52,7 +53,7 @@ std::string PalmSystemBlink::HandleBrowserControlMessage(
   } else if (command == "screenOrientation") {
     return ScreenOrientation();
   } else if (command == "currentCountryGroup") {
-    return GetDeviceInfo("CountryGroup");
+    return GetDeviceSnapshot()->country_group;
   } else if (command == "stageReady") {
     StageReady();
   } else if (command == "activate") {
@@ -226,17 +227,19 @@ double PalmSystemBlink::DevicePixelRatio() {
 Json::Value PalmSystemBlink::Initialize() {
   initialized_ = true;
 
+  std::shared_ptr<const DeviceSnapshot> device = GetDeviceSnapshot();
+
   Json::Value data;
   data["launchParams"] = LaunchParams();
   data["country"] = Country();
-  data["tvSystemName"] = GetDeviceInfo("TvSystemName");
-  data["currentCountryGroup"] = GetDeviceInfo("CountryGroup");
-  data["locale"] = Locale();
+  data["tvSystemName"] = device->tv_system_name;
+  data["currentCountryGroup"] = device->country_group;
+  data["locale"] = device->system_language;
   data["localeRegion"] = LocaleRegion();
   data["isMinimal"] = IsMinimal();
   data["identifier"] = Identifier();
   data["screenOrientation"] = ScreenOrientation();
-  data["deviceInfo"] = GetDeviceInfo("TvDeviceInfo");
+  data["deviceInfo"] = device->tv_device_info;
   data["activityId"] = static_cast<double>(ActivityId());
   data["phoneRegion"] = PhoneRegion();
   data["folderPath"] = app_->GetAppDescription()->FolderPath();
@@ -26,10 +26,13 @@
 #include "application_description.h"
 #include "blink_web_process_manager.h"
 #include "blink_web_view.h"
+#include "device_snapshot.h"
+#include "js_template.h"
 #include "log_manager.h"
 #include "palm_system_blink.h"
 #include "url.h"
 #include "utils.h"
+#include "web_app_manager.h"
 #include "web_app_manager_config.h"
 #include "web_app_manager_tracer.h"
 #include "web_app_manager_utils.h"
@@ -46,6 +49,10 @@
 
 static const int kExecuteCloseCallbackTimeOutMs = 10000;
 static const int kReloadTimeoutMs = 60000;
+// Neither timer needs to be exact; the slack lets the timer wheel fire them
+// together with the ones of other pages
+static const int kReloadTimeoutSlackMs = 1000;
+static const int kDomSuspendSlackMs = 500;
 
 class WebPageBlinkPrivate {
  public:
@@ -65,7 +72,10 @@ WebPageBlink::WebPageBlink(const wam::Url& url,
     : WebPageBase(url, desc, params),
       page_private_(std::make_unique<WebPageBlinkPrivate>(this)),
       trust_level_(desc->TrustLevel()),
-      factory_(std::move(factory)) {}
+      factory_(std::move(factory)) {
+  dom_suspend_timer_.SetSlackMs(kDomSuspendSlackMs);
+  net_error_reload_timer_.SetSlackMs(kReloadTimeoutSlackMs);
+}
 
 WebPageBlink::WebPageBlink(const wam::Url& url,
                            std::shared_ptr<ApplicationDescription> desc,
@@ -94,7 +104,7 @@ void WebPageBlink::Init() {
       GetWebAppManagerConfig()->GetName());
 
   const std::string& privileged_plugin_path =
-      util::GetEnvVar("PRIVILEGED_PLUGIN_PATH");
+      GetWebAppManagerConfig()->GetPrivilegedPluginPath();
   if (!privileged_plugin_path.empty()) {
     page_private_->page_view_->AddAvailablePluginDir(privileged_plugin_path);
   }
@@ -133,7 +143,7 @@ void WebPageBlink::Init() {
       break;
     default:
       page_private_->page_view_->SetAllowThirdPartyCookies(
-          !(util::GetEnvVar("WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES") == "0"));
+          GetWebAppManagerConfig()->IsDefaultAllowThirdPartyCookies());
   }
 
   if (app_desc_->TrustLevel() == "trusted") {
@@ -185,7 +195,7 @@ void WebPageBlink::Init() {
   page_private_->page_view_->SetUseVideoDecodeAccelerator(
       app_desc_->UseVideoDecodeAccelerator());
 
-  page_private_->page_view_->UpdatePreferences();
+  UpdatePreferences();
 
   LoadExtension();
 }
@@ -259,7 +269,7 @@ void WebPageBlink::SetPreferredLanguages(const std::string& language) {
   // navigator.language, navigator.languages even window.languagechange event
   // too
   page_private_->page_view_->SetAcceptLanguages(language);
-  page_private_->page_view_->UpdatePreferences();
+  RequestUpdatePreferences();
 #endif
 }
 
@@ -281,19 +291,12 @@ void WebPageBlink::ReloadDefaultPage() {
   LoadDefaultUrl();
 }
 
-std::vector<std::string> WebPageBlink::GetErrorPagePath(
-    const std::string& error_page) {
-  const std::string& filepath = util::UriToLocal(error_page);
-  if (filepath.empty()) {
-    return std::vector<std::string>();
+void WebPageBlink::ReloadFailedUrl() {
+  // Frozen background pages stay failed until they are shown again
+  if (is_suspended_) {
+    return;
   }
-  std::string language;
-  GetSystemLanguage(language);
 
-  return util::GetErrorPagePaths(filepath, language);
-}
-
-void WebPageBlink::ReloadFailedUrl() {
   LOG_INFO(MSGID_WAM_DEBUG, 2, PMLOGKS("APP_ID", AppId().c_str()),
            PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
            "ReloadFailedUrl: '%s'", load_failed_url_.c_str());
@@ -327,18 +330,17 @@ void WebPageBlink::LoadErrorPage(int error_code) {
     // es-ES fr-CA, pt-PT has its own localization folder and
     // QLocale::bcp47Name() returns well
 
-    const auto& paths = GetErrorPagePath(errorpage);
-    auto found =
-        std::find_if(std::cbegin(paths), std::cend(paths), util::DoesPathExist);
+    // Resolved from the index of available localizations, no stat() here
+    const std::string found = WebAppManager::Instance()->GetErrorPagePath();
 
     // finally found something!
-    if (found != paths.end()) {
+    if (!found.empty()) {
       // re-create it as a proper URL, so WebKit can understand it
       is_load_error_page_start_ = true;
-      wam::Url error_url = wam::Url::FromLocalFile(*found);
+      wam::Url error_url = wam::Url::FromLocalFile(found);
       if (error_url.ToString().empty()) {
         LOG_ERROR(MSGID_ERROR_ERROR, 1, PMLOGKS("PATH", errorpage.c_str()),
-                  "Error during conversion %s to URI", found->c_str());
+                  "Error during conversion %s to URI", found.c_str());
         return;
       }
       wam::Url::UrlQuery query;
@@ -402,7 +404,7 @@ void WebPageBlink::SuspendWebPageAll() {
     return;
   }
 
-  if (!(util::GetEnvVar("WAM_KEEP_RTC_CONNECTIONS_ON_SUSPEND") == "1")) {
+  if (!GetWebAppManagerConfig()->IsKeepRtcConnectionsOnSuspend()) {
     // On sending applications to background, disconnect RTC
     page_private_->page_view_->DropAllPeerConnections(
         webos::DROP_PEER_CONNECTION_REASON_PAGE_HIDDEN);
@@ -565,12 +567,7 @@ void WebPageBlink::ResumeWebPagePaintingAndJSExecution() {
 }
 
 std::string WebPageBlink::EscapeData(const std::string& value) {
-  std::string escaped_value = value;
-  util::ReplaceSubstr(escaped_value, "\\", "\\\\");
-  util::ReplaceSubstr(escaped_value, "'", "\\'");
-  util::ReplaceSubstr(escaped_value, "\n", "\\n");
-  util::ReplaceSubstr(escaped_value, "\r", "\\r");
-  return escaped_value;
+  return EscapeJsString(value);
 }
 
 void WebPageBlink::ReloadExtensionData() {
@@ -595,17 +592,16 @@ void WebPageBlink::UpdateExtensionData(const std::string& key,
                 value.c_str());
     return;
   }
-  std::string event_js =
+  static const JsTemplate kUpdateInjectionData(
       "if (typeof(webOSSystem) != 'undefined') {"
-      "  webOSSystem.updateInjectionData('" +
-      EscapeData(key) + "', '" + EscapeData(value) +
-      "');"
-      "};";
+      "  webOSSystem.updateInjectionData($'0, $'1);"
+      "};");
+  kUpdateInjectionData.Render(script_buffer_, {key, value});
   LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", AppId().c_str()),
            PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
            PMLOGKFV("PID", "%d", GetWebProcessPID()),
            "Update; key:%s; value:%s", key.c_str(), value.c_str());
-  EvaluateJavaScript(event_js);
+  EvaluateJavaScript(script_buffer_);
 }
 
 void WebPageBlink::HandleDeviceInfoChanged(const std::string& device_info) {
@@ -953,7 +949,7 @@ void WebPageBlink::SetPageProperties() {
   }
 
   SetTrustLevel(DefaultTrustLevel());
-  page_private_->page_view_->UpdatePreferences();
+  UpdatePreferences();
 }
 
 void WebPageBlink::CreatePalmSystem(WebAppBase* app) {
@@ -1055,18 +1051,14 @@ void WebPageBlink::SetAdditionalContentsScale(float scale_x, float scale_y) {
 }
 
 void WebPageBlink::UpdateHardwareResolution() {
-  std::string hardware_width, hardware_height;
-  GetDeviceInfo("HardwareScreenWidth", hardware_width);
-  GetDeviceInfo("HardwareScreenHeight", hardware_height);
-  int width = util::StrToIntWithDefault(hardware_width, 0);
-  int height = util::StrToIntWithDefault(hardware_height, 0);
-  page_private_->page_view_->SetHardwareResolution(width, height);
+  std::shared_ptr<const DeviceSnapshot> device = GetDeviceSnapshot();
+  page_private_->page_view_->SetHardwareResolution(
+      device->hardware_screen_width.value_or(0),
+      device->hardware_screen_height.value_or(0));
 }
 
 void WebPageBlink::UpdateBoardType() {
-  std::string board_type;
-  GetDeviceInfo("boardType", board_type);
-  page_private_->page_view_->SetBoardType(board_type);
+  page_private_->page_view_->SetBoardType(GetDeviceSnapshot()->board_type);
 }
 
 void WebPageBlink::UpdateMediaCodecCapability() {
@@ -1079,72 +1071,31 @@ void WebPageBlink::UpdateMediaCodecCapability() {
 }
 
 double WebPageBlink::DevicePixelRatio() {
-  float device_pixel_ratio = 1.0;
+  std::shared_ptr<const DeviceSnapshot> device = GetDeviceSnapshot();
+  int app_width = app_desc_->WidthOverride().value_or(device->display_width);
+  int app_height =
+      app_desc_->HeightOverride().value_or(device->display_height);
 
-  int app_width;
-  int app_height;
-  if (app_desc_->WidthOverride().has_value()) {
-    app_width = app_desc_->WidthOverride().value();
-  } else {
-    app_width = CurrentUiWidth();
-  }
-  if (app_desc_->HeightOverride().has_value()) {
-    app_height = app_desc_->HeightOverride().value();
-  } else {
-    app_height = CurrentUiHeight();
-  }
-  if (app_width == 0 || app_height == 0) {
-    return device_pixel_ratio;
-  }
-
-  int device_width = 0;
-  int device_height = 0;
-  std::string hardware_width, hardware_height;
-  if (GetDeviceInfo("HardwareScreenWidth", hardware_width) &&
-      GetDeviceInfo("HardwareScreenHeight", hardware_height)) {
-    device_width = util::StrToIntWithDefault(hardware_width, 0);
-    device_height = util::StrToIntWithDefault(hardware_height, 0);
-  } else {
-    device_width = CurrentUiWidth();
-    device_height = CurrentUiHeight();
-  }
-
-  float ratio_x = static_cast<float>(device_width) / app_width;
-  float ratio_y = static_cast<float>(device_height) / app_height;
-  bool ratios_are_equal =
-      std::abs(ratio_x - ratio_y) < std::numeric_limits<float>::epsilon();
-  if (!ratios_are_equal) {
-    // device resolution : 5120x2160 (UHD 21:9 - D9)
-    // - app resolution : 1280x720 ==> 4:3 (have to take 3)
-    // - app resolution : 1920x1080 ==> 2.6:2 (have to take 2)
-    device_pixel_ratio = (ratio_x < ratio_y) ? ratio_x : ratio_y;
-  } else {
-    // device resolution : 1920x1080
-    // - app resolution : 1280x720 ==> 1.5:1.5
-    // - app resolution : 1920x1080 ==> 1:1
-    // device resolution : 3840x2160
-    // - app resolution : 1280x720 ==> 3:3
-    // - app resolution : 1920x1080 ==> 2:2
-    device_pixel_ratio = ratio_x;
-  }
+  float device_pixel_ratio = device->DevicePixelRatio(app_width, app_height);
   LOG_DEBUG(
       "[%s] WebPageBlink::devicePixelRatio(); devicePixelRatio : %f; "
       "deviceWidth : %d, deviceHeight : %d, appWidth : %d, appHeight : %d",
-      AppId().c_str(), device_pixel_ratio, device_width, device_height,
-      app_width, app_height);
+      AppId().c_str(), device_pixel_ratio, device->DeviceWidth(),
+      device->DeviceHeight(), app_width, app_height);
   return device_pixel_ratio;
 }
 
 void WebPageBlink::SetSupportDolbyHDRContents() {
-  std::string support_dolby_hdr_contents;
-  GetDeviceInfo("supportDolbyHDRContents", support_dolby_hdr_contents);
+  bool support_dolby_hdr_contents =
+      GetDeviceSnapshot()->support_dolby_hdr_contents;
   LOG_INFO(MSGID_WAM_DEBUG, 3, PMLOGKS("APP_ID", AppId().c_str()),
            PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
            PMLOGKFV("PID", "%d", GetWebProcessPID()),
-           "supportDolbyHDRContents:%s", support_dolby_hdr_contents.c_str());
+           "supportDolbyHDRContents:%s",
+           support_dolby_hdr_contents ? "true" : "false");
 
   Json::Value preferences = util::StringToJson(app_desc_->MediaPreferences());
-  preferences["supportDolbyHDR"] = support_dolby_hdr_contents == "true";
+  preferences["supportDolbyHDR"] = support_dolby_hdr_contents;
   app_desc_->SetMediaPreferences(util::JsonToString(preferences));
 }
 
@@ -1164,7 +1115,7 @@ void WebPageBlink::SetKeepAliveWebApp(bool keep_alive) {
            PMLOGKFV("PID", "%d", GetWebProcessPID()), "setKeepAliveWebApp(%s)",
            keep_alive ? "true" : "false");
   page_private_->page_view_->SetKeepAliveWebApp(keep_alive);
-  page_private_->page_view_->UpdatePreferences();
+  RequestUpdatePreferences();
 }
 
 void WebPageBlink::SetLoadErrorPolicy(const std::string& policy) {
@@ -1210,19 +1161,15 @@ bool WebPageBlink::AcceptsAudioCapture() {
 }
 
 void WebPageBlink::KeyboardVisibilityChanged(bool visible) {
-  std::string visible_str = visible ? "true" : "false";
-  std::string javascript =
-      "console.log('[WAM] fires keyboardStateChange event : " + visible_str +
-      "');"
+  static const JsTemplate kKeyboardStateChangeEvent(
+      "console.log('[WAM] fires keyboardStateChange event : $0');"
       "    var keyboardStateEvent =new CustomEvent('keyboardStateChange', { "
-      "detail: { 'visibility' : " +
-      visible_str +
-      " } });"
-      "    keyboardStateEvent.visibility = " +
-      visible_str +
-      ";"
-      "    if(document) document.dispatchEvent(keyboardStateEvent);";
-  EvaluateJavaScript(javascript);
+      "detail: { 'visibility' : $0 } });"
+      "    keyboardStateEvent.visibility = $0;"
+      "    if(document) document.dispatchEvent(keyboardStateEvent);");
+  kKeyboardStateChangeEvent.Render(script_buffer_,
+                                   {visible ? "true" : "false"});
+  EvaluateJavaScript(script_buffer_);
 }
 
 void WebPageBlink::UpdateIsLoadErrorPageFinish() {
@@ -1270,6 +1217,40 @@ void WebPageBlink::DeactivateRendererCompositor() {
 
 void WebPageBlink::SetAudioGuidanceOn(bool on) {
   page_private_->page_view_->SetAudioGuidanceOn(on);
+  RequestUpdatePreferences();
+}
+
+void WebPageBlink::BeginPreferenceUpdate() {
+  ++preference_update_depth_;
+}
+
+void WebPageBlink::EndPreferenceUpdate() {
+  if (preference_update_depth_ == 0) {
+    return;
+  }
+
+  if (--preference_update_depth_ == 0 && preferences_changed_) {
+    RequestUpdatePreferences();
+  }
+}
+
+void WebPageBlink::RequestUpdatePreferences() {
+  preferences_changed_ = true;
+  if (preference_update_depth_ > 0 || update_preferences_timer_.IsRunning()) {
+    return;
+  }
+
+  // Flushed from the main loop so that settings changed in a row, e.g. by
+  // a system wide broadcast, cost a single preferences update
+  update_preferences_timer_.StartWithReceiver(
+      0, this, &WebPageBlink::UpdatePreferences);
+}
+
+void WebPageBlink::UpdatePreferences() {
+  if (update_preferences_timer_.IsRunning()) {
+    update_preferences_timer_.Stop();
+  }
+  preferences_changed_ = false;
   page_private_->page_view_->UpdatePreferences();
 }
 
@@ -90,6 +90,7 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
   void SuspendWebPageMedia() override;
   void ResumeWebPageMedia() override;
   void ResumeWebPagePaintingAndJSExecution() override;
+  bool IsSuspended() const override { return is_suspended_; }
   bool IsRegisteredCloseCallback() override { return has_close_callback_; }
   void ExecuteCloseCallback(bool forced) override;
   void ReloadExtensionData() override;
@@ -101,6 +102,8 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
   void SetAudioGuidanceOn(bool on) override;
   void ActivateRendererCompositor() override;
   void DeactivateRendererCompositor() override;
+  void BeginPreferenceUpdate() override;
+  void EndPreferenceUpdate() override;
 
   // WebPageBlink
   virtual void LoadExtension();
@@ -158,6 +161,7 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
 
   // Timer callback
   void TimeoutCloseCallback();
+  void UpdatePreferences();
 
   void UpdateBackHistoryAPIDisabled();
 
@@ -194,8 +198,8 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
  private:
   void SetCustomPluginIfNeeded();
   void SetDisallowScrolling(bool disallow);
-  std::vector<std::string> GetErrorPagePath(const std::string& error_page);
   void ReloadFailedUrl();
+  void RequestUpdatePreferences();
 
   std::unique_ptr<WebPageBlinkPrivate> page_private_;
 
@@ -212,6 +216,9 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
   std::string loading_url_;
   int custom_suspend_dom_time_ = 0;
   RepeatingTimer<WebPageBlink> net_error_reload_timer_;
+  int preference_update_depth_ = 0;
+  bool preferences_changed_ = false;
+  OneShotTimer<WebPageBlink> update_preferences_timer_;
 
   WebPageBlinkObserver* observer_ = nullptr;
 
@@ -22,10 +22,164 @@
 //   (is read from "vendorExtension" tag)
 //   is accessible via std::string& vendorExtension(), which is never called
 
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "bcp47.h"
 
+namespace {
+
+struct ConformanceCase {
+  const char* tag;
+  bool well_formed;
+  const char* language;
+  const char* script;
+  const char* region;
+};
+
+// Mostly the examples of RFC 5646 appendix A
+const ConformanceCase kConformanceCorpus[] = {
+    // Simple language subtag
+    {"de", true, "de", "", ""},
+    {"fr", true, "fr", "", ""},
+    {"ja", true, "ja", "", ""},
+    {"haw", true, "haw", "", ""},
+    // Language subtag plus script subtag
+    {"zh-Hant", true, "zh", "Hant", ""},
+    {"zh-Hans", true, "zh", "Hans", ""},
+    {"sr-Cyrl", true, "sr", "Cyrl", ""},
+    {"sr-Latn", true, "sr", "Latn", ""},
+    // Extended language subtags
+    {"zh-cmn-Hans-CN", true, "zh", "Hans", "CN"},
+    {"cmn-Hans-CN", true, "cmn", "Hans", "CN"},
+    {"zh-yue-HK", true, "zh", "", "HK"},
+    {"yue-HK", true, "yue", "", "HK"},
+    {"zh-abc-def-ghi", true, "zh", "", ""},
+    // Language-Script-Region
+    {"zh-Hans-CN", true, "zh", "Hans", "CN"},
+    {"sr-Latn-RS", true, "sr", "Latn", "RS"},
+    // Language-Variant
+    {"sl-rozaj", true, "sl", "", ""},
+    {"sl-rozaj-biske", true, "sl", "", ""},
+    {"sl-nedis", true, "sl", "", ""},
+    // Language-Region-Variant
+    {"de-CH-1901", true, "de", "", "CH"},
+    {"sl-IT-nedis", true, "sl", "", "IT"},
+    // Language-Script-Region-Variant
+    {"hy-Latn-IT-arevela", true, "hy", "Latn", "IT"},
+    // Language-Region
+    {"de-DE", true, "de", "", "DE"},
+    {"en-US", true, "en", "", "US"},
+    {"es-419", true, "es", "", "419"},
+    // Private use subtags
+    {"de-CH-x-phonebk", true, "de", "", "CH"},
+    {"az-Arab-x-AZE-derbend", true, "az", "Arab", ""},
+    // Private use registry values
+    {"qaa-Qaaa-QM-x-southern", true, "qaa", "Qaaa", "QM"},
+    {"de-Qaaa", true, "de", "Qaaa", ""},
+    {"sr-Latn-QM", true, "sr", "Latn", "QM"},
+    {"sr-Qaaa-RS", true, "sr", "Qaaa", "RS"},
+    // Tags that use extensions
+    {"en-US-u-islamcal", true, "en", "", "US"},
+    {"zh-CN-a-myext-x-private", true, "zh", "", "CN"},
+    {"en-a-myext-b-another", true, "en", "", ""},
+    // Scripts are taken in any case and come back titlecased, other
+    // subtags have to be in the case of the registry
+    {"zh-hant-TW", true, "zh", "Hant", "TW"},
+    {"sr-LATN", true, "sr", "Latn", ""},
+    {"de-CH-X-PHONEBK", true, "de", "", "CH"},
+    {"EN-US", false, "", "", ""},
+    {"en-us", false, "", "", ""},
+    {"zh-CMN-Hans", false, "", "", ""},
+    // Longer language subtags
+    {"abcde", true, "abcde", "", ""},
+    {"abcdefgh-US", true, "abcdefgh", "", "US"},
+    // Some invalid tags
+    {"de-419-DE", false, "", "", ""},
+    {"a-DE", false, "", "", ""},
+    {"ar-a-aaa-b-bbb-a-ccc", false, "", "", ""},
+    {"de-DE-1901-1901", false, "", "", ""},
+    {"abcd-abc", false, "", "", ""},
+    {"en-abc-def-ghi-jkl", false, "", "", ""},
+    {"en-Latn-Latn", false, "", "", ""},
+    {"en-US-US", false, "", "", ""},
+    {"abcdefghi", false, "", "", ""},
+    {"e", false, "", "", ""},
+    {"en1", false, "", "", ""},
+    {"en-", false, "", "", ""},
+    {"-en", false, "", "", ""},
+    {"en--US", false, "", "", ""},
+    {"en-US-", false, "", "", ""},
+    {"en-a", false, "", "", ""},
+    {"en-x", false, "", "", ""},
+    {"en-a-x-private", false, "", "", ""},
+    {"en-a-toolongext", false, "", "", ""},
+    {"en-x-toolongpu", false, "", "", ""},
+    {"en_US", false, "", "", ""},
+    {"en US", false, "", "", ""},
+    {"en-La`n", false, "", "", ""},
+    // Without a language
+    {"x-whatever", false, "", "", ""},
+    {"i-enochian", false, "", "", ""},
+    {"US", false, "", "", ""},
+    {"Hant-CN", false, "", "", ""},
+};
+
+// BCP47::FromString() as it was before the hand-written parser
+bool LegacyParse(const std::string& tag,
+                 std::string* language,
+                 std::string* script,
+                 std::string* region) {
+  std::regex rfc5646_regex(
+      R"(^([a-z]{2,3})(?:[\-]{1}([A-z]{4}))?(?:[\-]{1}([A-Z]{2}|[0-9]{3}))?$)");
+  std::smatch match;
+  if (!std::regex_match(tag, match, rfc5646_regex)) {
+    return false;
+  }
+  *language = match[1];
+  *script = match[2];
+  *region = match[3];
+  return true;
+}
+
+// Tags of the shape the legacy parser accepted, with some subtags out of
+// range or in the wrong case
+std::string RandomTag(std::mt19937& engine) {
+  auto number = [&engine](int min, int max) {
+    return std::uniform_int_distribution<int>(min, max)(engine);
+  };
+  auto word = [&](const std::string& alphabet, int min, int max) {
+    std::string word;
+    int length = number(min, max);
+    for (int i = 0; i < length; ++i) {
+      word += alphabet[number(0, alphabet.size() - 1)];
+    }
+    return word;
+  };
+
+  const std::string lower = "abcxyz";
+  const std::string upper = "ABCXYZ";
+  const std::string digits = "0159";
+  std::string tag = word(lower + (number(0, 9) ? "" : "A1"), 1, 4);
+  if (number(0, 1)) {
+    tag += "-" + word(upper + lower, 3, 5);
+  }
+  if (number(0, 1)) {
+    tag += "-" + (number(0, 1) ? word(upper + (number(0, 9) ? "" : "a"), 1, 3)
+                               : word(digits, 2, 4));
+  }
+  return tag;
+}
+
+}  // namespace
+
 TEST(BCP47TestSuite, EmptyLanguage) {
   auto bcp47_pieces = BCP47::FromString("");
   ASSERT_FALSE(bcp47_pieces);
@@ -96,3 +250,71 @@ TEST(BCP47TestSuite, LangScriptRegionNumeric) {
   EXPECT_STREQ(bcp47_pieces->Script().c_str(), "Latn");
   EXPECT_STREQ(bcp47_pieces->Region().c_str(), "005");
 }
+
+TEST(BCP47TestSuite, ConformanceCorpus) {
+  for (const ConformanceCase& test : kConformanceCorpus) {
+    SCOPED_TRACE(test.tag);
+    auto bcp47_pieces = BCP47::FromString(test.tag);
+    ASSERT_EQ(test.well_formed, !!bcp47_pieces);
+    if (!bcp47_pieces) {
+      continue;
+    }
+    EXPECT_EQ(test.language, bcp47_pieces->Language());
+    EXPECT_EQ(test.script, bcp47_pieces->Script());
+    EXPECT_EQ(test.region, bcp47_pieces->Region());
+  }
+}
+
+TEST(BCP47TestSuite, AcceptsWhatTheLegacyParserAccepted) {
+  std::mt19937 engine(5646);
+  for (int i = 0; i < 2000; ++i) {
+    std::string tag = RandomTag(engine);
+    SCOPED_TRACE(tag);
+
+    std::string language, script, region;
+    if (!LegacyParse(tag, &language, &script, &region)) {
+      continue;
+    }
+    auto bcp47_pieces = BCP47::FromString(tag);
+    ASSERT_TRUE(bcp47_pieces);
+    EXPECT_EQ(language, bcp47_pieces->Language());
+    // Scripts were taken in any case, they now come back titlecased
+    for (size_t c = 0; c < script.size(); ++c) {
+      script[c] = c ? std::tolower(script[c]) : std::toupper(script[c]);
+    }
+    EXPECT_EQ(script, bcp47_pieces->Script());
+    EXPECT_EQ(region, bcp47_pieces->Region());
+  }
+}
+
+// Not run by default: --gtest_also_run_disabled_tests --gtest_filter=*Bench*
+TEST(BCP47TestSuite, DISABLED_Benchmark) {
+  const std::vector<std::string> tags = {"en", "en-US", "ko-KR", "zh-Hans-CN",
+                                         "es-419", "sr-Latn-RS", "pt-BR"};
+  const int kRounds = 20000;
+
+  auto start = std::chrono::steady_clock::now();
+  size_t parsed = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const std::string& tag : tags) {
+      parsed += !!BCP47::FromString(tag);
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  std::cout << "BCP47::FromString: " << elapsed.count() * 1000 / parsed
+            << " ns per tag" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  parsed = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const std::string& tag : tags) {
+      std::string language, script, region;
+      parsed += LegacyParse(tag, &language, &script, &region);
+    }
+  }
+  elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  std::cout << "Legacy regex parser: " << elapsed.count() * 1000 / parsed
+            << " ns per tag" << std::endl;
+}
@@ -0,0 +1,199 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "context_task_queue.h"
+#include "utils.h"
+
+namespace {
+
+void RunUntil(const std::function<bool()>& done) {
+  while (!done()) {
+    g_main_context_iteration(nullptr, FALSE);
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+TEST(ContextTaskQueue, RunsTasksInPostingOrder) {
+  ContextTaskQueue queue(nullptr);
+  std::vector<int> order;
+  for (int i = 0; i < 5; ++i) {
+    queue.Post([&order, i]() { order.push_back(i); });
+  }
+  EXPECT_TRUE(order.empty());
+
+  RunUntil([&order]() { return order.size() == 5; });
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), order);
+}
+
+TEST(ContextTaskQueue, TasksPostedFromTasksRunLater) {
+  ContextTaskQueue queue(nullptr);
+  int runs = 0;
+  queue.Post([&queue, &runs]() {
+    ++runs;
+    queue.Post([&runs]() { ++runs; });
+  });
+
+  EXPECT_EQ(1u, queue.RunPendingTasks());
+  EXPECT_EQ(1, runs);
+  RunUntil([&runs]() { return runs == 2; });
+}
+
+TEST(ContextTaskQueue, PostFromManyThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kTasksPerThread = 1000;
+
+  ContextTaskQueue queue(nullptr);
+  std::vector<int> last_seen(kThreads, -1);
+  std::atomic<bool> in_order{true};
+  int runs = 0;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kTasksPerThread; ++i) {
+        queue.Post([&, t, i]() {
+          // Tasks of one producer keep their order
+          if (last_seen[t] != i - 1) {
+            in_order = false;
+          }
+          last_seen[t] = i;
+          ++runs;
+        });
+      }
+    });
+  }
+
+  RunUntil([&runs]() { return runs == kThreads * kTasksPerThread; });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(in_order);
+}
+
+TEST(ContextTaskQueue, PendingTasksAreDroppedWithQueue) {
+  int runs = 0;
+  {
+    ContextTaskQueue queue(nullptr);
+    queue.Post([&runs]() { ++runs; });
+  }
+  while (g_main_context_iteration(nullptr, FALSE)) {
+  }
+  EXPECT_EQ(0, runs);
+}
+
+// Not run by default: --gtest_also_run_disabled_tests --gtest_filter=*Bench*
+//
+// How long an input event waits on the main loop during a storm of bus
+// calls, when the calls are dispatched on the main loop and when only their
+// handlers are, the way PalmServiceBase splits them on the bus thread
+TEST(ContextTaskQueue, DISABLED_BenchmarkInputLatencyDuringBusStorm) {
+  static constexpr int kCalls = 20000;
+  static constexpr int kCallsPerInput = 200;
+
+  Json::Value request;
+  for (int i = 0; i < 40; ++i) {
+    request["key" + std::to_string(i)] = "value of a bus request " +
+                                          std::to_string(i);
+  }
+  const std::string payload = util::JsonToString(request);
+  auto handler = [](const Json::Value& parsed) {
+    Json::Value reply = parsed;
+    reply["returnValue"] = true;
+    return reply;
+  };
+
+  auto measure = [&](const char* name, bool bus_thread) {
+    GMainContext* bus_context = g_main_context_new();
+    GMainLoop* bus_loop = g_main_loop_new(bus_context, FALSE);
+    ContextTaskQueue main_tasks(nullptr);
+    ContextTaskQueue bus_tasks(bus_context);
+    std::thread bus([bus_context, bus_loop]() {
+      g_main_context_push_thread_default(bus_context);
+      g_main_loop_run(bus_loop);
+      g_main_context_pop_thread_default(bus_context);
+    });
+
+    std::atomic<int> replied{0};
+    std::vector<std::chrono::microseconds> latencies;
+    auto call = [&]() {
+      Json::Value parsed;
+      util::StringToJson(payload, parsed);
+      if (!bus_thread) {
+        util::JsonToString(handler(parsed)).size();
+        ++replied;
+        return;
+      }
+      main_tasks.Post([&, parsed = std::move(parsed)]() {
+        Json::Value reply = handler(parsed);
+        bus_tasks.Post([&, reply = std::move(reply)]() {
+          util::JsonToString(reply).size();
+          ++replied;
+        });
+      });
+    };
+
+    // Calls come in from the bus as fast as they can be queued, with an
+    // input event posted to the main loop every kCallsPerInput of them
+    ContextTaskQueue& incoming = bus_thread ? bus_tasks : main_tasks;
+    std::thread producer([&]() {
+      for (int i = 0; i < kCalls; ++i) {
+        incoming.Post(call);
+        if (i % kCallsPerInput) {
+          continue;
+        }
+        auto posted = std::chrono::steady_clock::now();
+        main_tasks.Post([&latencies, posted]() {
+          latencies.push_back(
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - posted));
+        });
+      }
+    });
+    RunUntil([&]() {
+      return replied == kCalls &&
+             latencies.size() == kCalls / kCallsPerInput;
+    });
+    producer.join();
+
+    bus_tasks.Post([bus_loop]() { g_main_loop_quit(bus_loop); });
+    bus.join();
+    g_main_loop_unref(bus_loop);
+    g_main_context_unref(bus_context);
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << name << ": input latency median "
+              << latencies[latencies.size() / 2].count() << " us, max "
+              << latencies.back().count() << " us over " << kCalls
+              << " calls" << std::endl;
+  };
+
+  measure("main loop dispatch", false);
+  measure("bus thread dispatch", true);
+}
@@ -95,3 +95,45 @@ TEST_F(DeviceInfoTest, checkDisplayHeight) {
   ASSERT_TRUE(device_info_.GetDisplayHeight(actual_value));
   EXPECT_EQ(expected_value2, actual_value);
 }
+
+TEST_F(DeviceInfoTest, checkSnapshotIsReplacedOnChange) {
+  std::shared_ptr<const DeviceSnapshot> initial = device_info_.Snapshot();
+  ASSERT_TRUE(initial);
+  EXPECT_EQ(0, initial->display_width);
+
+  device_info_.SetDisplayWidth(1920);
+  device_info_.SetDisplayHeight(1080);
+  device_info_.SetSystemLanguage("en-US");
+  device_info_.SetDeviceInfo("FirmwareVersion", "05.10.20");
+
+  std::shared_ptr<const DeviceSnapshot> snapshot = device_info_.Snapshot();
+  EXPECT_EQ(1920, snapshot->display_width);
+  EXPECT_EQ(1080, snapshot->display_height);
+  EXPECT_EQ("en-US", snapshot->system_language);
+  EXPECT_EQ(5, snapshot->platform_version_major);
+  EXPECT_EQ(10, snapshot->platform_version_minor);
+  EXPECT_EQ(20, snapshot->platform_version_dot);
+
+  // Handles taken earlier keep their values
+  EXPECT_EQ(0, initial->display_width);
+  EXPECT_TRUE(initial->system_language.empty());
+
+  // Keys which are not part of the snapshot do not replace it
+  device_info_.SetDeviceInfo("SomethingElse", "value");
+  EXPECT_EQ(snapshot, device_info_.Snapshot());
+}
+
+TEST_F(DeviceInfoTest, checkSnapshotDevicePixelRatio) {
+  device_info_.SetDisplayWidth(1920);
+  device_info_.SetDisplayHeight(1080);
+  EXPECT_FALSE(device_info_.Snapshot()->HasHardwareResolution());
+  EXPECT_FLOAT_EQ(1.5f, device_info_.Snapshot()->DevicePixelRatio(1280, 720));
+
+  device_info_.SetDeviceInfo("HardwareScreenWidth", "3840");
+  device_info_.SetDeviceInfo("HardwareScreenHeight", "2160");
+  std::shared_ptr<const DeviceSnapshot> snapshot = device_info_.Snapshot();
+  EXPECT_TRUE(snapshot->HasHardwareResolution());
+  EXPECT_FLOAT_EQ(3.0f, snapshot->DevicePixelRatio(1280, 720));
+  EXPECT_FLOAT_EQ(2.0f, snapshot->DevicePixelRatio(1920, 1080));
+  EXPECT_FLOAT_EQ(1.0f, snapshot->DevicePixelRatio(0, 0));
+}
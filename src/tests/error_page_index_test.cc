@@ -0,0 +1,135 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "error_page_index.h"
+
+namespace fs = std::filesystem;
+
+class ErrorPageIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string pattern =
+        (fs::temp_directory_path() / "error_page_index_XXXXXX").string();
+    ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+    root_ = pattern;
+    error_page_ = (root_ / "loaderror.html").string();
+  }
+
+  void TearDown() override {
+    std::error_code ec;
+    fs::remove_all(root_, ec);
+  }
+
+  std::string AddPage(const std::string& localization) {
+    fs::path dir = root_;
+    if (localization != ".") {
+      dir /= "resources";
+      if (!localization.empty()) {
+        dir /= localization;
+      }
+      dir /= "html";
+    }
+    fs::create_directories(dir);
+    fs::path page = dir / "loaderror.html";
+    std::ofstream(page.string()) << "<html></html>";
+    return page.string();
+  }
+
+  fs::path root_;
+  std::string error_page_;
+};
+
+TEST_F(ErrorPageIndexTest, ResolvesTheMostSpecificLocalization) {
+  AddPage(".");
+  const std::string generic = AddPage("");
+  const std::string en = AddPage("en");
+  const std::string zh_hant_hk = AddPage("zh/Hant/HK");
+  const std::string es_es = AddPage("es/ES");
+
+  ErrorPageIndex index;
+  index.SetErrorPage(error_page_);
+  EXPECT_EQ(index.Resolve("en-US"), en);
+  EXPECT_EQ(index.Resolve("zh-Hant-HK"), zh_hant_hk);
+  EXPECT_EQ(index.Resolve("zh-Hant-TW"), generic);
+  EXPECT_EQ(index.Resolve("es-ES"), es_es);
+  EXPECT_EQ(index.Resolve("es"), generic);
+  EXPECT_EQ(index.Resolve(""), generic);
+  EXPECT_EQ(index.AvailableCount(), 5u);
+}
+
+TEST_F(ErrorPageIndexTest, MatchesPagesOfNonNormalizedErrorPagePath) {
+  AddPage(".");
+  const std::string generic = AddPage("");
+  const std::string en = AddPage("en");
+
+  ErrorPageIndex index;
+  index.SetErrorPage(root_.string() + "//./resources/../loaderror.html");
+  EXPECT_EQ(index.Resolve("en-US"), en);
+  EXPECT_EQ(index.Resolve("ko-KR"), generic);
+}
+
+TEST_F(ErrorPageIndexTest, FallsBackToTheErrorPageItself) {
+  AddPage(".");
+
+  ErrorPageIndex index;
+  index.SetErrorPage(error_page_);
+  EXPECT_EQ(index.Resolve("ko-KR"), error_page_);
+}
+
+TEST_F(ErrorPageIndexTest, IgnoresFilesOutsideHtmlDirectories) {
+  fs::create_directories(root_ / "resources" / "en");
+  std::ofstream((root_ / "resources" / "en" / "loaderror.html").string());
+  fs::create_directories(root_ / "resources" / "ko" / "html" /
+                         "loaderror.html");
+
+  ErrorPageIndex index;
+  index.SetErrorPage(error_page_);
+  EXPECT_EQ(index.Resolve("en"), std::string());
+  EXPECT_EQ(index.Resolve("ko"), std::string());
+}
+
+TEST_F(ErrorPageIndexTest, KeepsResolvedPagesUntilInvalidated) {
+  const std::string generic = AddPage("");
+
+  ErrorPageIndex index;
+  index.SetErrorPage(error_page_);
+  EXPECT_EQ(index.Resolve("ko-KR"), generic);
+
+  // Not looked up again for a known language
+  const std::string ko = AddPage("ko");
+  EXPECT_EQ(index.Resolve("ko-KR"), generic);
+
+  index.Invalidate();
+  EXPECT_EQ(index.Resolve("ko-KR"), ko);
+}
+
+TEST_F(ErrorPageIndexTest, NoErrorPage) {
+  AddPage("");
+
+  ErrorPageIndex index;
+  EXPECT_EQ(index.Resolve("en-US"), std::string());
+  EXPECT_EQ(index.AvailableCount(), 0u);
+
+  index.SetErrorPage(error_page_);
+  EXPECT_NE(index.Resolve("en-US"), std::string());
+}
@@ -182,13 +182,62 @@ TEST_F(ErrorPageTestSuite, ReloadOnNetworkRecovery) {
   SetExpectedLoadUrlRequests();
   ASSERT_NE(web_view_delegate_, nullptr);
   auto view_mock = mock_initializer_->GetWebViewMock();
+  GMainLoop* loop = g_main_loop_new(nullptr, FALSE);
+  // The reload is issued by the network reload scheduler from the main loop
   EXPECT_CALL(*view_mock, LoadUrl(app_url_))
-      .WillOnce(testing::Invoke(
-          [this](const std::string& url) { ProcessLoading(url); }));
+      .WillOnce(testing::Invoke([=](const std::string& url) {
+        ProcessLoading(url);
+        g_main_loop_quit(loop);
+      }));
+  guint id = g_timeout_add(5000, OnTimeoutFail, loop);
   web_view_delegate_->LoadFailed(app_url_, 404, {});
   Json::Value status;
   status["isInternetConnectionAvailable"] = true;
   WebAppManager::Instance()->UpdateNetworkStatus(status);
+  g_main_loop_run(loop);
+  if (!timeout_exceeded_) {
+    g_source_remove(id);
+  }
+  EXPECT_FALSE(timeout_exceeded_);
+  g_main_loop_unref(loop);
+}
+
+TEST_F(ErrorPageTestSuite, ReloadOnEveryNetworkRecovery) {
+  ASSERT_NE(web_view_delegate_, nullptr);
+  auto view_mock = mock_initializer_->GetWebViewMock();
+  EXPECT_CALL(
+      *view_mock,
+      LoadUrl(::testing::HasSubstr("loaderror.html?errorCode=404&failedUrl")))
+      .Times(2)
+      .WillRepeatedly(testing::Invoke(
+          [this](const std::string& url) { ProcessLoading(url); }));
+  EXPECT_CALL(*view_mock, LoadUrl(std::string("about:blank")))
+      .Times(2)
+      .WillRepeatedly(testing::Invoke(
+          [this](const std::string& url) { ProcessLoading(url); }));
+  GMainLoop* loop = g_main_loop_new(nullptr, FALSE);
+  EXPECT_CALL(*view_mock, LoadUrl(app_url_))
+      .Times(2)
+      .WillRepeatedly(testing::Invoke([=](const std::string& url) {
+        ProcessLoading(url);
+        g_main_loop_quit(loop);
+      }));
+  guint id = g_timeout_add(10000, OnTimeoutFail, loop);
+
+  // The same connected status twice: the second event changes nothing but
+  // still retries the page which failed again
+  Json::Value status;
+  status["isInternetConnectionAvailable"] = true;
+  for (int i = 0; i < 2; ++i) {
+    web_view_delegate_->LoadFailed(app_url_, 404, {});
+    WebAppManager::Instance()->UpdateNetworkStatus(status);
+    g_main_loop_run(loop);
+  }
+  if (!timeout_exceeded_) {
+    g_source_remove(id);
+  }
+  EXPECT_FALSE(timeout_exceeded_);
+  g_main_loop_unref(loop);
 }
 
 TEST_F(ErrorPageTestSuite, ReloadOnTimeout) {
@@ -0,0 +1,181 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "file_contents.h"
+#include "utils.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// What util::ReadFile() used to do
+std::string LegacyReadFile(const std::string& path) {
+  if (!util::DoesPathExist(path)) {
+    return std::string();
+  }
+
+  std::ifstream file(path);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+std::string Pattern(size_t size) {
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<char>('a' + i % 23);
+  }
+  return data;
+}
+
+}  // namespace
+
+class FileContentsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string pattern =
+        (fs::temp_directory_path() / "file_contents_XXXXXX").string();
+    ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+    root_ = pattern;
+  }
+
+  void TearDown() override {
+    std::error_code ec;
+    fs::remove_all(root_, ec);
+  }
+
+  std::string Write(const std::string& name, const std::string& data) {
+    std::string path = (root_ / name).string();
+    std::ofstream(path, std::ios::binary) << data;
+    return path;
+  }
+
+  fs::path root_;
+};
+
+TEST_F(FileContentsTest, ReadsSmallFiles) {
+  const std::string data = Pattern(1000);
+  auto contents = FileContents::Read(Write("small", data));
+  ASSERT_TRUE(contents);
+  EXPECT_FALSE(contents->IsMapped());
+  EXPECT_EQ(contents->View(), data);
+}
+
+TEST_F(FileContentsTest, MapsLargeFiles) {
+  const std::string data = Pattern(FileContents::kMapThreshold + 1);
+  auto contents = FileContents::Read(Write("large", data));
+  ASSERT_TRUE(contents);
+  EXPECT_TRUE(contents->IsMapped());
+  EXPECT_EQ(contents->View(), data);
+
+  // Shared, not copied
+  auto copy = contents;
+  contents.reset();
+  EXPECT_EQ(copy->View(), data);
+}
+
+TEST_F(FileContentsTest, ReadsFilesOfUnknownSize) {
+  auto contents = FileContents::Read("/proc/self/status");
+  ASSERT_TRUE(contents);
+  EXPECT_NE(contents->View().find("Pid:"), std::string_view::npos);
+
+  std::string out;
+  EXPECT_TRUE(util::ReadFileToString("/proc/self/status", out));
+  EXPECT_NE(out.find("Pid:"), std::string::npos);
+}
+
+TEST_F(FileContentsTest, EmptyFile) {
+  auto contents = FileContents::Read(Write("empty", ""));
+  ASSERT_TRUE(contents);
+  EXPECT_TRUE(contents->View().empty());
+}
+
+TEST_F(FileContentsTest, ReportsErrors) {
+  int error = 0;
+  EXPECT_FALSE(FileContents::Read((root_ / "missing").string(), &error));
+  EXPECT_EQ(error, ENOENT);
+
+  error = 0;
+  EXPECT_FALSE(FileContents::Read(root_.string(), &error));
+  EXPECT_EQ(error, EISDIR);
+
+  std::string out = "stale";
+  error = 0;
+  EXPECT_FALSE(util::ReadFileToString("", out, &error));
+  EXPECT_EQ(error, ENOENT);
+  EXPECT_TRUE(out.empty());
+}
+
+TEST_F(FileContentsTest, ReadFileMatchesLegacy) {
+  for (size_t size : {0, 1, 4095, 4096, 4097, 300000}) {
+    const std::string path = Write("file", Pattern(size));
+    EXPECT_EQ(util::ReadFile(path), LegacyReadFile(path)) << size;
+  }
+  EXPECT_EQ(util::ReadFile((root_ / "missing").string()), std::string());
+  EXPECT_EQ(util::ReadFile(root_.string()), std::string());
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST_F(FileContentsTest, DISABLED_Benchmark) {
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+
+  for (size_t size : {1024, 16 * 1024, 256 * 1024, 1024 * 1024,
+                      16 * 1024 * 1024}) {
+    const std::string path = Write("bench", Pattern(size));
+    const int iterations = static_cast<int>(
+        std::max<size_t>(10, 64 * 1024 * 1024 / size));
+    size_t sink = 0;
+
+    auto start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      sink += LegacyReadFile(path).size();
+    }
+    auto legacy = steady_clock::now() - start;
+
+    start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      sink += util::ReadFile(path).size();
+    }
+    auto read = steady_clock::now() - start;
+
+    start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      sink += FileContents::Read(path)->size();
+    }
+    auto contents = steady_clock::now() - start;
+
+    auto per_call = [iterations](steady_clock::duration duration) {
+      return std::chrono::duration<double, std::micro>(duration).count() /
+             iterations;
+    };
+    printf("%8zu bytes: legacy %9.1f us, ReadFile %9.1f us, "
+           "FileContents %9.1f us (%zu)\n",
+           size, per_call(legacy), per_call(read), per_call(contents), sink);
+  }
+}
@@ -20,6 +20,7 @@
 
 #include "base_mock_initializer.h"
 #include "blink_web_process_manager_mock.h"
+#include "json_writer.h"
 #include "platform_module_factory_impl_mock.h"
 #include "utils.h"
 #include "web_app_manager_service_luna.h"
@@ -85,15 +86,24 @@ constexpr char kLaunchAppJsonBody[] = R"({
   "instanceId": "de90e74a-b86b-42c8-8785-3efd927a36430"
 })";
 
+Json::Value GetWebProcessSize() {
+  JsonWriter writer;
+  writer.BeginObject();
+  WebAppManagerServiceLuna::Instance()->getWebProcessSize(
+      Json::Value(Json::objectValue), &writer);
+  writer.EndObject();
+
+  Json::Value reply;
+  EXPECT_TRUE(util::StringToJson(writer.str(), reply)) << writer.str();
+  return reply;
+}
+
 }  // namespace
 
 TEST(GetWebProcessSizeTest, checkCaseProcessNotExists) {
   BaseMockInitializer<> mock_initializer;
 
-  const Json::Value request_process_size(Json::objectValue);
-  WebAppManagerServiceLuna* luna_service = WebAppManagerServiceLuna::Instance();
-  const auto response_process_size =
-      luna_service->getWebProcessSize(request_process_size);
+  const auto response_process_size = GetWebProcessSize();
 
   ASSERT_TRUE(response_process_size.isObject());
   ASSERT_TRUE(response_process_size.isMember("returnValue"));
@@ -126,9 +136,7 @@ TEST(GetWebProcessSizeTest, checkCaseProcessExists) {
   EXPECT_CALL(*process_manager, GetWebProcessMemSize(kProcessId))
       .WillRepeatedly(testing::Return(kProcessMemSize));
 
-  const Json::Value request_process_size(Json::objectValue);
-  const auto response_process_size =
-      luna_service->getWebProcessSize(request_process_size);
+  const auto response_process_size = GetWebProcessSize();
 
   ASSERT_TRUE(response_process_size.isObject());
   ASSERT_TRUE(response_process_size.isMember("returnValue"));
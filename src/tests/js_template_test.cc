@@ -0,0 +1,161 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "js_template.h"
+#include "utils.h"
+
+namespace {
+
+// The escaping WebPageBlink::EscapeData() used to do
+std::string LegacyEscape(const std::string& value) {
+  std::string escaped_value = value;
+  util::ReplaceSubstr(escaped_value, "\\", "\\\\");
+  util::ReplaceSubstr(escaped_value, "'", "\\'");
+  util::ReplaceSubstr(escaped_value, "\n", "\\n");
+  util::ReplaceSubstr(escaped_value, "\r", "\\r");
+  return escaped_value;
+}
+
+std::string RandomString(std::mt19937& random, size_t max_size) {
+  static const char kAlphabet[] = "ab \\'\n\r\"$\xc3\xa9{}";
+  std::uniform_int_distribution<size_t> size(0, max_size);
+  std::uniform_int_distribution<size_t> index(0, sizeof(kAlphabet) - 2);
+  // Mostly plain runs, so that both the bulk and the tail paths are hit
+  std::bernoulli_distribution plain(0.9);
+  std::string value(size(random), 'x');
+  for (char& c : value) {
+    if (!plain(random)) {
+      c = kAlphabet[index(random)];
+    }
+  }
+  return value;
+}
+
+}  // namespace
+
+TEST(JsTemplateTest, EscapesLikeTheLegacyEscaper) {
+  std::mt19937 random(20211104);
+  for (int i = 0; i < 5000; ++i) {
+    std::string value = RandomString(random, 80);
+    ASSERT_EQ(EscapeJsString(value), LegacyEscape(value)) << value;
+  }
+}
+
+TEST(JsTemplateTest, Escape) {
+  EXPECT_EQ(EscapeJsString(""), "");
+  EXPECT_EQ(EscapeJsString("it's"), "it\\'s");
+  EXPECT_EQ(EscapeJsString("a\\b\r\n"), "a\\\\b\\r\\n");
+  EXPECT_EQ(EscapeJsString("\"\xea\xb0\x80\""), "\"\xea\xb0\x80\"");
+
+  std::string out = "x";
+  AppendEscapedJsString(out, "'");
+  EXPECT_EQ(out, "x\\'");
+}
+
+TEST(JsTemplateTest, Render) {
+  JsTemplate event("new CustomEvent($'0, { detail: $1 });");
+  EXPECT_EQ(event.SlotCount(), 2u);
+  EXPECT_EQ(event.Render({"webOSRelaunch", "{\"a\":1}"}),
+            "new CustomEvent('webOSRelaunch', { detail: {\"a\":1} });");
+  EXPECT_EQ(event.Render({"it's", "{}"}),
+            "new CustomEvent('it\\'s', { detail: {} });");
+}
+
+TEST(JsTemplateTest, RepeatedAndMissingArguments) {
+  JsTemplate repeated("$0 $0 $'0 $1");
+  EXPECT_EQ(repeated.Render({"true"}), "true true 'true' ");
+  EXPECT_EQ(repeated.Render({}), "   ");
+}
+
+TEST(JsTemplateTest, Dollars) {
+  EXPECT_EQ(JsTemplate("$$0").Render({"x"}), "$0");
+  EXPECT_EQ(JsTemplate("$a $' $").Render({"x"}), "$a $' $");
+  EXPECT_EQ(JsTemplate("").Render({"x"}), "");
+  EXPECT_EQ(JsTemplate("$0").Render({"$1"}), "$1");
+}
+
+TEST(JsTemplateTest, RenderReplacesTheBuffer) {
+  JsTemplate script("f($0);");
+  std::string buffer = "something longer than the script";
+  script.Render(buffer, {"1"});
+  EXPECT_EQ(buffer, "f(1);");
+}
+
+// Relaunch event with large launch parameters and injection data update
+// with a large value, against the stringstream and four pass versions.
+// Run with --gtest_also_run_disabled_tests.
+TEST(JsTemplateTest, DISABLED_Benchmark) {
+  const int kIterations = 200;
+  std::mt19937 random(7);
+  std::string params = "{\"data\":\"";
+  while (params.size() < 1024 * 1024) {
+    params += RandomString(random, 64);
+  }
+  params += "\"}";
+  std::string value = RandomString(random, 1024 * 1024);
+
+  size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    std::stringstream relaunch_event;
+    relaunch_event << "setTimeout(function () {"
+                   << "    var launchEvent=new CustomEvent('webOSRelaunch', "
+                   << "{ detail: " << params << " });"
+                   << "    document.dispatchEvent(launchEvent);"
+                   << "}, 1);";
+    sink += relaunch_event.str().size();
+    std::string update = "webOSSystem.updateInjectionData('" +
+                         LegacyEscape("key") + "', '" + LegacyEscape(value) +
+                         "');";
+    sink += update.size();
+  }
+  auto legacy = std::chrono::steady_clock::now() - start;
+
+  static const JsTemplate kRelaunchEvent(
+      "setTimeout(function () {"
+      "    var launchEvent=new CustomEvent('webOSRelaunch', "
+      "{ detail: $0 });"
+      "    document.dispatchEvent(launchEvent);"
+      "}, 1);");
+  static const JsTemplate kUpdate("webOSSystem.updateInjectionData($'0, $'1);");
+  std::string buffer;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    kRelaunchEvent.Render(buffer, {params});
+    sink += buffer.size();
+    kUpdate.Render(buffer, {"key", value});
+    sink += buffer.size();
+  }
+  auto rendered = std::chrono::steady_clock::now() - start;
+
+  using std::chrono::microseconds;
+  printf("legacy: %lld us, template: %lld us per iteration (%zu)\n",
+         static_cast<long long>(
+             std::chrono::duration_cast<microseconds>(legacy).count() /
+             kIterations),
+         static_cast<long long>(
+             std::chrono::duration_cast<microseconds>(rendered).count() /
+             kIterations),
+         sink);
+}
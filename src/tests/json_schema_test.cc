@@ -0,0 +1,193 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "json_schema.h"
+#include "utils.h"
+
+namespace {
+
+using Type = JsonSchema::Type;
+
+const JsonSchema& LaunchAppSchema() {
+  static const JsonSchema schema({{"appDesc.id", Type::kString, true},
+                                  {"parameters", Type::kObject, false},
+                                  {"launchingAppId", Type::kString, false},
+                                  {"instanceId", Type::kString, true}});
+  return schema;
+}
+
+// launchApp's check before schemas, kept to compare against
+bool LegacyValidateLaunchApp(const Json::Value& request) {
+  return !(
+      !request.isObject() ||
+      (!request.isMember("appDesc") || !request["appDesc"].isObject() ||
+       !request["appDesc"]["id"].isString()) ||
+      (request.isMember("parameters") && !request["parameters"].isObject()) ||
+      (request.isMember("launchingAppId") &&
+       !request["launchingAppId"].isString()) ||
+      (!request.isMember("instanceId") || !request["instanceId"].isString()));
+}
+
+bool Validate(const JsonSchema& schema,
+              const std::string& payload,
+              std::string* error = nullptr) {
+  Json::Value request;
+  if (!util::StringToJson(payload, request)) {
+    return false;
+  }
+  return schema.Validate(request, error);
+}
+
+}  // namespace
+
+TEST(JsonSchema, ImpliedObjectsAreCompiledOnce) {
+  // "appDesc" is implied by "appDesc.id"
+  EXPECT_EQ(5u, LaunchAppSchema().StepCount());
+
+  JsonSchema schema({{"a.b", Type::kString, false},
+                     {"a.c", Type::kInt, true},
+                     {"a", Type::kObject, false}});
+  EXPECT_EQ(3u, schema.StepCount());
+  // "a" was declared optional explicitly, so it may be left out
+  EXPECT_TRUE(Validate(schema, R"({})"));
+  EXPECT_FALSE(Validate(schema, R"({"a": {}})"));
+  EXPECT_TRUE(Validate(schema, R"({"a": {"c": 1}})"));
+}
+
+TEST(JsonSchema, AcceptsValidRequest) {
+  EXPECT_TRUE(Validate(LaunchAppSchema(),
+                       R"({"appDesc": {"id": "com.webos.app.test"},
+                           "parameters": {"a": 1},
+                           "instanceId": "100"})"));
+  EXPECT_TRUE(Validate(LaunchAppSchema(),
+                       R"({"appDesc": {"id": "com.webos.app.test"},
+                           "instanceId": "100", "unknown": []})"));
+}
+
+TEST(JsonSchema, ReportsMissingMember) {
+  std::string error;
+  EXPECT_FALSE(Validate(LaunchAppSchema(), R"({"instanceId": "100"})", &error));
+  EXPECT_EQ("missing required parameter 'appDesc'", error);
+
+  EXPECT_FALSE(Validate(LaunchAppSchema(),
+                        R"({"appDesc": {}, "instanceId": "100"})", &error));
+  EXPECT_EQ("missing required parameter 'appDesc.id'", error);
+
+  EXPECT_FALSE(Validate(LaunchAppSchema(),
+                        R"({"appDesc": {"id": "com.webos.app.test"}})",
+                        &error));
+  EXPECT_EQ("missing required parameter 'instanceId'", error);
+}
+
+TEST(JsonSchema, ReportsWrongType) {
+  std::string error;
+  EXPECT_FALSE(Validate(LaunchAppSchema(),
+                        R"({"appDesc": {"id": 1}, "instanceId": "100"})",
+                        &error));
+  EXPECT_EQ("parameter 'appDesc.id' must be string", error);
+
+  EXPECT_FALSE(Validate(LaunchAppSchema(),
+                        R"({"appDesc": "com.webos.app.test",
+                            "instanceId": "100"})",
+                        &error));
+  EXPECT_EQ("parameter 'appDesc' must be object", error);
+
+  EXPECT_FALSE(Validate(LaunchAppSchema(),
+                        R"({"appDesc": {"id": "com.webos.app.test"},
+                            "parameters": null, "instanceId": "100"})",
+                        &error));
+  EXPECT_EQ("parameter 'parameters' must be object", error);
+}
+
+TEST(JsonSchema, RejectsNonObjectRequest) {
+  std::string error;
+  EXPECT_FALSE(LaunchAppSchema().Validate(Json::Value("string"), &error));
+  EXPECT_EQ("request must be an object", error);
+  EXPECT_FALSE(JsonSchema().Validate(Json::Value(Json::arrayValue)));
+  EXPECT_TRUE(JsonSchema().Validate(Json::Value(Json::objectValue)));
+}
+
+TEST(JsonSchema, LimitsStringsToAllowedValues) {
+  JsonSchema schema({{"replyOn", Type::kString, false, "launch|firstFrame"}});
+  EXPECT_TRUE(Validate(schema, R"({})"));
+  EXPECT_TRUE(Validate(schema, R"({"replyOn": "launch"})"));
+  EXPECT_TRUE(Validate(schema, R"({"replyOn": "firstFrame"})"));
+
+  std::string error;
+  EXPECT_FALSE(Validate(schema, R"({"replyOn": "first"})", &error));
+  EXPECT_EQ("parameter 'replyOn' must be one of launch|firstFrame", error);
+  EXPECT_FALSE(Validate(schema, R"({"replyOn": 1})", &error));
+  EXPECT_EQ("parameter 'replyOn' must be string", error);
+}
+
+TEST(JsonSchema, MembersOfNonObjectParentAreSkipped) {
+  JsonSchema schema({{"a", Type::kAny, false}, {"a.b", Type::kString, true}});
+  EXPECT_TRUE(Validate(schema, R"({"a": 1})"));
+  EXPECT_FALSE(Validate(schema, R"({"a": {}})"));
+}
+
+// Not run by default: --gtest_also_run_disabled_tests --gtest_filter=*Bench*
+TEST(JsonSchema, DISABLED_BenchmarkValidate) {
+  std::vector<Json::Value> requests;
+  for (const char* payload :
+       {R"({"appDesc": {"id": "com.webos.app.test", "title": "Test",
+            "main": "index.html", "trustLevel": "default"},
+            "parameters": {"displayAffinity": 0}, "launchingAppId": "home",
+            "launchingProcId": "", "instanceId": "100"})",
+        R"({"appDesc": {"id": "com.webos.app.test"}, "instanceId": 100})",
+        R"({"instanceId": "100"})"}) {
+    Json::Value request;
+    ASSERT_TRUE(util::StringToJson(payload, request));
+    requests.push_back(request);
+  }
+  ASSERT_EQ(LegacyValidateLaunchApp(requests[0]),
+            LaunchAppSchema().Validate(requests[0]));
+
+  auto measure = [&requests](const char* name, auto&& validate) {
+    constexpr int kRounds = 100000;
+    auto start = std::chrono::steady_clock::now();
+    size_t valid = 0;
+    for (int round = 0; round < kRounds; ++round) {
+      for (const Json::Value& request : requests) {
+        valid += validate(request);
+      }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << name << ": "
+              << elapsed.count() / (kRounds * requests.size())
+              << " ns per request (" << valid << " valid)" << std::endl;
+  };
+
+  measure("JsonSchema", [](const Json::Value& request) {
+    return LaunchAppSchema().Validate(request);
+  });
+  measure("JsonSchema with error", [](const Json::Value& request) {
+    std::string error;
+    return LaunchAppSchema().Validate(request, &error);
+  });
+  measure("Legacy isMember chain", [](const Json::Value& request) {
+    return LegacyValidateLaunchApp(request);
+  });
+}
@@ -0,0 +1,281 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "json_writer.h"
+#include "utils.h"
+
+namespace {
+
+Json::Value Parse(const JsonWriter& writer) {
+  Json::Value value;
+  EXPECT_TRUE(util::StringToJson(writer.str(), value)) << writer.str();
+  return value;
+}
+
+}  // namespace
+
+TEST(JsonWriter, WritesCompactNestedStructures) {
+  JsonWriter writer;
+  writer.BeginObject()
+      .Key("running")
+      .BeginArray()
+      .BeginObject()
+      .Key("id")
+      .String("bareapp")
+      .Key("pid")
+      .Int(42)
+      .EndObject()
+      .BeginArray()
+      .EndArray()
+      .BeginObject()
+      .EndObject()
+      .EndArray()
+      .Key("returnValue")
+      .Bool(true)
+      .Key("nothing")
+      .Null()
+      .EndObject();
+
+  EXPECT_TRUE(writer.IsComplete());
+  EXPECT_EQ(
+      R"({"running":[{"id":"bareapp","pid":42},[],{}],)"
+      R"("returnValue":true,"nothing":null})",
+      writer.str());
+}
+
+TEST(JsonWriter, EscapesStrings) {
+  std::string all_ascii;
+  for (int c = 1; c < 128; ++c) {
+    all_ascii += static_cast<char>(c);
+  }
+  all_ascii += std::string(1, '\0') + "end";
+  const std::string utf8 = "\xec\x95\x88\xeb\x85\x95 \xe2\x82\xac";
+
+  JsonWriter writer;
+  writer.BeginObject()
+      .Key(all_ascii)
+      .String(all_ascii)
+      .Key("utf8")
+      .String(utf8)
+      .EndObject();
+
+  const Json::Value value = Parse(writer);
+  EXPECT_EQ(all_ascii, value[all_ascii].asString());
+  EXPECT_EQ(utf8, value["utf8"].asString());
+  // UTF-8 is not turned into \u escapes
+  EXPECT_NE(std::string::npos, writer.str().find(utf8));
+
+  writer.Clear();
+  writer.String("a\"b\\c\nd\x01");
+  EXPECT_EQ(R"("a\"b\\c\nd\u0001")", writer.str());
+}
+
+TEST(JsonWriter, WritesNumbers) {
+  JsonWriter writer;
+  writer.BeginArray()
+      .Int(std::numeric_limits<int64_t>::min())
+      .Int(std::numeric_limits<int64_t>::max())
+      .Uint(std::numeric_limits<uint64_t>::max())
+      .Double(0.1)
+      .Double(-2.5e300)
+      .Double(std::numeric_limits<double>::infinity())
+      .EndArray();
+
+  const Json::Value value = Parse(writer);
+  ASSERT_EQ(6u, value.size());
+  EXPECT_EQ(std::numeric_limits<int64_t>::min(), value[0].asInt64());
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), value[1].asInt64());
+  EXPECT_EQ(std::numeric_limits<uint64_t>::max(), value[2].asUInt64());
+  EXPECT_EQ(0.1, value[3].asDouble());
+  EXPECT_EQ(-2.5e300, value[4].asDouble());
+  EXPECT_TRUE(value[5].isNull());
+}
+
+TEST(JsonWriter, EmbedsJsonValues) {
+  Json::Value tree;
+  ASSERT_TRUE(util::StringToJson(
+      R"({"id": "com.webos.app.home", "trustLevel": "default",
+          "list": [1, -2, 3.5, true, null, "\u0007"],
+          "nested": {"deeper": {"empty": {}, "none": []}}})",
+      tree));
+
+  JsonWriter writer;
+  writer.BeginObject().Key("appDesc").Value(tree).EndObject();
+
+  EXPECT_EQ(tree, Parse(writer)["appDesc"]);
+}
+
+TEST(JsonWriter, ClearKeepsBuffer) {
+  JsonWriter writer;
+  writer.BeginArray();
+  for (int i = 0; i < 1000; ++i) {
+    writer.String("some longer element to grow the buffer");
+  }
+  writer.EndArray();
+  const size_t capacity = writer.str().capacity();
+
+  writer.Clear();
+  EXPECT_FALSE(writer.IsComplete());
+  EXPECT_EQ(0u, writer.size());
+  EXPECT_EQ(capacity, writer.str().capacity());
+
+  writer.BeginObject().Key("returnValue").Bool(false).EndObject();
+  EXPECT_EQ(R"({"returnValue":false})", writer.str());
+}
+
+// Not run by default: --gtest_also_run_disabled_tests --gtest_filter=*Bench*
+TEST(JsonWriter, DISABLED_Benchmark) {
+  // listRunningApps and getWebProcessSize with 100 apps in 10 processes
+  struct App {
+    std::string id;
+    std::string instance_id;
+    int pid;
+  };
+  std::vector<App> apps;
+  for (int i = 0; i < 100; ++i) {
+    apps.push_back({"com.webos.app.test" + std::to_string(i),
+                    "instance-" + std::to_string(1000 + i), 2000 + i % 10});
+  }
+
+  Json::StreamWriterBuilder compact;
+  compact["indentation"] = "";
+
+  auto measure = [](const char* name, auto&& reply) {
+    constexpr int kRounds = 2000;
+    auto start = std::chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (int round = 0; round < kRounds; ++round) {
+      bytes += reply();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() * 1000 / kRounds
+              << " ns per reply (" << bytes / kRounds << " bytes)"
+              << std::endl;
+  };
+
+  auto running_apps_value = [&apps]() {
+    Json::Value reply;
+    Json::Value running(Json::arrayValue);
+    for (const App& app : apps) {
+      Json::Value app_json;
+      app_json["id"] = app.id;
+      app_json["instanceId"] = app.instance_id;
+      app_json["webprocessid"] = std::to_string(app.pid);
+      running.append(app_json);
+    }
+    reply["running"] = std::move(running);
+    reply["returnValue"] = true;
+    return reply;
+  };
+  JsonWriter writer;
+  auto running_apps_writer = [&apps, &writer]() {
+    writer.Clear();
+    writer.BeginObject().Key("running").BeginArray();
+    for (const App& app : apps) {
+      writer.BeginObject()
+          .Key("id")
+          .String(app.id)
+          .Key("instanceId")
+          .String(app.instance_id)
+          .Key("webprocessid")
+          .String(std::to_string(app.pid))
+          .EndObject();
+    }
+    writer.EndArray().Key("returnValue").Bool(true).EndObject();
+    return writer.size();
+  };
+
+  auto process_size_value = [&apps]() {
+    Json::Value reply;
+    Json::Value processes(Json::arrayValue);
+    for (int pid = 2000; pid < 2010; ++pid) {
+      Json::Value process;
+      Json::Value running(Json::arrayValue);
+      for (const App& app : apps) {
+        if (app.pid != pid) {
+          continue;
+        }
+        Json::Value app_json;
+        app_json["id"] = app.id;
+        app_json["instanceId"] = app.instance_id;
+        running.append(app_json);
+      }
+      process["pid"] = std::to_string(pid);
+      process["webProcessSize"] = "123456 KB";
+      process["tileSize"] = 0;
+      process["runningApps"] = std::move(running);
+      processes.append(process);
+    }
+    reply["WebProcesses"] = std::move(processes);
+    reply["returnValue"] = true;
+    return reply;
+  };
+  auto process_size_writer = [&apps, &writer]() {
+    writer.Clear();
+    writer.BeginObject().Key("WebProcesses").BeginArray();
+    for (int pid = 2000; pid < 2010; ++pid) {
+      writer.BeginObject()
+          .Key("pid")
+          .String(std::to_string(pid))
+          .Key("webProcessSize")
+          .String("123456 KB")
+          .Key("tileSize")
+          .Int(0)
+          .Key("runningApps")
+          .BeginArray();
+      for (const App& app : apps) {
+        if (app.pid != pid) {
+          continue;
+        }
+        writer.BeginObject()
+            .Key("id")
+            .String(app.id)
+            .Key("instanceId")
+            .String(app.instance_id)
+            .EndObject();
+      }
+      writer.EndArray().EndObject();
+    }
+    writer.EndArray().Key("returnValue").Bool(true).EndObject();
+    return writer.size();
+  };
+
+  measure("listRunningApps JsonWriter", running_apps_writer);
+  measure("listRunningApps Json::Value + compact writer", [&]() {
+    return Json::writeString(compact, running_apps_value()).size();
+  });
+  measure("listRunningApps Json::Value + util::JsonToString", [&]() {
+    return util::JsonToString(running_apps_value()).size();
+  });
+  measure("getWebProcessSize JsonWriter", process_size_writer);
+  measure("getWebProcessSize Json::Value + compact writer", [&]() {
+    return Json::writeString(compact, process_size_value()).size();
+  });
+  measure("getWebProcessSize Json::Value + util::JsonToString", [&]() {
+    return util::JsonToString(process_size_value()).size();
+  });
+}
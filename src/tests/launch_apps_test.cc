@@ -0,0 +1,182 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "base_mock_initializer.h"
+
+#include "utils.h"
+#include "web_app_manager.h"
+#include "web_app_manager_service.h"
+#include "web_app_manager_service_luna.h"
+#include "web_view_mock_impl.h"
+
+namespace {
+
+static constexpr int kPid = 4211;
+constexpr char kLaunchAppJsonBody[] = R"({
+  "launchingAppId": "com.webos.app.home",
+  "appDesc": {
+    "defaultWindowType": "card",
+    "uiRevision": "2",
+    "systemApp": true,
+    "version": "1.0.1",
+    "vendor": "LG Electronics, Inc.",
+    "miniicon": "icon.png",
+    "hasPromotion": false,
+    "tileSize": "normal",
+    "icons": [],
+    "launchPointId": "bareapp_default",
+    "largeIcon": "/usr/palm/applications/bareapp/icon.png",
+    "lockable": true,
+    "transparent": false,
+    "icon": "/usr/palm/applications/bareapp/icon.png",
+    "checkUpdateOnLaunch": true,
+    "imageForRecents": "",
+    "spinnerOnLaunch": true,
+    "handlesRelaunch": false,
+    "unmovable": false,
+    "id": "bareapp",
+    "inspectable": false,
+    "noSplashOnLaunch": false,
+    "privilegedJail": false,
+    "trustLevel": "default",
+    "title": "Bare App",
+    "deeplinkingParams": "",
+    "lptype": "default",
+    "inAppSetting": false,
+    "favicon": "",
+    "visible": true,
+    "accessibility": {
+      "supportsAudioGuidance": false
+    },
+    "folderPath": "/usr/palm/applications/bareapp",
+    "main": "index.html",
+    "removable": true,
+    "type": "web",
+    "disableBackHistoryAPI": false,
+    "bgImage": ""
+  },
+  "appId": "bareapp",
+  "parameters": {
+    "displayAffinity": 0
+  },
+  "reason": "com.webos.app.home",
+  "launchingProcId": "",
+  "instanceId": "2c1e6a3e-5a0f-4f0e-a0b5-8e1a8d6f2b100"
+})";
+
+// Launch request of the bare app published under |app_id|
+Json::Value LaunchRequest(const std::string& app_id,
+                          const std::string& instance_id) {
+  Json::Value request;
+  EXPECT_TRUE(util::StringToJson(kLaunchAppJsonBody, request));
+  request["appDesc"]["id"] = app_id;
+  request["appId"] = app_id;
+  request["instanceId"] = instance_id;
+  return request;
+}
+
+uint64_t RunningAppListUpdates() {
+  Json::Value stats = WebAppManagerServiceLuna::Instance()->getServiceStats(
+      Json::Value(Json::objectValue));
+  return stats["subscriptions"]["listRunningApps"]["replyBytes"]["count"]
+      .asUInt64();
+}
+
+}  // namespace
+
+TEST(LaunchAppsTest, RejectsEmptyBatch) {
+  Json::Value request;
+  request["launches"] = Json::Value(Json::arrayValue);
+  const auto reply = WebAppManagerServiceLuna::Instance()->launchApps(request);
+
+  ASSERT_TRUE(reply.isObject());
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(kErrCodeInvalidParam, reply["errorCode"].asInt());
+  EXPECT_EQ(kErrEmptyArray, reply["errorText"].asString());
+}
+
+TEST(LaunchAppsTest, RejectsBatchWithInvalidLaunch) {
+  BaseMockInitializer<NiceWebViewMockImpl> mock_initializer;
+  mock_initializer.GetWebViewMock()->SetOnInitActions();
+  mock_initializer.GetWebViewMock()->SetOnLoadURLActions();
+
+  Json::Value invalid = LaunchRequest("com.webos.app.b", "200");
+  invalid.removeMember("instanceId");
+
+  Json::Value request;
+  request["launches"].append(LaunchRequest("com.webos.app.a", "100"));
+  request["launches"].append(invalid);
+  const auto reply = WebAppManagerServiceLuna::Instance()->launchApps(request);
+
+  ASSERT_TRUE(reply.isObject());
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(kErrCodeLaunchappMissParam, reply["errorCode"].asInt());
+  EXPECT_EQ(1, reply["index"].asInt());
+  EXPECT_TRUE(WebAppManager::Instance()->RunningApps().empty());
+}
+
+TEST(LaunchAppsTest, RejectsDuplicateInstanceIds) {
+  Json::Value request;
+  request["launches"].append(LaunchRequest("com.webos.app.a", "100"));
+  request["launches"].append(LaunchRequest("com.webos.app.b", "100"));
+  const auto reply = WebAppManagerServiceLuna::Instance()->launchApps(request);
+
+  ASSERT_TRUE(reply.isObject());
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(kErrCodeInvalidParam, reply["errorCode"].asInt());
+  EXPECT_EQ(1, reply["index"].asInt());
+}
+
+TEST(LaunchAppsTest, LaunchesAllWithSingleRunningAppListUpdate) {
+  BaseMockInitializer<NiceWebViewMockImpl> mock_initializer;
+  NiceWebViewMockImpl* web_view = mock_initializer.GetWebViewMock();
+  web_view->SetOnInitActions();
+  web_view->SetOnLoadURLActions();
+  EXPECT_CALL(*web_view, RenderProcessPid())
+      .WillRepeatedly(testing::Return(kPid));
+  // Every page reports its web process while loading, which on its own
+  // posts the running app list once per app
+  ON_CALL(*web_view, LoadUrl(testing::_))
+      .WillByDefault(testing::Invoke([web_view](const std::string& url) {
+        web_view->GetWebViewDelegate()->RenderProcessCreated(kPid);
+        web_view->GetWebViewDelegate()->LoadFinished(url);
+      }));
+
+  Json::Value request;
+  request["launches"].append(LaunchRequest("com.webos.app.a", "100"));
+  request["launches"].append(LaunchRequest("com.webos.app.b", "200"));
+  request["launches"].append(LaunchRequest("com.webos.app.c", "300"));
+
+  uint64_t updates = RunningAppListUpdates();
+  const auto reply = WebAppManagerServiceLuna::Instance()->launchApps(request);
+
+  ASSERT_TRUE(reply.isObject());
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  ASSERT_TRUE(reply["results"].isArray());
+  ASSERT_EQ(3u, reply["results"].size());
+  for (const Json::Value& result : reply["results"]) {
+    EXPECT_TRUE(result["returnValue"].asBool());
+  }
+  EXPECT_EQ("300", reply["results"][2]["instanceId"].asString());
+  EXPECT_EQ("com.webos.app.c", reply["results"][2]["appId"].asString());
+
+  EXPECT_EQ(3u, WebAppManager::Instance()->RunningApps(kPid).size());
+  EXPECT_EQ(updates + 1, RunningAppListUpdates());
+}
@@ -0,0 +1,283 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "launch_scheduler.h"
+
+namespace {
+
+class LaunchSchedulerTest : public ::testing::Test {
+ protected:
+  LaunchSchedulerTest()
+      : scheduler_([this](const std::string& instance_id) {
+          return loading_.count(instance_id) > 0;
+        }) {}
+
+  // Queues a launch which starts loading |instance_id| when it runs
+  void Enqueue(const std::string& instance_id,
+               LaunchScheduler::Priority priority,
+               int rank = 0) {
+    scheduler_.Enqueue(
+        instance_id, priority,
+        [this, instance_id]() {
+          launched_.push_back(instance_id);
+          loading_.insert(instance_id);
+          return true;
+        },
+        rank);
+  }
+
+  void Launch(const std::string& instance_id,
+              LaunchScheduler::Priority priority) {
+    ASSERT_TRUE(scheduler_.Admit(instance_id, priority));
+    launched_.push_back(instance_id);
+    loading_.insert(instance_id);
+    scheduler_.Started(instance_id, priority);
+  }
+
+  // Spins the default main context until |launched_| has |count| entries
+  bool RunUntilLaunched(size_t count) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (launched_.size() < count &&
+           std::chrono::steady_clock::now() < deadline) {
+      g_main_context_iteration(nullptr, FALSE);
+    }
+    return launched_.size() == count;
+  }
+
+  void RunFor(std::chrono::milliseconds duration) {
+    auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline) {
+      g_main_context_iteration(nullptr, FALSE);
+    }
+  }
+
+  void DeferPreloads(int release_interval_ms) {
+    scheduler_.SetPreloadDeferral([this]() { return cpu_idle_; }, 50,
+                                  release_interval_ms);
+  }
+
+  int cpu_idle_ = 100;
+
+  std::set<std::string> loading_;
+  std::vector<std::string> launched_;
+  LaunchScheduler scheduler_;
+};
+
+}  // namespace
+
+TEST_F(LaunchSchedulerTest, AdmitsEverythingWithoutLimit) {
+  Launch("a", LaunchScheduler::kPreload);
+  Launch("b", LaunchScheduler::kPreload);
+  Launch("c", LaunchScheduler::kKeepAliveRestore);
+  EXPECT_EQ(0u, scheduler_.QueuedCount());
+}
+
+TEST_F(LaunchSchedulerTest, ForegroundLaunchesAreNeverHeldBack) {
+  scheduler_.SetMaxConcurrentLaunches(1);
+  Launch("preload1", LaunchScheduler::kPreload);
+
+  EXPECT_FALSE(scheduler_.Admit("preload2", LaunchScheduler::kPreload));
+  Enqueue("preload2", LaunchScheduler::kPreload);
+
+  EXPECT_TRUE(scheduler_.Admit("user", LaunchScheduler::kForeground));
+  EXPECT_TRUE(scheduler_.Admit("relaunch", LaunchScheduler::kRelaunch));
+  EXPECT_EQ(1u, scheduler_.QueuedCount());
+}
+
+TEST_F(LaunchSchedulerTest, RunsQueuedLaunchesByPriority) {
+  scheduler_.SetMaxConcurrentLaunches(1);
+  Launch("running", LaunchScheduler::kForeground);
+
+  Enqueue("preload1", LaunchScheduler::kPreload);
+  Enqueue("preload2", LaunchScheduler::kPreload);
+  Enqueue("keepalive", LaunchScheduler::kKeepAliveRestore);
+  // Queueing again raises the priority of the queued launch
+  Enqueue("preload2", LaunchScheduler::kKeepAliveRestore);
+  EXPECT_EQ(3u, scheduler_.QueuedCount());
+
+  // Nothing runs while the foreground launch is loading
+  g_main_context_iteration(nullptr, FALSE);
+  EXPECT_EQ(1u, launched_.size());
+
+  std::vector<std::string> expected = {"running", "keepalive", "preload2",
+                                       "preload1"};
+  for (size_t i = 1; i < expected.size(); ++i) {
+    loading_.clear();
+    ASSERT_TRUE(RunUntilLaunched(i + 1));
+    EXPECT_EQ(expected[i], launched_.back());
+    EXPECT_EQ(1u, scheduler_.LoadingCount());
+  }
+  EXPECT_EQ(0u, scheduler_.QueuedCount());
+
+  Json::Value stats = scheduler_.ToJson();
+  EXPECT_EQ(1, stats["maxConcurrent"].asInt());
+  EXPECT_EQ(2u, stats["waitMs"]["keepAliveRestore"]["count"].asUInt64());
+  EXPECT_EQ(1u, stats["waitMs"]["preload"]["count"].asUInt64());
+  EXPECT_EQ(1u, stats["waitMs"]["foreground"]["count"].asUInt64());
+}
+
+TEST_F(LaunchSchedulerTest, ForegroundLaunchSupersedesQueuedOne) {
+  scheduler_.SetMaxConcurrentLaunches(1);
+  Launch("running", LaunchScheduler::kPreload);
+  Enqueue("app", LaunchScheduler::kPreload);
+  EXPECT_TRUE(scheduler_.IsQueued("app"));
+  EXPECT_FALSE(scheduler_.Admit("app", LaunchScheduler::kPreload));
+
+  Launch("app", LaunchScheduler::kRelaunch);
+  EXPECT_FALSE(scheduler_.IsQueued("app"));
+
+  loading_.clear();
+  g_main_context_iteration(nullptr, FALSE);
+  // The queued preload doesn't run on top of the user launch
+  EXPECT_EQ((std::vector<std::string>{"running", "app"}), launched_);
+}
+
+TEST_F(LaunchSchedulerTest, CancelAndClearDropQueuedLaunches) {
+  scheduler_.SetMaxConcurrentLaunches(1);
+  Launch("running", LaunchScheduler::kForeground);
+  Enqueue("a", LaunchScheduler::kPreload);
+  Enqueue("b", LaunchScheduler::kPreload);
+
+  EXPECT_TRUE(scheduler_.Cancel("a"));
+  EXPECT_FALSE(scheduler_.Cancel("a"));
+  EXPECT_EQ(1u, scheduler_.QueuedCount());
+
+  scheduler_.Clear();
+  EXPECT_EQ(0u, scheduler_.QueuedCount());
+  EXPECT_EQ(0u, scheduler_.LoadingCount());
+}
+
+TEST_F(LaunchSchedulerTest, StuckLoadsTimeOut) {
+  scheduler_.SetMaxConcurrentLaunches(1);
+  scheduler_.SetLoadTimeoutMs(0);
+  Launch("stuck", LaunchScheduler::kForeground);
+
+  EXPECT_TRUE(scheduler_.Admit("next", LaunchScheduler::kPreload));
+}
+
+TEST_F(LaunchSchedulerTest, PreloadsWaitForBootDoneAndIdleCpu) {
+  DeferPreloads(0);
+  cpu_idle_ = 10;
+  EXPECT_FALSE(scheduler_.Admit("preload", LaunchScheduler::kPreload));
+  Enqueue("preload", LaunchScheduler::kPreload);
+  // Other launches are not affected
+  EXPECT_TRUE(
+      scheduler_.Admit("keepalive", LaunchScheduler::kKeepAliveRestore));
+
+  RunFor(std::chrono::milliseconds(200));
+  EXPECT_TRUE(launched_.empty());
+
+  scheduler_.SetBootDone(true);
+  RunFor(std::chrono::milliseconds(200));
+  EXPECT_TRUE(launched_.empty());
+
+  cpu_idle_ = 80;
+  ASSERT_TRUE(RunUntilLaunched(1));
+  EXPECT_EQ(0, scheduler_.ToJson()["preloadsQueued"].asInt());
+}
+
+TEST_F(LaunchSchedulerTest, DeferredPreloadsAreSpacedOut) {
+  DeferPreloads(300);
+  scheduler_.SetBootDone(true);
+  Enqueue("a", LaunchScheduler::kPreload);
+  Enqueue("b", LaunchScheduler::kPreload);
+
+  ASSERT_TRUE(RunUntilLaunched(1));
+  auto first = std::chrono::steady_clock::now();
+  ASSERT_TRUE(RunUntilLaunched(2));
+  EXPECT_GE(std::chrono::steady_clock::now() - first,
+            std::chrono::milliseconds(250));
+}
+
+TEST_F(LaunchSchedulerTest, DeferredPreloadsRunInRankOrder) {
+  DeferPreloads(0);
+  Enqueue("minimal", LaunchScheduler::kPreload, 3);
+  Enqueue("full", LaunchScheduler::kPreload, 0);
+  Enqueue("partial", LaunchScheduler::kPreload, 2);
+  Enqueue("other", LaunchScheduler::kPreload, 4);
+  EXPECT_EQ(4, scheduler_.ToJson()["preloadsQueued"].asInt());
+
+  scheduler_.SetBootDone(true);
+  ASSERT_TRUE(RunUntilLaunched(4));
+  EXPECT_EQ((std::vector<std::string>{"full", "partial", "minimal", "other"}),
+            launched_);
+}
+
+// Not run by default: --gtest_also_run_disabled_tests --gtest_filter=*Bench*
+//
+// A user launch requested right behind a burst of background launches, each
+// of which costs 500 us of main loop time to start. Measures how long the
+// user launch takes to start, without a limit and with two launches at a
+// time.
+TEST_F(LaunchSchedulerTest, DISABLED_BenchmarkForegroundBehindBackground) {
+  using Clock = std::chrono::steady_clock;
+  auto start_page = [this](const std::string& instance_id) {
+    auto until = Clock::now() + std::chrono::microseconds(500);
+    while (Clock::now() < until) {
+    }
+    launched_.push_back(instance_id);
+    loading_.insert(instance_id);
+  };
+  auto request = [this, &start_page](const std::string& instance_id,
+                                     LaunchScheduler::Priority priority) {
+    if (!scheduler_.Admit(instance_id, priority)) {
+      scheduler_.Enqueue(instance_id, priority, [&start_page, instance_id]() {
+        start_page(instance_id);
+        return true;
+      });
+      return;
+    }
+    start_page(instance_id);
+    scheduler_.Started(instance_id, priority);
+  };
+
+  for (int queued : {10, 50, 200}) {
+    for (int max_concurrent : {0, 2}) {
+      scheduler_.Clear();
+      loading_.clear();
+      launched_.clear();
+      scheduler_.SetMaxConcurrentLaunches(max_concurrent);
+
+      auto requested = Clock::now();
+      for (int i = 0; i < queued; ++i) {
+        request("background" + std::to_string(i),
+                i % 2 ? LaunchScheduler::kPreload
+                      : LaunchScheduler::kKeepAliveRestore);
+      }
+      request("user", LaunchScheduler::kForeground);
+      auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+          Clock::now() - requested);
+
+      std::cout << queued << " background launches, max concurrent "
+                << max_concurrent << ": user launch started after "
+                << waited.count() << " us, " << scheduler_.QueuedCount()
+                << " queued" << std::endl;
+    }
+  }
+  // The queued tasks refer to |start_page|
+  scheduler_.Clear();
+}
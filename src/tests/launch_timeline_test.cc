@@ -0,0 +1,103 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "launch_timeline.h"
+
+namespace {
+
+LaunchTiming Timing(const std::string& app_id) {
+  LaunchTiming timing;
+  timing.SetAppId(app_id);
+  timing.Mark(LaunchTiming::kDescriptionParsed);
+  timing.Mark(LaunchTiming::kFirstFrame);
+  return timing;
+}
+
+}  // namespace
+
+TEST(LaunchTimelineTest, KeepsTheLatestTimelinesNewestFirst) {
+  LaunchTimelineRecorder recorder(2);
+  recorder.Record("100", Timing("com.webos.app.a"),
+                  LaunchTimelineRecorder::kShown);
+  recorder.Record("101", Timing("com.webos.app.b"),
+                  LaunchTimelineRecorder::kShown);
+  recorder.Record("102", Timing("com.webos.app.c"),
+                  LaunchTimelineRecorder::kClosed);
+
+  EXPECT_EQ(2u, recorder.Size());
+  Json::Value timelines = recorder.ToJson()["timelines"];
+  ASSERT_EQ(2u, timelines.size());
+  EXPECT_EQ("102", timelines[0]["instanceId"].asString());
+  EXPECT_EQ("com.webos.app.c", timelines[0]["appId"].asString());
+  EXPECT_EQ("closed", timelines[0]["outcome"].asString());
+  EXPECT_EQ("101", timelines[1]["instanceId"].asString());
+  EXPECT_EQ("shown", timelines[1]["outcome"].asString());
+  EXPECT_TRUE(timelines[1]["stages"].isMember("firstFrameMs"));
+}
+
+TEST(LaunchTimelineTest, ZeroCapacityRecordsNothing) {
+  LaunchTimelineRecorder recorder(0);
+  recorder.Record("100", Timing("com.webos.app.a"),
+                  LaunchTimelineRecorder::kShown);
+
+  EXPECT_EQ(0u, recorder.Size());
+  EXPECT_TRUE(recorder.ToJson()["timelines"].empty());
+}
+
+TEST(LaunchTimelineTest, SetCapacityDropsTimelines) {
+  LaunchTimelineRecorder recorder(4);
+  recorder.Record("100", Timing("com.webos.app.a"),
+                  LaunchTimelineRecorder::kShown);
+  recorder.SetCapacity(8);
+
+  EXPECT_EQ(8u, recorder.Capacity());
+  EXPECT_EQ(0u, recorder.Size());
+}
+
+TEST(LaunchTimelineTest, NearestRankPercentiles) {
+  std::vector<int64_t> values;
+  for (int64_t value = 100; value >= 1; --value) {
+    values.push_back(value);
+  }
+
+  EXPECT_EQ(0, LaunchTimelineRecorder::Percentile({}, 50));
+  EXPECT_EQ(7, LaunchTimelineRecorder::Percentile({7}, 99));
+  EXPECT_EQ(50, LaunchTimelineRecorder::Percentile(values, 50));
+  EXPECT_EQ(90, LaunchTimelineRecorder::Percentile(values, 90));
+  EXPECT_EQ(100, LaunchTimelineRecorder::Percentile(values, 100));
+  EXPECT_EQ(1, LaunchTimelineRecorder::Percentile(values, 0));
+}
+
+TEST(LaunchTimelineTest, ReportsPercentilesOfReachedStages) {
+  LaunchTimelineRecorder recorder;
+  recorder.Record("100", Timing("com.webos.app.a"),
+                  LaunchTimelineRecorder::kShown);
+  LaunchTiming closed;
+  closed.Mark(LaunchTiming::kDescriptionParsed);
+  recorder.Record("101", closed, LaunchTimelineRecorder::kClosed);
+
+  Json::Value stages = recorder.ToJson()["stageMs"];
+  EXPECT_EQ(2u, stages["descriptionParsed"]["count"].asUInt());
+  EXPECT_EQ(1u, stages["firstFrame"]["count"].asUInt());
+  EXPECT_FALSE(stages.isMember("admitted"));
+  EXPECT_TRUE(stages["firstFrame"].isMember("p90"));
+}
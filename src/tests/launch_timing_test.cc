@@ -0,0 +1,79 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "launch_timing.h"
+
+TEST(LaunchTimingTest, StagesStartUnreached) {
+  LaunchTiming timing;
+
+  EXPECT_FALSE(timing.Reached(LaunchTiming::kAdmitted));
+  EXPECT_EQ(-1, timing.ElapsedMs(LaunchTiming::kFirstFrame));
+  EXPECT_TRUE(timing.ToJson().empty());
+}
+
+TEST(LaunchTimingTest, FirstMarkWins) {
+  LaunchTiming timing;
+  timing.Mark(LaunchTiming::kLoadFinished);
+  int64_t first = timing.ElapsedMs(LaunchTiming::kLoadFinished);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  timing.Mark(LaunchTiming::kLoadFinished);
+
+  EXPECT_TRUE(timing.Reached(LaunchTiming::kLoadFinished));
+  EXPECT_EQ(first, timing.ElapsedMs(LaunchTiming::kLoadFinished));
+}
+
+TEST(LaunchTimingTest, CountsFromTheRequest) {
+  LaunchTiming timing;
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  timing.Mark(LaunchTiming::kAdmitted);
+  timing.Mark(LaunchTiming::kFirstFrame);
+
+  EXPECT_GE(timing.ElapsedMs(LaunchTiming::kAdmitted), 5);
+  EXPECT_LE(timing.ElapsedMs(LaunchTiming::kAdmitted),
+            timing.ElapsedMs(LaunchTiming::kFirstFrame));
+}
+
+TEST(LaunchTimingTest, ReportsReachedStagesOnly) {
+  LaunchTiming timing;
+  timing.Mark(LaunchTiming::kPageCreated);
+  timing.Mark(LaunchTiming::kFirstFrame);
+
+  Json::Value json = timing.ToJson();
+  EXPECT_EQ(2u, json.size());
+  EXPECT_TRUE(json.isMember("pageCreatedMs"));
+  EXPECT_TRUE(json.isMember("firstFrameMs"));
+  EXPECT_FALSE(json.isMember("loadStartedMs"));
+}
+
+TEST(LaunchTimingTest, FindsThePreviousReachedStage) {
+  LaunchTiming timing;
+  timing.Mark(LaunchTiming::kAdmitted);
+  timing.Mark(LaunchTiming::kLoadStarted);
+
+  EXPECT_EQ(LaunchTiming::kStageCount,
+            timing.PreviousReached(LaunchTiming::kAdmitted));
+  EXPECT_EQ(LaunchTiming::kAdmitted,
+            timing.PreviousReached(LaunchTiming::kLoadStarted));
+  EXPECT_EQ(LaunchTiming::kLoadStarted,
+            timing.PreviousReached(LaunchTiming::kFirstFrame));
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "launch_tracker.h"
+
+namespace {
+
+class LaunchTrackerTest : public ::testing::Test {
+ protected:
+  LaunchTrackerTest()
+      : tracker_([this](const std::string& instance_id) {
+          return in_flight_.count(instance_id) > 0;
+        }) {}
+
+  void Start(const std::string& app_id,
+             const std::string& instance_id,
+             DisplayId display = 0) {
+    in_flight_.insert(instance_id);
+    tracker_.Started(app_id, instance_id, display);
+  }
+
+  std::set<std::string> in_flight_;
+  LaunchTracker tracker_;
+};
+
+}  // namespace
+
+TEST_F(LaunchTrackerTest, FindsInstanceInFlightPerDisplay) {
+  Start("com.webos.app.a", "100", 0);
+  Start("com.webos.app.a", "101", 1);
+
+  EXPECT_EQ("100", tracker_.InFlightInstance("com.webos.app.a", 0, ""));
+  EXPECT_EQ("101", tracker_.InFlightInstance("com.webos.app.a", 1, ""));
+  EXPECT_EQ("", tracker_.InFlightInstance("com.webos.app.b", 0, ""));
+}
+
+TEST_F(LaunchTrackerTest, CoalescesOnlyTheRequestedInstance) {
+  Start("com.webos.app.a", "100");
+
+  EXPECT_EQ("100", tracker_.InFlightInstance("com.webos.app.a", 0, "100"));
+  // Another instance of the same app gets a load of its own
+  EXPECT_EQ("", tracker_.InFlightInstance("com.webos.app.a", 0, "101"));
+}
+
+TEST_F(LaunchTrackerTest, ForgetsLandedLaunches) {
+  Start("com.webos.app.a", "100");
+  in_flight_.erase("100");
+
+  EXPECT_EQ("", tracker_.InFlightInstance("com.webos.app.a", 0, ""));
+  EXPECT_EQ(0u, tracker_.InFlightCount());
+}
+
+TEST_F(LaunchTrackerTest, CancelCountsWastedLoadsOnly) {
+  Start("com.webos.app.a", "100");
+  Start("com.webos.app.b", "200");
+  in_flight_.erase("200");
+
+  EXPECT_TRUE(tracker_.Cancel("100"));
+  EXPECT_FALSE(tracker_.Cancel("100"));
+  EXPECT_FALSE(tracker_.Cancel("200"));
+
+  Json::Value stats = tracker_.ToJson();
+  EXPECT_EQ(1u, stats["cancelled"].asUInt64());
+  EXPECT_EQ(1u, stats["wastedLoadMs"]["count"].asUInt64());
+}
+
+TEST_F(LaunchTrackerTest, CountsCoalescedLaunches) {
+  Start("com.webos.app.a", "100");
+  tracker_.Coalesced("com.webos.app.a");
+  tracker_.Coalesced("com.webos.app.a");
+  EXPECT_EQ(2u, tracker_.ToJson()["coalesced"].asUInt64());
+
+  tracker_.ResetStats();
+  Json::Value stats = tracker_.ToJson();
+  EXPECT_EQ(0u, stats["coalesced"].asUInt64());
+  EXPECT_EQ(1u, stats["inFlight"].asUInt64());
+}
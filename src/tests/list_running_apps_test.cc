@@ -21,6 +21,7 @@
 #include <json/json.h>
 
 #include "base_mock_initializer.h"
+#include "json_writer.h"
 #include "utils.h"
 #include "web_app_manager_service.h"
 #include "web_app_manager_service_luna.h"
@@ -141,6 +142,19 @@ static constexpr char kLaunchWebRTCAppJsonBody[] = R"({
   "reason": "com.webos.app.home"
 })";
 
+// listRunningApps writes the members of the reply object, as sent on the bus
+Json::Value ListRunningApps(const Json::Value& request) {
+  JsonWriter writer;
+  writer.BeginObject();
+  WebAppManagerServiceLuna::Instance()->listRunningApps(request, true,
+                                                        &writer);
+  writer.EndObject();
+
+  Json::Value reply;
+  EXPECT_TRUE(util::StringToJson(writer.str(), reply)) << writer.str();
+  return reply;
+}
+
 }  // namespace
 
 TEST(ListRunningAppsTest, IncludeSysApps) {
@@ -171,7 +185,7 @@ TEST(ListRunningAppsTest, IncludeSysApps) {
 
   Json::Value request;
   request["includeSysApps"] = true;
-  const auto reply = luna_service->listRunningApps(request, true);
+  const auto reply = ListRunningApps(request);
 
   ASSERT_TRUE(reply.isObject());
   ASSERT_TRUE(result.isMember("returnValue"));
@@ -230,7 +244,7 @@ TEST(ListRunningAppsTest, ExcludeSysApps) {
 
   Json::Value request;
   request["includeSysApps"] = false;
-  const auto reply = luna_service->listRunningApps(request, true);
+  const auto reply = ListRunningApps(request);
 
   ASSERT_TRUE(reply.isObject());
   ASSERT_TRUE(reply.isMember("returnValue"));
@@ -249,3 +263,16 @@ TEST(ListRunningAppsTest, ExcludeSysApps) {
   EXPECT_TRUE(running_app.isMember("webprocessid"));
   EXPECT_EQ(std::to_string(pid), running_app["webprocessid"].asString());
 }
+
+TEST(ListRunningAppsTest, NoRunningApps) {
+  BaseMockInitializer<NiceWebViewMockImpl> mock_initializer;
+
+  Json::Value request;
+  request["includeSysApps"] = true;
+  const auto reply = ListRunningApps(request);
+
+  ASSERT_TRUE(reply.isObject());
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  ASSERT_TRUE(reply.isMember("running"));
+  EXPECT_TRUE(reply["running"].isNull());
+}
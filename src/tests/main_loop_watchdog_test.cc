@@ -0,0 +1,203 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include <json/value.h>
+
+#include "main_loop_watchdog.h"
+#include "timer.h"
+#include "timer_wheel.h"
+
+namespace {
+
+const int64_t kUsPerMs = 1000;
+
+class MainLoopWatchdogTest : public ::testing::Test {
+ protected:
+  MainLoopWatchdogTest() : watchdog_([this]() { return now_us_; }) {
+    watchdog_.SetThresholdMs(100);
+  }
+
+  void AdvanceMs(int64_t ms) { now_us_ += ms * kUsPerMs; }
+
+  // Runs a callback taking |ms| in a scope
+  void RunCallback(const char* name, int64_t ms, int detail = -1) {
+    MainLoopWatchdog::Scope scope("test", name, detail);
+    AdvanceMs(ms);
+  }
+
+  Json::Value Offenders() const { return watchdog_.ToJson()["offenders"]; }
+
+  int64_t now_us_ = 5000 * kUsPerMs;
+  MainLoopWatchdog watchdog_;
+};
+
+class SlowReceiver {
+ public:
+  explicit SlowReceiver(std::function<void()> work) : work_(std::move(work)) {}
+  void OnTimeout() { work_(); }
+
+ private:
+  std::function<void()> work_;
+};
+
+}  // namespace
+
+TEST_F(MainLoopWatchdogTest, RecordsSlowCallbacksOnly) {
+  EXPECT_EQ(&watchdog_, MainLoopWatchdog::Current());
+
+  RunCallback("fast", 99);
+  RunCallback("slow", 120, 7);
+
+  Json::Value json = watchdog_.ToJson();
+  EXPECT_EQ(100, json["thresholdMs"].asInt());
+  EXPECT_EQ(1u, json["slowCallbacks"].asUInt64());
+  ASSERT_EQ(1u, json["offenders"].size());
+  const Json::Value& offender = json["offenders"][0];
+  EXPECT_EQ("test", offender["kind"].asString());
+  EXPECT_EQ("slow", offender["name"].asString());
+  EXPECT_EQ(7, offender["detail"].asInt());
+  EXPECT_EQ(120, offender["durationMs"].asInt64());
+  EXPECT_EQ(0, offender["agoMs"].asInt64());
+
+  AdvanceMs(40);
+  EXPECT_EQ(40, Offenders()[0]["agoMs"].asInt64());
+
+  RunCallback("slow", 100);
+  EXPECT_FALSE(Offenders()[0].isMember("detail"));
+}
+
+TEST_F(MainLoopWatchdogTest, BlamesTheInnermostSlowCallback) {
+  {
+    MainLoopWatchdog::Scope outer("luna", "launchApp");
+    AdvanceMs(10);
+    RunCallback("inner", 200);
+    AdvanceMs(10);
+  }
+
+  ASSERT_EQ(1u, Offenders().size());
+  EXPECT_EQ("inner", Offenders()[0]["name"].asString());
+
+  // The outer callback is blamed when none of its nested ones was slow
+  {
+    MainLoopWatchdog::Scope outer("luna", "launchApp");
+    RunCallback("inner", 50);
+    AdvanceMs(60);
+  }
+  ASSERT_EQ(2u, Offenders().size());
+  EXPECT_EQ("luna", Offenders()[0]["kind"].asString());
+  EXPECT_EQ("launchApp", Offenders()[0]["name"].asString());
+  EXPECT_EQ(110, Offenders()[0]["durationMs"].asInt64());
+}
+
+TEST_F(MainLoopWatchdogTest, LateHeartbeatWithoutSlowCallbackIsUnattributed) {
+  watchdog_.Heartbeat();
+
+  // On time
+  AdvanceMs(MainLoopWatchdog::kHeartbeatIntervalMs);
+  watchdog_.Heartbeat();
+  EXPECT_EQ(0u, Offenders().size());
+
+  // Late, and nothing instrumented to blame
+  AdvanceMs(MainLoopWatchdog::kHeartbeatIntervalMs + 300);
+  watchdog_.Heartbeat();
+  ASSERT_EQ(1u, Offenders().size());
+  EXPECT_EQ("unattributed", Offenders()[0]["kind"].asString());
+  EXPECT_EQ(300, Offenders()[0]["durationMs"].asInt64());
+
+  // Late because of a callback which has been blamed already
+  AdvanceMs(MainLoopWatchdog::kHeartbeatIntervalMs);
+  RunCallback("slow", 300);
+  watchdog_.Heartbeat();
+  ASSERT_EQ(2u, Offenders().size());
+  EXPECT_EQ("slow", Offenders()[0]["name"].asString());
+
+  Json::Value lag = watchdog_.ToJson()["lagMs"];
+  EXPECT_EQ(3u, lag["count"].asUInt64());
+  EXPECT_EQ(600u, lag["sum"].asUInt64());
+}
+
+TEST_F(MainLoopWatchdogTest, KeepsTheNewestOffenders) {
+  const size_t extra = 5;
+  for (size_t i = 0; i < MainLoopWatchdog::kMaxOffenders + extra; ++i) {
+    RunCallback("slow", 100, static_cast<int>(i));
+  }
+
+  Json::Value json = watchdog_.ToJson();
+  EXPECT_EQ(MainLoopWatchdog::kMaxOffenders + extra,
+            json["slowCallbacks"].asUInt64());
+  ASSERT_EQ(MainLoopWatchdog::kMaxOffenders, json["offenders"].size());
+  EXPECT_EQ(static_cast<int>(MainLoopWatchdog::kMaxOffenders + extra - 1),
+            json["offenders"][0]["detail"].asInt());
+  const Json::ArrayIndex oldest = MainLoopWatchdog::kMaxOffenders - 1;
+  EXPECT_EQ(static_cast<int>(extra),
+            json["offenders"][oldest]["detail"].asInt());
+
+  watchdog_.Reset();
+  json = watchdog_.ToJson();
+  EXPECT_EQ(0u, json["slowCallbacks"].asUInt64());
+  EXPECT_EQ(0u, json["offenders"].size());
+  EXPECT_EQ(0u, json["lagMs"]["count"].asUInt64());
+}
+
+TEST_F(MainLoopWatchdogTest, StoppedWatchdogIgnoresScopes) {
+  watchdog_.SetThresholdMs(0);
+  EXPECT_FALSE(watchdog_.IsRunning());
+  EXPECT_EQ(nullptr, MainLoopWatchdog::Current());
+
+  RunCallback("slow", 1000);
+  EXPECT_EQ(0u, Offenders().size());
+}
+
+TEST_F(MainLoopWatchdogTest, ScopeOutlivingTheWatchdog) {
+  auto watchdog =
+      std::make_unique<MainLoopWatchdog>([this]() { return now_us_; });
+  watchdog->SetThresholdMs(100);
+  {
+    MainLoopWatchdog::Scope scope("test", "running");
+    watchdog.reset();
+    EXPECT_EQ(nullptr, MainLoopWatchdog::Current());
+  }
+
+  watchdog_.SetThresholdMs(100);
+  RunCallback("slow", 1000);
+  EXPECT_EQ(1u, Offenders().size());
+}
+
+TEST_F(MainLoopWatchdogTest, NamesSlowTimersByReceiver) {
+  TimerWheel wheel([this]() { return now_us_ / kUsPerMs; });
+  TimerWheel::SetDefaultForTesting(&wheel);
+  SlowReceiver receiver([this]() { AdvanceMs(150); });
+
+  OneShotTimer<SlowReceiver> timer;
+  timer.StartWithReceiver(10, &receiver, &SlowReceiver::OnTimeout);
+  AdvanceMs(20);
+  wheel.AdvanceTo(now_us_ / kUsPerMs);
+
+  ASSERT_EQ(1u, Offenders().size());
+  EXPECT_EQ("timer", Offenders()[0]["kind"].asString());
+  EXPECT_NE(std::string::npos,
+            Offenders()[0]["name"].asString().find("SlowReceiver"));
+  EXPECT_EQ(150, Offenders()[0]["durationMs"].asInt64());
+
+  TimerWheel::SetDefaultForTesting(nullptr);
+}
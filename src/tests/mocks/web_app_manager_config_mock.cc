@@ -16,9 +16,14 @@
 
 #include "web_app_manager_config_mock.h"
 
+WebAppManagerConfigMock::WebAppManagerConfigMock()
+    : WebAppManagerConfig(std::string()) {}
+
 WebAppManagerConfigMock::WebAppManagerConfigMock(
-    const std::map<std::string, std::string>* environment_variables)
-    : environment_variables_(environment_variables) {
+    const std::map<std::string, std::string>* environment_variables,
+    const std::string& override_path)
+    : WebAppManagerConfig(override_path),
+      environment_variables_(environment_variables) {
   ResetConfiguration();
 }
 
@@ -36,3 +41,7 @@ std::string WebAppManagerConfigMock::WamGetEnv(const char* name) {
 
   return std::string();
 }
+
+bool WebAppManagerConfigMock::PreferenceExists(const char* path) {
+  return preferences_.count(path) > 0;
+}
@@ -18,21 +18,31 @@
 #define TESTS_MOCKS_WEB_APP_MANAGER_CONFIG_MOCK_H_
 
 #include <map>
+#include <set>
+#include <string>
 
 #include "web_app_manager_config.h"
 
 class WebAppManagerConfigMock : public WebAppManagerConfig {
  public:
-  WebAppManagerConfigMock() = default;
+  WebAppManagerConfigMock();
+  // Overrides are read from |override_path| as from the system override
+  // file, which the mock never reads
   explicit WebAppManagerConfigMock(
-      const std::map<std::string, std::string>* environment_variables);
+      const std::map<std::string, std::string>* environment_variables,
+      const std::string& override_path = std::string());
   ~WebAppManagerConfigMock() override;
 
+  // Makes PostInitConfiguration() see the preference file |path|
+  void AddPreference(const std::string& path) { preferences_.insert(path); }
+
  protected:
   std::string WamGetEnv(const char* name) override;
+  bool PreferenceExists(const char* path) override;
 
  private:
   const std::map<std::string, std::string>* environment_variables_ = nullptr;
+  std::set<std::string> preferences_;
 };
 
 #endif  // TESTS_MOCKS_WEB_APP_MANAGER_CONFIG_MOCK_H_
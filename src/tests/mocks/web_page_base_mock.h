@@ -0,0 +1,76 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TESTS_MOCKS_WEB_PAGE_BASE_MOCK_H_
+#define TESTS_MOCKS_WEB_PAGE_BASE_MOCK_H_
+
+#include <gmock/gmock.h>
+
+#include "url.h"
+#include "web_page_base.h"
+
+class WebPageBaseMock : public WebPageBase {
+ public:
+  WebPageBaseMock() = default;
+  ~WebPageBaseMock() override = default;
+
+  MOCK_METHOD(void, Init, (), (override));
+  MOCK_METHOD(void*, GetWebContents, (), (override));
+  MOCK_METHOD(wam::Url, Url, (), (const, override));
+  MOCK_METHOD(std::string, FailedUrl, (), (const, override));
+  MOCK_METHOD(void, LoadUrl, (const std::string&), (override));
+  MOCK_METHOD(int, Progress, (), (const, override));
+  MOCK_METHOD(bool, HasBeenShown, (), (const, override));
+  MOCK_METHOD(void, SetPageProperties, (), (override));
+  MOCK_METHOD(void, SetPreferredLanguages, (const std::string&), (override));
+  MOCK_METHOD(void, SetDefaultFont, (const std::string&), (override));
+  MOCK_METHOD(void, ReloadDefaultPage, (), (override));
+  MOCK_METHOD(void, Reload, (), (override));
+  MOCK_METHOD(void,
+              SetVisibilityState,
+              (WebPageVisibilityState),
+              (override));
+  MOCK_METHOD(void, SetFocus, (bool), (override));
+  MOCK_METHOD(std::string, Title, (), (override));
+  MOCK_METHOD(bool, CanGoBack, (), (override));
+  MOCK_METHOD(void, CloseVkb, (), (override));
+  MOCK_METHOD(void, HandleDeviceInfoChanged, (const std::string&), (override));
+  MOCK_METHOD(void, EvaluateJavaScript, (const std::string&), (override));
+  MOCK_METHOD(void,
+              EvaluateJavaScriptInAllFrames,
+              (const std::string&, const char*),
+              (override));
+  MOCK_METHOD(uint32_t, GetWebProcessProxyID, (), (override));
+  MOCK_METHOD(uint32_t, GetWebProcessPID, (), (const, override));
+  MOCK_METHOD(void, CreatePalmSystem, (WebAppBase*), (override));
+  MOCK_METHOD(void, SuspendWebPageAll, (), (override));
+  MOCK_METHOD(void, ResumeWebPageAll, (), (override));
+  MOCK_METHOD(void, SuspendWebPageMedia, (), (override));
+  MOCK_METHOD(void, ResumeWebPageMedia, (), (override));
+  MOCK_METHOD(void, ResumeWebPagePaintingAndJSExecution, (), (override));
+  MOCK_METHOD(bool, IsLoadErrorPageFinish, (), (override));
+  MOCK_METHOD(void, ForwardEvent, (void*), (override));
+  MOCK_METHOD(void, SuspendWebPagePaintingAndJSExecution, (), (override));
+
+ protected:
+  MOCK_METHOD(void, LoadDefaultUrl, (), (override));
+  MOCK_METHOD(void, AddUserScript, (const std::string&), (override));
+  MOCK_METHOD(void, AddUserScriptUrl, (const wam::Url&), (override));
+  MOCK_METHOD(void, LoadErrorPage, (int), (override));
+  MOCK_METHOD(void, RecreateWebView, (), (override));
+};
+
+#endif  // TESTS_MOCKS_WEB_PAGE_BASE_MOCK_H_
@@ -0,0 +1,217 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "network_reload_scheduler.h"
+#include "timer_wheel.h"
+#include "web_page_base_mock.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+
+class NetworkReloadSchedulerTest : public ::testing::Test {
+ protected:
+  NetworkReloadSchedulerTest() : wheel_([this]() { return now_ms_; }) {
+    TimerWheel::SetDefaultForTesting(&wheel_);
+    scheduler_ = std::make_unique<NetworkReloadScheduler>();
+    scheduler_->SetMaxConcurrentReloads(10);
+    scheduler_->SetReloadIntervalMs(100);
+  }
+
+  ~NetworkReloadSchedulerTest() override {
+    scheduler_.reset();
+    TimerWheel::SetDefaultForTesting(nullptr);
+  }
+
+  // A page showing its error page, which loads as far as |progress| once
+  // reloaded
+  WebPageBaseMock* AddFailedPage(const std::string& name) {
+    auto page = std::make_unique<NiceMock<WebPageBaseMock>>();
+    page->SetAppId(name);
+    ON_CALL(*page, IsLoadErrorPageFinish()).WillByDefault(Return(true));
+    ON_CALL(*page, FailedUrl()).WillByDefault(Return("http://" + name));
+    ON_CALL(*page, Progress()).WillByDefault([this, name]() {
+      return progress_[name];
+    });
+    ON_CALL(*page, LoadUrl(::testing::_))
+        .WillByDefault([this, name](const std::string&) {
+          reloaded_.push_back(name);
+        });
+    pages_.push_back(std::move(page));
+    return pages_.back().get();
+  }
+
+  void AdvanceBy(int64_t ms) {
+    now_ms_ += ms;
+    wheel_.AdvanceTo(now_ms_);
+  }
+
+  // Lets the main loop run every millisecond for |ms|
+  void RunFor(int64_t ms) {
+    for (int64_t i = 0; i < ms; ++i) {
+      AdvanceBy(1);
+    }
+  }
+
+  int64_t now_ms_ = 1000;
+  TimerWheel wheel_;
+  std::unique_ptr<NetworkReloadScheduler> scheduler_;
+  std::vector<std::unique_ptr<WebPageBaseMock>> pages_;
+  std::map<std::string, int> progress_;
+  std::vector<std::string> reloaded_;
+};
+
+}  // namespace
+
+TEST_F(NetworkReloadSchedulerTest, ReloadsInPriorityOrder) {
+  scheduler_->Schedule(AddFailedPage("background"),
+                       NetworkReloadScheduler::kBackground);
+  scheduler_->Schedule(AddFailedPage("visible"),
+                       NetworkReloadScheduler::kVisible);
+  scheduler_->Schedule(AddFailedPage("foreground"),
+                       NetworkReloadScheduler::kForeground);
+  scheduler_->Schedule(AddFailedPage("visible2"),
+                       NetworkReloadScheduler::kVisible);
+  EXPECT_EQ(4u, scheduler_->PendingCount());
+
+  // One reload per tick, |reload_interval_ms| apart
+  AdvanceBy(0);
+  EXPECT_EQ((std::vector<std::string>{"foreground"}), reloaded_);
+  AdvanceBy(100);
+  EXPECT_EQ(1u, reloaded_.size());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<std::string>{"foreground", "visible"}), reloaded_);
+  RunFor(1000);
+  EXPECT_EQ((std::vector<std::string>{"foreground", "visible", "visible2",
+                                      "background"}),
+            reloaded_);
+  EXPECT_EQ(0u, scheduler_->PendingCount());
+}
+
+TEST_F(NetworkReloadSchedulerTest, RaisingPriorityMovesThePageAhead) {
+  WebPageBaseMock* background = AddFailedPage("background");
+  scheduler_->Schedule(AddFailedPage("visible"),
+                       NetworkReloadScheduler::kVisible);
+  scheduler_->Schedule(background, NetworkReloadScheduler::kBackground);
+  scheduler_->Schedule(background, NetworkReloadScheduler::kForeground);
+  EXPECT_EQ(2u, scheduler_->PendingCount());
+
+  RunFor(1000);
+  EXPECT_EQ((std::vector<std::string>{"background", "visible"}), reloaded_);
+}
+
+TEST_F(NetworkReloadSchedulerTest, CapsConcurrentReloads) {
+  scheduler_->SetMaxConcurrentReloads(2);
+  for (const char* name : {"a", "b", "c"}) {
+    scheduler_->Schedule(AddFailedPage(name),
+                         NetworkReloadScheduler::kBackground);
+  }
+
+  RunFor(1000);
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), reloaded_);
+  EXPECT_EQ(2u, scheduler_->InFlightCount());
+  EXPECT_EQ(1u, scheduler_->PendingCount());
+
+  // A slot frees up once a reload completes
+  progress_["b"] = 100;
+  AdvanceBy(101);
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), reloaded_);
+}
+
+TEST_F(NetworkReloadSchedulerTest, StalledReloadFreesItsSlotOnTimeout) {
+  scheduler_->SetMaxConcurrentReloads(1);
+  scheduler_->SetReloadTimeoutMs(5000);
+  scheduler_->Schedule(AddFailedPage("stalled"),
+                       NetworkReloadScheduler::kForeground);
+  scheduler_->Schedule(AddFailedPage("next"),
+                       NetworkReloadScheduler::kBackground);
+
+  AdvanceBy(0);
+  EXPECT_EQ((std::vector<std::string>{"stalled"}), reloaded_);
+  progress_["stalled"] = 30;
+  RunFor(4900);
+  EXPECT_EQ(1u, reloaded_.size());
+
+  RunFor(200);
+  EXPECT_EQ((std::vector<std::string>{"stalled", "next"}), reloaded_);
+}
+
+TEST_F(NetworkReloadSchedulerTest, DeferredPageReloadsOnceShown) {
+  WebPageBaseMock* hidden = AddFailedPage("hidden");
+  scheduler_->Schedule(hidden, NetworkReloadScheduler::kBackground);
+  scheduler_->Defer(hidden);
+  EXPECT_TRUE(scheduler_->IsDeferred(hidden));
+  EXPECT_FALSE(scheduler_->IsScheduled(hidden));
+
+  RunFor(1000);
+  EXPECT_TRUE(reloaded_.empty());
+
+  scheduler_->PageShown(hidden);
+  EXPECT_FALSE(scheduler_->IsDeferred(hidden));
+  AdvanceBy(0);
+  EXPECT_EQ((std::vector<std::string>{"hidden"}), reloaded_);
+}
+
+TEST_F(NetworkReloadSchedulerTest, RemovedPageIsForgotten) {
+  WebPageBaseMock* removed = AddFailedPage("removed");
+  WebPageBaseMock* deferred = AddFailedPage("deferred");
+  scheduler_->Schedule(removed, NetworkReloadScheduler::kForeground);
+  scheduler_->Defer(deferred);
+
+  scheduler_->PageRemoved(removed);
+  scheduler_->PageRemoved(deferred);
+  EXPECT_EQ(0u, scheduler_->PendingCount());
+  EXPECT_FALSE(scheduler_->IsDeferred(deferred));
+  EXPECT_EQ(0u, wheel_.Size());
+
+  RunFor(1000);
+  EXPECT_TRUE(reloaded_.empty());
+}
+
+TEST_F(NetworkReloadSchedulerTest, RemovedPageFreesItsSlot) {
+  scheduler_->SetMaxConcurrentReloads(1);
+  WebPageBaseMock* first = AddFailedPage("first");
+  scheduler_->Schedule(first, NetworkReloadScheduler::kForeground);
+  scheduler_->Schedule(AddFailedPage("second"),
+                       NetworkReloadScheduler::kBackground);
+  AdvanceBy(0);
+  EXPECT_EQ(1u, scheduler_->InFlightCount());
+
+  scheduler_->PageRemoved(first);
+  EXPECT_EQ(0u, scheduler_->InFlightCount());
+  AdvanceBy(101);
+  EXPECT_EQ((std::vector<std::string>{"first", "second"}), reloaded_);
+}
+
+TEST_F(NetworkReloadSchedulerTest, SkipsPagesWhichRecoveredMeanwhile) {
+  WebPageBaseMock* recovered = AddFailedPage("recovered");
+  scheduler_->Schedule(recovered, NetworkReloadScheduler::kForeground);
+  scheduler_->Schedule(AddFailedPage("failed"),
+                       NetworkReloadScheduler::kBackground);
+  ON_CALL(*recovered, IsLoadErrorPageFinish()).WillByDefault(Return(false));
+
+  AdvanceBy(0);
+  EXPECT_EQ((std::vector<std::string>{"failed"}), reloaded_);
+}
@@ -18,6 +18,7 @@
 #include <json/json.h>
 
 #include "network_status.h"
+#include "network_status_manager.h"
 
 TEST(NetworkStatusTest, NetworkStatusTestConnection) {
   Json::Value json_information;
@@ -76,3 +77,29 @@ TEST(NetworkStatusTest, NetworkStatusTestNoConnection) {
   status.FromJsonObject(json_status);
   EXPECT_FALSE(status.IsInternetConnectionAvailable());
 }
+
+TEST(NetworkStatusTest, NetworkStatusManagerKeepsLastChangedStatus) {
+  Json::Value json_information;
+  json_information["ipAddress"] = "192.168.0.3";
+  json_information["gateway"] = "192.168.0.1";
+  json_information["state"] = "online";
+
+  Json::Value json_status;
+  json_status["returnValue"] = true;
+  json_status["isInternetConnectionAvailable"] = true;
+  json_status["wifi"] = json_information;
+
+  NetworkStatusManager manager;
+  NetworkStatus status;
+  status.FromJsonObject(json_status);
+  manager.UpdateNetworkStatus(status);
+  EXPECT_EQ("wifi", manager.Current().Type());
+  EXPECT_TRUE(manager.Current().IsInternetConnectionAvailable());
+  EXPECT_EQ("192.168.0.3", manager.Current().GetInformation().IpAddress());
+
+  json_status["wifi"]["ipAddress"] = "192.168.0.4";
+  status.FromJsonObject(json_status);
+  manager.UpdateNetworkStatus(status);
+  EXPECT_EQ("192.168.0.4", manager.Current().GetInformation().IpAddress());
+  EXPECT_EQ("192.168.0.1", manager.Current().GetInformation().Gateway());
+}
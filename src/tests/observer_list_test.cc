@@ -0,0 +1,224 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "observer_list.h"
+
+namespace {
+
+class Observer {
+ public:
+  explicit Observer(std::string name, std::vector<std::string>* log)
+      : name_(std::move(name)), log_(log) {}
+
+  void SetOnNotify(std::function<void()> on_notify) {
+    on_notify_ = std::move(on_notify);
+  }
+
+  void Notify() {
+    log_->push_back(name_);
+    if (on_notify_) {
+      on_notify_();
+    }
+  }
+
+ private:
+  std::string name_;
+  std::vector<std::string>* log_;
+  std::function<void()> on_notify_;
+};
+
+class ObserverListTest : public ::testing::Test {
+ protected:
+  Observer* Add(const std::string& name) {
+    observers_.push_back(std::make_unique<Observer>(name, &log_));
+    list_.AddObserver(observers_.back().get());
+    return observers_.back().get();
+  }
+
+  std::vector<std::string> Dispatch() {
+    log_.clear();
+    FOR_EACH_OBSERVER(Observer, list_, Notify());
+    return log_;
+  }
+
+  std::vector<std::string> log_;
+  std::vector<std::unique_ptr<Observer>> observers_;
+  ObserverList<Observer> list_;
+};
+
+}  // namespace
+
+TEST_F(ObserverListTest, NotifiesInAdditionOrder) {
+  Observer* a = Add("a");
+  Add("b");
+  Add("c");
+  // Adding twice has no effect
+  list_.AddObserver(a);
+  list_.AddObserver(nullptr);
+  EXPECT_EQ(3u, list_.Size());
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), Dispatch());
+
+  list_.RemoveObserver(a);
+  EXPECT_FALSE(list_.HasObserver(a));
+  EXPECT_EQ((std::vector<std::string>{"b", "c"}), Dispatch());
+  list_.Clear();
+  EXPECT_EQ(0u, list_.Size());
+  EXPECT_TRUE(Dispatch().empty());
+}
+
+TEST_F(ObserverListTest, RemovalDuringDispatch) {
+  Observer* a = Add("a");
+  Observer* b = Add("b");
+  Observer* c = Add("c");
+  Observer* d = Add("d");
+  // Removes itself and an observer which has not been notified yet
+  b->SetOnNotify([&]() {
+    list_.RemoveObserver(b);
+    list_.RemoveObserver(d);
+    EXPECT_EQ(2u, list_.Size());
+    EXPECT_FALSE(list_.HasObserver(d));
+  });
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), Dispatch());
+  EXPECT_TRUE(list_.HasObserver(a));
+  EXPECT_TRUE(list_.HasObserver(c));
+  EXPECT_EQ(2u, list_.Size());
+  EXPECT_EQ((std::vector<std::string>{"a", "c"}), Dispatch());
+}
+
+TEST_F(ObserverListTest, RemovedObserverMayBeDeleted) {
+  Add("a");
+  auto b = std::make_unique<Observer>("b", &log_);
+  list_.AddObserver(b.get());
+  observers_[0]->SetOnNotify([&]() {
+    list_.RemoveObserver(b.get());
+    b.reset();
+  });
+  EXPECT_EQ((std::vector<std::string>{"a"}), Dispatch());
+}
+
+TEST_F(ObserverListTest, AdditionDuringDispatch) {
+  Observer* a = Add("a");
+  Add("b");
+  auto late = std::make_unique<Observer>("late", &log_);
+  a->SetOnNotify([&]() { list_.AddObserver(late.get()); });
+
+  // Notified from the next dispatch on
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), Dispatch());
+  EXPECT_TRUE(list_.HasObserver(late.get()));
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "late"}), Dispatch());
+
+  // Removed and added back: not notified again by the same dispatch
+  a->SetOnNotify([&]() {
+    list_.RemoveObserver(a);
+    list_.AddObserver(a);
+  });
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "late"}), Dispatch());
+  a->SetOnNotify({});
+  EXPECT_EQ((std::vector<std::string>{"b", "late", "a"}), Dispatch());
+}
+
+TEST_F(ObserverListTest, ClearDuringDispatch) {
+  Observer* a = Add("a");
+  Add("b");
+  a->SetOnNotify([&]() { list_.Clear(); });
+  EXPECT_EQ((std::vector<std::string>{"a"}), Dispatch());
+  EXPECT_EQ(0u, list_.Size());
+  EXPECT_TRUE(Dispatch().empty());
+}
+
+TEST_F(ObserverListTest, NestedDispatch) {
+  Observer* a = Add("a");
+  Observer* b = Add("b");
+  Add("c");
+  bool nested = false;
+  a->SetOnNotify([&]() {
+    if (nested) {
+      return;
+    }
+    nested = true;
+    FOR_EACH_OBSERVER(Observer, list_, Notify());
+    // Removed after the inner dispatch, skipped by the outer one
+    list_.RemoveObserver(b);
+  });
+  EXPECT_EQ((std::vector<std::string>{"a", "a", "b", "c", "c"}), Dispatch());
+  EXPECT_EQ(2u, list_.Size());
+  EXPECT_EQ((std::vector<std::string>{"a", "c"}), Dispatch());
+}
+
+TEST_F(ObserverListTest, ListDestroyedDuringDispatch) {
+  std::vector<std::string> log;
+  auto list = std::make_unique<ObserverList<Observer>>();
+  Observer a("a", &log);
+  Observer b("b", &log);
+  a.SetOnNotify([&]() { list.reset(); });
+  list->AddObserver(&a);
+  list->AddObserver(&b);
+
+  {
+    ObserverList<Observer>::Iterator it(list.get());
+    while (Observer* observer = it.GetNext()) {
+      observer->Notify();
+    }
+  }
+  EXPECT_EQ((std::vector<std::string>{"a"}), log);
+}
+
+TEST(ObserverList, DISABLED_Benchmark) {
+  // Observers are called through an interface, like WebPageObserver
+  struct Counter {
+    virtual ~Counter() = default;
+    virtual void Notify() { ++count; }
+    int count = 0;
+  };
+  std::vector<Counter> counters(8);
+  ObserverList<Counter> list;
+  for (Counter& counter : counters) {
+    list.AddObserver(&counter);
+  }
+
+  // What FOR_EACH_OBSERVER used to do
+  constexpr int kDispatches = 1000000;
+  std::vector<Counter*> observers;
+  for (Counter& counter : counters) {
+    observers.push_back(&counter);
+  }
+  int64_t start = g_get_monotonic_time();
+  for (int i = 0; i < kDispatches; ++i) {
+    auto buffered_list = observers;
+    for (Counter* observer : buffered_list) {
+      observer->Notify();
+    }
+  }
+  int64_t copy_us = g_get_monotonic_time() - start;
+
+  start = g_get_monotonic_time();
+  for (int i = 0; i < kDispatches; ++i) {
+    FOR_EACH_OBSERVER(Counter, list, Notify());
+  }
+  int64_t list_us = g_get_monotonic_time() - start;
+
+  EXPECT_EQ(2 * kDispatches, counters[0].count);
+  printf("%d dispatches to %zu observers: copy %lld us, list %lld us\n",
+         kDispatches, list.Size(), static_cast<long long>(copy_us),
+         static_cast<long long>(list_us));
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <limits>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "service_stats.h"
+#include "web_app_manager_service_luna.h"
+
+TEST(Histogram, BucketIndex) {
+  EXPECT_EQ(0u, Histogram::BucketIndex(0));
+  EXPECT_EQ(1u, Histogram::BucketIndex(1));
+  EXPECT_EQ(2u, Histogram::BucketIndex(2));
+  EXPECT_EQ(2u, Histogram::BucketIndex(3));
+  EXPECT_EQ(3u, Histogram::BucketIndex(4));
+  EXPECT_EQ(11u, Histogram::BucketIndex(1024));
+  EXPECT_EQ(Histogram::kBucketCount - 1,
+            Histogram::BucketIndex(std::numeric_limits<uint64_t>::max()));
+
+  for (size_t i = 0; i < Histogram::kBucketCount - 1; ++i) {
+    EXPECT_EQ(i, Histogram::BucketIndex(Histogram::BucketUpperBound(i)));
+  }
+}
+
+TEST(Histogram, RecordAndReset) {
+  Histogram histogram;
+  EXPECT_EQ(0u, histogram.Count());
+  EXPECT_EQ(0u, histogram.Percentile(50));
+
+  for (uint64_t value = 1; value <= 100; ++value) {
+    histogram.Record(value);
+  }
+
+  EXPECT_EQ(100u, histogram.Count());
+  EXPECT_EQ(5050u, histogram.Sum());
+  EXPECT_EQ(100u, histogram.Max());
+  // 50 falls into [32, 64), 99 into [64, 128) capped by the maximum
+  EXPECT_EQ(63u, histogram.Percentile(50));
+  EXPECT_EQ(100u, histogram.Percentile(99));
+
+  Json::Value json = histogram.ToJson();
+  EXPECT_EQ(100u, json["count"].asUInt64());
+  ASSERT_TRUE(json["buckets"].isArray());
+  EXPECT_EQ(7u, json["buckets"].size());
+
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.Count());
+  EXPECT_EQ(0u, histogram.Sum());
+  EXPECT_EQ(0u, histogram.Max());
+  EXPECT_EQ(0u, histogram.ToJson()["buckets"].size());
+}
+
+TEST(ServiceStats, MethodsAndSubscriptions) {
+  ServiceStats stats;
+  stats.ForMethod("launchApp").latency_us.Record(1500);
+  stats.ForMethod("launchApp").reply_bytes.Record(80);
+  stats.ForSubscription("listRunningApps").reply_bytes.Record(4096);
+
+  EXPECT_EQ(&stats.ForMethod("launchApp"), &stats.ForMethod("launchApp"));
+
+  Json::Value json = stats.ToJson();
+  EXPECT_EQ(1u, json["methods"]["launchApp"]["latencyUs"]["count"].asUInt64());
+  EXPECT_EQ(80u, json["methods"]["launchApp"]["replyBytes"]["max"].asUInt64());
+  const Json::Value& subscription = json["subscriptions"]["listRunningApps"];
+  EXPECT_EQ(4096u, subscription["replyBytes"]["sum"].asUInt64());
+
+  stats.Reset();
+  EXPECT_EQ(0u, stats.ForMethod("launchApp").latency_us.Count());
+  EXPECT_EQ(0u, stats.ForSubscription("listRunningApps").reply_bytes.Count());
+}
+
+TEST(ServiceStats, GetServiceStats) {
+  WebAppManagerServiceLuna* service = WebAppManagerServiceLuna::Instance();
+  service->Stats().ForMethod("killApp").latency_us.Record(250);
+
+  Json::Value request;
+  ASSERT_TRUE(util::StringToJson(R"({"reset": true})", request));
+  Json::Value reply = service->getServiceStats(request);
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  EXPECT_EQ(1u, reply["methods"]["killApp"]["latencyUs"]["count"].asUInt64());
+  EXPECT_TRUE(reply["launches"]["waitMs"]["foreground"].isObject());
+
+  reply = service->getServiceStats(Json::Value(Json::objectValue));
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  EXPECT_EQ(0u, reply["methods"]["killApp"]["latencyUs"]["count"].asUInt64());
+
+  ASSERT_TRUE(util::StringToJson(R"({"reset": "yes"})", request));
+  reply = service->getServiceStats(request);
+  EXPECT_FALSE(reply["returnValue"].asBool());
+}
@@ -16,6 +16,15 @@
 
 #include "utils.h"
 
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(StringUtils, TrimTest) {
@@ -37,3 +46,229 @@ TEST(StringUtils, NoTrimTest) {
   std::string test_string = "test";
   EXPECT_EQ(util::TrimString(test_string), "test");
 }
+
+namespace {
+
+// The implementations util::SplitString(), TrimString() and ReplaceSubstr()
+// used to have
+std::vector<std::string> LegacySplitString(const std::string& str,
+                                           char delimiter) {
+  std::vector<std::string> res_list;
+  std::stringstream ss(str);
+  std::string s;
+
+  while (std::getline(ss, s, delimiter)) {
+    res_list.push_back(s);
+  }
+
+  return res_list;
+}
+
+std::string LegacyTrimString(const std::string& str) {
+  auto begin = str.begin();
+  auto end = str.end();
+
+  while (begin != end && isspace(static_cast<unsigned char>(*begin))) {
+    ++begin;
+  }
+
+  while (begin != end && isspace(static_cast<unsigned char>(*(end - 1)))) {
+    --end;
+  }
+
+  return std::string(begin, end);
+}
+
+void LegacyReplaceSubstr(std::string& in,
+                         const std::string& to_search,
+                         const std::string& replace_str) {
+  size_t pos = in.find(to_search);
+  while (pos != std::string::npos) {
+    in.replace(pos, to_search.size(), replace_str);
+    pos = in.find(to_search, pos + replace_str.size());
+  }
+}
+
+std::string RandomString(std::mt19937& random,
+                         const char* alphabet,
+                         size_t max_size) {
+  std::uniform_int_distribution<size_t> size(0, max_size);
+  std::uniform_int_distribution<size_t> index(0, strlen(alphabet) - 1);
+  std::string value(size(random), '\0');
+  for (char& c : value) {
+    c = alphabet[index(random)];
+  }
+  return value;
+}
+
+}  // namespace
+
+TEST(StringUtils, SplitMatchesLegacy) {
+  std::mt19937 random(46);
+  for (int i = 0; i < 5000; ++i) {
+    std::string str = RandomString(random, "ab,,", 12);
+    std::vector<std::string> pieces;
+    for (std::string_view piece : util::Split(str, ',')) {
+      pieces.emplace_back(piece);
+    }
+    ASSERT_EQ(pieces, LegacySplitString(str, ',')) << str;
+    ASSERT_EQ(util::SplitString(str, ','), LegacySplitString(str, ','))
+        << str;
+  }
+}
+
+TEST(StringUtils, Split) {
+  std::vector<std::string_view> pieces;
+  for (std::string_view piece : util::Split("a,,b,", ',')) {
+    pieces.push_back(piece);
+  }
+  EXPECT_EQ(pieces, (std::vector<std::string_view>{"a", "", "b"}));
+
+  auto split = util::Split("", ',');
+  EXPECT_EQ(split.begin(), split.end());
+  split = util::Split(",", ',');
+  ASSERT_NE(split.begin(), split.end());
+  EXPECT_EQ(*split.begin(), "");
+  EXPECT_EQ(++split.begin(), split.end());
+}
+
+TEST(StringUtils, TrimMatchesLegacy) {
+  std::mt19937 random(47);
+  for (int i = 0; i < 5000; ++i) {
+    std::string str = RandomString(random, " \t\n\v\f\rab", 10);
+    ASSERT_EQ(util::Trim(str), LegacyTrimString(str)) << str;
+    std::string trimmed = str;
+    util::TrimInPlace(trimmed);
+    ASSERT_EQ(trimmed, LegacyTrimString(str)) << str;
+  }
+}
+
+TEST(StringUtils, ReplaceSubstrMatchesLegacy) {
+  std::mt19937 random(48);
+  for (int i = 0; i < 5000; ++i) {
+    std::string str = RandomString(random, "aab*\\", 16);
+    std::string to_search = RandomString(random, "ab*", 3);
+    if (to_search.empty()) {
+      continue;
+    }
+    std::string replace_str = RandomString(random, "ab*", 3);
+
+    std::string expected = str;
+    LegacyReplaceSubstr(expected, to_search, replace_str);
+    std::string replaced = str;
+    util::ReplaceSubstr(replaced, to_search, replace_str);
+    ASSERT_EQ(replaced, expected) << str << " " << to_search;
+  }
+}
+
+TEST(StringUtils, ReplaceAllMatchesNaiveScan) {
+  std::mt19937 random(50);
+  for (int i = 0; i < 5000; ++i) {
+    std::string str = RandomString(random, "abcdefx", 16);
+    // Up to six patterns, so that both ways of finding candidates are used
+    std::string patterns[6];
+    std::string replacements[6];
+    for (size_t j = 0; j < 6; ++j) {
+      patterns[j] = RandomString(random, "abcdef", 2);
+      replacements[j] = RandomString(random, "xy", 2);
+    }
+    std::initializer_list<util::Replacement> list = {
+        {patterns[0], replacements[0]}, {patterns[1], replacements[1]},
+        {patterns[2], replacements[2]}, {patterns[3], replacements[3]},
+        {patterns[4], replacements[4]}, {patterns[5], replacements[5]}};
+
+    std::string expected;
+    for (size_t at = 0; at < str.size();) {
+      const util::Replacement* match = nullptr;
+      for (const util::Replacement& replacement : list) {
+        if (!replacement.first.empty() &&
+            std::string_view(str).substr(at, replacement.first.size()) ==
+                replacement.first) {
+          match = &replacement;
+          break;
+        }
+      }
+      if (match) {
+        expected += match->second;
+        at += match->first.size();
+      } else {
+        expected += str[at++];
+      }
+    }
+
+    std::string out;
+    util::ReplaceAll(str, list, out);
+    ASSERT_EQ(out, expected) << str;
+  }
+}
+
+TEST(StringUtils, ReplaceAll) {
+  std::string out = "> ";
+  util::ReplaceAll("it's a\\b\n", {{"\\", "\\\\"}, {"'", "\\'"}, {"\n", "\\n"}},
+                   out);
+  EXPECT_EQ(out, "> it\\'s a\\\\b\\n");
+
+  // The first listed pattern wins, empty patterns never match
+  out.clear();
+  util::ReplaceAll("aab", {{"", "x"}, {"a", "1"}, {"aa", "2"}}, out);
+  EXPECT_EQ(out, "11b");
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST(StringUtils, DISABLED_Benchmark) {
+  using std::chrono::steady_clock;
+  const int kIterations = 100000;
+  std::mt19937 random(49);
+  std::string list;
+  for (int i = 0; i < 8; ++i) {
+    list += " com.webos.app.item" + std::to_string(i) + "* ,";
+  }
+  // A few quotes in a long value, as in launch parameters
+  std::string escaped = RandomString(random, "abcdefghijklmnopqrstuvwxyz",
+                                     4096);
+  escaped[100] = '\'';
+  escaped[2000] = '\\';
+  size_t sink = 0;
+
+  auto per_call = [](steady_clock::duration duration) {
+    return std::chrono::duration<double, std::nano>(duration).count() /
+           kIterations;
+  };
+
+  auto start = steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const std::string& piece : LegacySplitString(list, ',')) {
+      sink += LegacyTrimString(piece).size();
+    }
+  }
+  auto legacy_split = steady_clock::now() - start;
+  start = steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (std::string_view piece : util::Split(list, ',')) {
+      sink += util::Trim(piece).size();
+    }
+  }
+  auto split = steady_clock::now() - start;
+
+  start = steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    std::string value = escaped;
+    LegacyReplaceSubstr(value, "\\", "\\\\");
+    LegacyReplaceSubstr(value, "'", "\\'");
+    sink += value.size();
+  }
+  auto legacy_replace = steady_clock::now() - start;
+  std::string buffer;
+  start = steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    buffer.clear();
+    util::ReplaceAll(escaped, {{"\\", "\\\\"}, {"'", "\\'"}}, buffer);
+    sink += buffer.size();
+  }
+  auto replace = steady_clock::now() - start;
+
+  printf("split+trim: legacy %.0f ns, views %.0f ns\n", per_call(legacy_split),
+         per_call(split));
+  printf("replace: legacy %.0f ns, single pass %.0f ns (%zu)\n",
+         per_call(legacy_replace), per_call(replace), sink);
+}
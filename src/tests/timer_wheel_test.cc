@@ -0,0 +1,566 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "timer.h"
+#include "timer_wheel.h"
+
+namespace {
+
+class FakeClock {
+ public:
+  TimerWheel::Clock AsClock() {
+    return [this]() { return now_; };
+  }
+  int64_t Now() const { return now_; }
+  void Set(int64_t now) { now_ = now; }
+
+ private:
+  int64_t now_ = 1000;
+};
+
+class CallbackEntry : public TimerWheel::Entry {
+ public:
+  explicit CallbackEntry(std::function<void()> callback = {})
+      : callback_(std::move(callback)) {}
+
+  void SetCallback(std::function<void()> callback) {
+    callback_ = std::move(callback);
+  }
+
+ protected:
+  void Fire(TimerWheel*) override {
+    if (callback_) {
+      callback_();
+    }
+  }
+
+ private:
+  std::function<void()> callback_;
+};
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  TimerWheelTest() : wheel_(clock_.AsClock()) {}
+
+  // Moves the clock and fires what is due, like the main loop would
+  void AdvanceBy(int64_t ms) {
+    clock_.Set(clock_.Now() + ms);
+    wheel_.AdvanceTo(clock_.Now());
+  }
+
+  FakeClock clock_;
+  TimerWheel wheel_;
+  std::vector<std::string> fired_;
+};
+
+class Receiver {
+ public:
+  void OnTimeout() { ++timeouts; }
+  void OnTimeoutDeleteTimer() {
+    ++timeouts;
+    timer.reset();
+  }
+
+  int timeouts = 0;
+  std::unique_ptr<OneShotTimer<Receiver>> timer;
+};
+
+class LaunchTracker {
+ public:
+  explicit LaunchTracker(TimerWheel* wheel) : wheel_(wheel) {}
+
+  void OnTimeout() { finished_at.push_back(wheel_->Now()); }
+
+  std::vector<int64_t> finished_at;
+
+ private:
+  TimerWheel* wheel_;
+};
+
+}  // namespace
+
+TEST_F(TimerWheelTest, FiresInDeadlineOrder) {
+  CallbackEntry a([this]() { fired_.push_back("a"); });
+  CallbackEntry b([this]() { fired_.push_back("b"); });
+  CallbackEntry c([this]() { fired_.push_back("c"); });
+  wheel_.Schedule(&a, 30);
+  wheel_.Schedule(&b, 10);
+  wheel_.Schedule(&c, 20);
+  EXPECT_EQ(3u, wheel_.Size());
+  EXPECT_EQ(clock_.Now() + 11, wheel_.NextDeadline());
+
+  AdvanceBy(10);
+  EXPECT_TRUE(fired_.empty());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<std::string>{"b"}), fired_);
+  AdvanceBy(100);
+  EXPECT_EQ((std::vector<std::string>{"b", "c", "a"}), fired_);
+  EXPECT_EQ(0u, wheel_.Size());
+  EXPECT_EQ(-1, wheel_.NextDeadline());
+}
+
+TEST_F(TimerWheelTest, SameDeadlineFiresInScheduleOrder) {
+  std::vector<std::unique_ptr<CallbackEntry>> entries;
+  for (int i = 0; i < 5; ++i) {
+    entries.push_back(std::make_unique<CallbackEntry>(
+        [this, i]() { fired_.push_back(std::to_string(i)); }));
+    wheel_.Schedule(entries.back().get(), 5000);
+  }
+
+  AdvanceBy(5001);
+  EXPECT_EQ((std::vector<std::string>{"0", "1", "2", "3", "4"}), fired_);
+}
+
+TEST_F(TimerWheelTest, CancelAndReschedule) {
+  CallbackEntry a([this]() { fired_.push_back("a"); });
+  CallbackEntry b([this]() { fired_.push_back("b"); });
+  wheel_.Schedule(&a, 10);
+  wheel_.Schedule(&b, 10);
+  wheel_.Cancel(&a);
+  EXPECT_FALSE(a.IsScheduled());
+  EXPECT_TRUE(b.IsScheduled());
+
+  // Rescheduling moves the deadline instead of adding a second one
+  wheel_.Schedule(&b, 50);
+  wheel_.Schedule(&b, 70);
+  EXPECT_EQ(1u, wheel_.Size());
+
+  AdvanceBy(70);
+  EXPECT_TRUE(fired_.empty());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<std::string>{"b"}), fired_);
+  EXPECT_FALSE(b.IsScheduled());
+}
+
+TEST_F(TimerWheelTest, DestroyedEntryIsCancelled) {
+  auto entry =
+      std::make_unique<CallbackEntry>([this]() { fired_.push_back("a"); });
+  wheel_.Schedule(entry.get(), 10);
+  entry.reset();
+  EXPECT_EQ(0u, wheel_.Size());
+  AdvanceBy(100);
+  EXPECT_TRUE(fired_.empty());
+}
+
+TEST_F(TimerWheelTest, CascadesAcrossLevels) {
+  const int64_t delays[] = {63, 64, 65, 4095, 4096, 5000, 300000, 262144};
+  std::vector<std::unique_ptr<CallbackEntry>> entries;
+  std::map<int64_t, int64_t> fired_at;
+  const int64_t start = clock_.Now();
+  for (int64_t delay : delays) {
+    entries.push_back(std::make_unique<CallbackEntry>(
+        [this, &fired_at, delay]() { fired_at[delay] = clock_.Now(); }));
+    wheel_.Schedule(entries.back().get(), delay);
+  }
+
+  // One millisecond at a time, every entry fires on its own tick
+  while (wheel_.Size()) {
+    AdvanceBy(1);
+  }
+  for (int64_t delay : delays) {
+    EXPECT_EQ(start + delay + 1, fired_at[delay]) << delay;
+  }
+}
+
+TEST_F(TimerWheelTest, FiresLateWhenTheLoopWasBusy) {
+  CallbackEntry a([this]() { fired_.push_back("a"); });
+  CallbackEntry b([this]() { fired_.push_back("b"); });
+  wheel_.Schedule(&a, 100000);
+  wheel_.Schedule(&b, 20);
+
+  // A single jump well past both deadlines still fires them in order
+  AdvanceBy(200000);
+  EXPECT_EQ((std::vector<std::string>{"b", "a"}), fired_);
+}
+
+TEST_F(TimerWheelTest, DeadlinesBeyondTheWheelRange) {
+  const int64_t kRange = int64_t{1}
+                         << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+  CallbackEntry far([this]() { fired_.push_back("far"); });
+  CallbackEntry farther([this]() { fired_.push_back("farther"); });
+  wheel_.Schedule(&farther, 3 * kRange + 17);
+  wheel_.Schedule(&far, kRange + 5);
+  EXPECT_EQ(clock_.Now() + kRange + 6, wheel_.NextDeadline());
+
+  AdvanceBy(kRange + 5);
+  EXPECT_TRUE(fired_.empty());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<std::string>{"far"}), fired_);
+  AdvanceBy(2 * kRange + 11);
+  EXPECT_EQ(1u, fired_.size());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<std::string>{"far", "farther"}), fired_);
+}
+
+TEST_F(TimerWheelTest, ZeroDelayFiresOnTheNextAdvance) {
+  CallbackEntry a, b([this]() { fired_.push_back("b"); });
+  a.SetCallback([&]() {
+    fired_.push_back("a");
+    wheel_.Schedule(&b, 0);
+  });
+  wheel_.Schedule(&a, 0);
+  EXPECT_EQ(clock_.Now(), wheel_.NextDeadline());
+
+  // Like g_timeout_add(0), on the next iteration of the loop
+  wheel_.AdvanceTo(clock_.Now());
+  EXPECT_EQ((std::vector<std::string>{"a"}), fired_);
+  EXPECT_TRUE(b.IsScheduled());
+  wheel_.AdvanceTo(clock_.Now());
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), fired_);
+  EXPECT_EQ(0u, wheel_.Size());
+
+  wheel_.Schedule(&a, 0);
+  wheel_.Cancel(&a);
+  EXPECT_EQ(-1, wheel_.NextDeadline());
+}
+
+TEST(TimerWheel, ApplySlack) {
+  EXPECT_EQ(1000, TimerWheel::ApplySlack(1000, 0));
+  // Never earlier than the deadline, never later than the slack allows
+  std::mt19937 random(47);
+  for (int i = 0; i < 10000; ++i) {
+    int64_t deadline = random() % 10000000;
+    int64_t slack = random() % 2000;
+    int64_t slacked = TimerWheel::ApplySlack(deadline, slack);
+    EXPECT_GE(slacked, deadline);
+    EXPECT_LE(slacked, deadline + slack);
+  }
+  // Deadlines close to each other end up equal
+  EXPECT_EQ(TimerWheel::ApplySlack(60013, 1000),
+            TimerWheel::ApplySlack(60300, 1000));
+}
+
+TEST_F(TimerWheelTest, SlackCoalescesDeadlines) {
+  CallbackEntry a([this]() { fired_.push_back("a"); });
+  CallbackEntry b([this]() { fired_.push_back("b"); });
+  // Due at 60013 and 60300
+  wheel_.Schedule(&a, 60012 - clock_.Now(), 1000);
+  wheel_.Schedule(&b, 60299 - clock_.Now(), 1000);
+  EXPECT_EQ(a.Deadline(), b.Deadline());
+  EXPECT_GE(a.Deadline(), 60300);
+  EXPECT_LE(a.Deadline(), 61013);
+
+  AdvanceBy(a.Deadline() - clock_.Now());
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), fired_);
+}
+
+TEST_F(TimerWheelTest, CallbacksMayScheduleAndCancel) {
+  CallbackEntry a, b, c, d;
+  a.SetCallback([&]() {
+    fired_.push_back("a");
+    if (fired_.size() > 1) {
+      return;
+    }
+    // Due in the same tick, cancelled before it fires
+    wheel_.Cancel(&b);
+    wheel_.Schedule(&c, 5);
+    wheel_.Schedule(&a, 0);
+    // Advancing from a callback is a no-op
+    wheel_.AdvanceTo(clock_.Now() + 1000);
+  });
+  b.SetCallback([&]() { fired_.push_back("b"); });
+  c.SetCallback([&]() { fired_.push_back("c"); wheel_.Cancel(&a); });
+  d.SetCallback([&]() { fired_.push_back("d"); });
+  wheel_.Schedule(&a, 10);
+  wheel_.Schedule(&b, 10);
+  wheel_.Schedule(&d, 12);
+
+  AdvanceBy(11);
+  EXPECT_EQ((std::vector<std::string>{"a"}), fired_);
+  EXPECT_TRUE(a.IsScheduled());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<std::string>{"a", "a"}), fired_);
+  AdvanceBy(100);
+  EXPECT_EQ((std::vector<std::string>{"a", "a", "d", "c"}), fired_);
+  EXPECT_EQ(0u, wheel_.Size());
+}
+
+TEST_F(TimerWheelTest, CallbackMayDeleteLaterEntries) {
+  auto b = std::make_unique<CallbackEntry>([this]() { fired_.push_back("b"); });
+  CallbackEntry a([&]() {
+    fired_.push_back("a");
+    b.reset();
+  });
+  wheel_.Schedule(&a, 10);
+  wheel_.Schedule(b.get(), 10);
+
+  AdvanceBy(11);
+  EXPECT_EQ((std::vector<std::string>{"a"}), fired_);
+  EXPECT_EQ(0u, wheel_.Size());
+}
+
+TEST_F(TimerWheelTest, MatchesSortedReference) {
+  constexpr int kEntries = 200;
+  std::mt19937 random(20261019);
+  std::vector<std::unique_ptr<CallbackEntry>> entries;
+  std::map<int, int64_t> expected;  // entry -> deadline
+  std::vector<std::pair<int64_t, int>> fired;
+
+  for (int i = 0; i < kEntries; ++i) {
+    entries.push_back(std::make_unique<CallbackEntry>([&, i]() {
+      EXPECT_EQ(expected[i], clock_.Now()) << i;
+      fired.emplace_back(clock_.Now(), i);
+      expected.erase(i);
+    }));
+  }
+
+  for (int round = 0; round < 2000; ++round) {
+    int i = random() % kEntries;
+    switch (random() % 4) {
+      case 0:
+      case 1: {
+        // Mostly short delays, some in the upper levels
+        int64_t delay =
+            1 + (random() % 8 ? random() % 300 : random() % 400000);
+        wheel_.Schedule(entries[i].get(), delay);
+        expected[i] = clock_.Now() + delay + 1;
+        break;
+      }
+      case 2:
+        wheel_.Cancel(entries[i].get());
+        expected.erase(i);
+        break;
+      case 3:
+        // Step by step, so that every entry fires exactly on its deadline
+        for (int64_t step = random() % 200; step > 0; --step) {
+          AdvanceBy(1);
+        }
+        break;
+    }
+    ASSERT_EQ(expected.size(), wheel_.Size());
+    int64_t next = -1;
+    for (const auto& entry : expected) {
+      if (next < 0 || entry.second < next) {
+        next = entry.second;
+      }
+    }
+    ASSERT_EQ(next, wheel_.NextDeadline());
+  }
+
+  while (wheel_.Size()) {
+    clock_.Set(wheel_.NextDeadline());
+    wheel_.AdvanceTo(clock_.Now());
+  }
+  EXPECT_TRUE(expected.empty());
+  EXPECT_TRUE(std::is_sorted(fired.begin(), fired.end(),
+                             [](const auto& a, const auto& b) {
+                               return a.first < b.first;
+                             }));
+}
+
+TEST_F(TimerWheelTest, Timers) {
+  TimerWheel::SetDefaultForTesting(&wheel_);
+  Receiver receiver;
+
+  OneShotTimer<Receiver> one_shot;
+  one_shot.StartWithReceiver(100, &receiver, &Receiver::OnTimeout);
+  // Restarting a running timer moves its deadline
+  AdvanceBy(50);
+  one_shot.StartWithReceiver(100, &receiver, &Receiver::OnTimeout);
+  EXPECT_EQ(1u, wheel_.Size());
+  AdvanceBy(100);
+  EXPECT_EQ(0, receiver.timeouts);
+  AdvanceBy(1);
+  EXPECT_EQ(1, receiver.timeouts);
+  EXPECT_FALSE(one_shot.IsRunning());
+
+  RepeatingTimer<Receiver> repeating;
+  repeating.StartWithReceiver(10, &receiver, &Receiver::OnTimeout);
+  for (int i = 0; i < 5; ++i) {
+    AdvanceBy(11);
+  }
+  EXPECT_EQ(6, receiver.timeouts);
+  EXPECT_TRUE(repeating.IsRunning());
+  repeating.Stop();
+  AdvanceBy(100);
+  EXPECT_EQ(6, receiver.timeouts);
+
+  // Deletes itself once fired
+  SingleShotTimer<Receiver>::SingleShot(10, &receiver, &Receiver::OnTimeout);
+  AdvanceBy(11);
+  EXPECT_EQ(7, receiver.timeouts);
+  EXPECT_EQ(0u, wheel_.Size());
+
+  // Deleted from its own callback
+  receiver.timer = std::make_unique<OneShotTimer<Receiver>>();
+  receiver.timer->StartWithReceiver(10, &receiver,
+                                    &Receiver::OnTimeoutDeleteTimer);
+  AdvanceBy(11);
+  EXPECT_EQ(8, receiver.timeouts);
+  EXPECT_FALSE(receiver.timer);
+
+  // Running timers are cancelled when destroyed
+  {
+    OneShotTimer<Receiver> destroyed;
+    destroyed.StartWithReceiver(10, &receiver, &Receiver::OnTimeout);
+  }
+  EXPECT_EQ(0u, wheel_.Size());
+
+  TimerWheel::SetDefaultForTesting(nullptr);
+}
+
+TEST_F(TimerWheelTest, ExtendingDeadlineTimerOnlyRecordsTheDeadline) {
+  TimerWheel::SetDefaultForTesting(&wheel_);
+  LaunchTracker tracker(&wheel_);
+  DeadlineTimer<LaunchTracker> timer;
+
+  timer.ExtendWithReceiver(100, &tracker, &LaunchTracker::OnTimeout);
+  int64_t scheduled = timer.Deadline();
+  AdvanceBy(50);
+  timer.ExtendWithReceiver(100, &tracker, &LaunchTracker::OnTimeout);
+  EXPECT_EQ(scheduled, timer.Deadline());
+
+  // Fires early and waits for the rest
+  AdvanceBy(51);
+  EXPECT_TRUE(tracker.finished_at.empty());
+  EXPECT_TRUE(timer.IsRunning());
+  AdvanceBy(49);
+  EXPECT_TRUE(tracker.finished_at.empty());
+  AdvanceBy(1);
+  EXPECT_EQ((std::vector<int64_t>{clock_.Now()}), tracker.finished_at);
+  EXPECT_FALSE(timer.IsRunning());
+
+  // A closer deadline reschedules the timer
+  timer.ExtendWithReceiver(100, &tracker, &LaunchTracker::OnTimeout);
+  timer.ExtendWithReceiver(10, &tracker, &LaunchTracker::OnTimeout);
+  AdvanceBy(11);
+  EXPECT_EQ(2u, tracker.finished_at.size());
+
+  // Stopped until extended again
+  timer.ExtendWithReceiver(10, &tracker, &LaunchTracker::OnTimeout);
+  timer.Stop();
+  AdvanceBy(100);
+  EXPECT_EQ(2u, tracker.finished_at.size());
+  EXPECT_EQ(0u, wheel_.Size());
+
+  TimerWheel::SetDefaultForTesting(nullptr);
+}
+
+TEST_F(TimerWheelTest, DeadlineTimerMatchesRestartedTimer) {
+  TimerWheel::SetDefaultForTesting(&wheel_);
+  constexpr int kTimeoutMs = 300;
+  LaunchTracker restarted_tracker(&wheel_);
+  LaunchTracker extended_tracker(&wheel_);
+  OneShotTimer<LaunchTracker> restarted;
+  DeadlineTimer<LaunchTracker> extended;
+
+  std::mt19937 random(48);
+  for (int frame = 0; frame < 2000; ++frame) {
+    restarted.Stop();
+    restarted.StartWithReceiver(kTimeoutMs, &restarted_tracker,
+                                &LaunchTracker::OnTimeout);
+    extended.ExtendWithReceiver(kTimeoutMs, &extended_tracker,
+                                &LaunchTracker::OnTimeout);
+
+    // Mostly frames, now and then a pause longer than the timeout
+    int64_t gap = random() % 20 ? 1 + random() % 32 : 250 + random() % 100;
+    for (; gap > 0; --gap) {
+      AdvanceBy(1);
+    }
+  }
+  AdvanceBy(kTimeoutMs + 1);
+
+  EXPECT_FALSE(restarted_tracker.finished_at.empty());
+  EXPECT_EQ(restarted_tracker.finished_at, extended_tracker.finished_at);
+  EXPECT_FALSE(extended.IsRunning());
+
+  TimerWheel::SetDefaultForTesting(nullptr);
+}
+
+TEST(TimerWheel, DefaultWheelRunsFromTheMainLoop) {
+  Receiver receiver;
+  OneShotTimer<Receiver> late;
+  OneShotTimer<Receiver> early;
+  late.StartWithReceiver(30, &receiver, &Receiver::OnTimeout);
+  early.StartWithReceiver(10, &receiver, &Receiver::OnTimeout);
+
+  ElapsedTimer elapsed;
+  elapsed.Start();
+  int64_t start = g_get_monotonic_time();
+  while (receiver.timeouts < 1) {
+    g_main_context_iteration(nullptr, TRUE);
+  }
+  EXPECT_TRUE(late.IsRunning());
+  while (receiver.timeouts < 2) {
+    g_main_context_iteration(nullptr, TRUE);
+  }
+  EXPECT_GE(g_get_monotonic_time() - start, 30 * 1000);
+}
+
+TEST(TimerWheel, DISABLED_Benchmark) {
+  // Restarting many running timers, e.g. a timeout pushed back on every
+  // frame, used to add and remove a GSource each time
+  constexpr int kTimers = 1000;
+  constexpr int kRestarts = 100;
+  Receiver receiver;
+  std::vector<std::unique_ptr<OneShotTimer<Receiver>>> timers;
+  for (int i = 0; i < kTimers; ++i) {
+    timers.push_back(std::make_unique<OneShotTimer<Receiver>>());
+  }
+
+  int64_t start = g_get_monotonic_time();
+  for (int round = 0; round < kRestarts; ++round) {
+    for (auto& timer : timers) {
+      timer->StartWithReceiver(1000 + round, &receiver,
+                               &Receiver::OnTimeout);
+    }
+  }
+  int64_t elapsed = g_get_monotonic_time() - start;
+  printf("%d timer restarts: %lld us\n", kTimers * kRestarts,
+         static_cast<long long>(elapsed));
+  for (auto& timer : timers) {
+    timer->Stop();
+  }
+}
+
+TEST(TimerWheel, DISABLED_DeadlineTimerBenchmark) {
+  // A launch timeout pushed back on every frame
+  constexpr int kFrames = 1000000;
+  Receiver receiver;
+  OneShotTimer<Receiver> restarted;
+  DeadlineTimer<Receiver> extended;
+
+  int64_t start = g_get_monotonic_time();
+  for (int frame = 0; frame < kFrames; ++frame) {
+    restarted.Stop();
+    restarted.StartWithReceiver(3000, &receiver, &Receiver::OnTimeout);
+  }
+  int64_t restart_us = g_get_monotonic_time() - start;
+
+  start = g_get_monotonic_time();
+  for (int frame = 0; frame < kFrames; ++frame) {
+    extended.ExtendWithReceiver(3000, &receiver, &Receiver::OnTimeout);
+  }
+  int64_t extend_us = g_get_monotonic_time() - start;
+
+  printf("%d frames: restart %lld us, extend %lld us\n", kFrames,
+         static_cast<long long>(restart_us),
+         static_cast<long long>(extend_us));
+  restarted.Stop();
+  extended.Stop();
+}
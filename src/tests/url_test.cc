@@ -14,11 +14,16 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <regex>
 #include <string>
 
 #include <gtest/gtest.h>
 
 #include "url.h"
+#include "utils.h"
 
 namespace {
 
@@ -39,6 +44,162 @@ const char* kFileWithHost = "file://server/foo.html";
 const char* kFileWithQueryAndFragment = "file:///foo.html?f=v#fragment";
 const char* kFileName = "/usr/opt/webos test#?%/test.txt";
 
+// wam::Url and util::GetHostname as they were before the hand-written
+// parser, the references for the randomized tests below
+struct LegacyUrl {
+  explicit LegacyUrl(const std::string& uri) {
+    auto sub = [&uri](std::size_t start, std::size_t end) {
+      return uri.substr(
+          start, end == std::string::npos ? uri.size() - start : end - start);
+    };
+
+    auto scheme_delimiter = uri.find(':');
+    if (scheme_delimiter != std::string::npos) {
+      scheme = uri.substr(0, scheme_delimiter);
+    }
+
+    auto authority_start = uri.find("//");
+    if (authority_start != std::string::npos) {
+      authority_start += 2;
+    }
+    auto authority_end = uri.find_first_of("/?#", authority_start);
+
+    if (authority_start != std::string::npos) {
+      auto host_start = authority_start;
+      auto user_info_end = uri.find('@', authority_start);
+      if (user_info_end != std::string::npos) {
+        host_start = user_info_end + 1;
+      }
+      auto host_end = uri.find_first_of(":/?#", host_start);
+      if (host_start != std::string::npos) {
+        host = sub(host_start, host_end);
+      }
+      if (host_end != std::string::npos && uri[host_end] == ':') {
+        port = sub(host_end + 1, authority_end);
+      }
+    }
+
+    auto path_end = uri.find_first_of("?#", authority_end);
+    base = sub(0, path_end);
+
+    if (authority_start == std::string::npos) {
+      path = uri.substr(scheme_delimiter + 1, uri.size() - scheme_delimiter);
+    } else if (authority_end != std::string::npos) {
+      if (uri[authority_end] == '/') {
+        path = sub(authority_end, path_end);
+      }
+      auto query_start = uri.find("?", authority_end);
+      if (query_start != std::string::npos) {
+        query = sub(query_start, uri.find("#", query_start));
+      }
+      auto fragment_start = uri.find("#", authority_end);
+      if (fragment_start != std::string::npos) {
+        fragment = sub(fragment_start, uri.size());
+      }
+    }
+  }
+
+  std::string base;
+  std::string scheme;
+  std::string host;
+  std::string port;
+  std::string path;
+  std::string query;
+  std::string fragment;
+};
+
+std::string LegacyGetHostname(const std::string& url) {
+  if (url.empty()) {
+    return std::string();
+  }
+  std::regex rfc3986_regex(
+      R"(^(([^:\/?#]+):)?(\/\/([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
+  std::regex authority_regex(R"(^(?:[\w\:]+[@])?([\w.]+)(?:[:])?(?:[0-9]+)?)");
+  std::smatch matches;
+  if (!std::regex_match(url, matches, rfc3986_regex)) {
+    return std::string();
+  }
+  std::string authority = matches[4];
+  if (!std::regex_match(authority, matches, authority_regex)) {
+    return std::string();
+  }
+  return matches[1];
+}
+
+// Well-formed lowercase URLs built from random components, within the
+// syntax both the legacy and the current parsers handle the same way: no
+// query or fragment without an authority, '@' only ending the user info,
+// hosts and user info of word characters.
+class UrlGenerator {
+ public:
+  explicit UrlGenerator(uint32_t seed) : engine_(seed) {}
+
+  std::string Next() {
+    static const char* kSchemes[] = {"http", "https", "file", "about",
+                                     "ftp",  "ws",    "custom+x"};
+    std::string url = Pick(kSchemes) + ":";
+    bool has_authority = Chance(4, 5);
+    if (has_authority) {
+      url += "//";
+      if (Chance(1, 5)) {
+        url += Word("abcxyz_019") + (Chance(1, 2) ? ":" + Word("pw_9") : "");
+        url += '@';
+      }
+      if (Chance(9, 10)) {
+        url += Word("abcdefghijklmnopqrstuvwxyz0123456789.");
+      }
+      if (Chance(1, 4)) {
+        url += ":" + std::to_string(Number(0, 65535));
+      }
+    }
+
+    int segments = Number(0, 4);
+    for (int i = 0; i < segments; ++i) {
+      url += "/" + Word("abcXYZ019-._~%20");
+    }
+    if (has_authority && Chance(1, 3)) {
+      url += "?" + Word("abc=&;019/?");
+    }
+    if (has_authority && Chance(1, 3)) {
+      url += "#" + Word("abc019/#");
+    }
+    return url;
+  }
+
+  // Arbitrary strings of URL delimiters and a few other characters
+  std::string NextNoise() {
+    std::string noise;
+    int length = Number(0, 24);
+    for (int i = 0; i < length; ++i) {
+      noise += Pick(":/?#@[]%.aB9");
+    }
+    return noise;
+  }
+
+ private:
+  template <size_t N>
+  std::string Pick(const char* (&choices)[N]) {
+    return choices[Number(0, N - 1)];
+  }
+  char Pick(const std::string& alphabet) {
+    return alphabet[Number(0, alphabet.size() - 1)];
+  }
+  std::string Word(const std::string& alphabet) {
+    std::string word;
+    int length = Number(1, 8);
+    for (int i = 0; i < length; ++i) {
+      word += Pick(alphabet);
+    }
+    return word;
+  }
+  int Number(int min, int max) {
+    return std::uniform_int_distribution<int>(min, max)(engine_);
+  }
+  bool Chance(int in, int out) { return Number(1, out) <= in; }
+
+  std::mt19937 engine_;
+};
+
 }  // namespace
 
 TEST(UrlTest, Scheme) {
@@ -156,3 +317,145 @@ TEST(UrlTest, FileName) {
   wam::Url file_with_host_url(kFileWithHost);
   EXPECT_EQ(file_with_host_url.FileName(), "foo.html");
 }
+
+TEST(UrlTest, LowercasesSchemeAndHost) {
+  wam::Url url("HTTPS://User@Example.COM:8080/Path?Q=V#Frag");
+  EXPECT_EQ("https", url.Scheme());
+  EXPECT_EQ("example.com", url.Host());
+  EXPECT_EQ("/Path", url.Path());
+  EXPECT_EQ("?Q=V", url.Query());
+  EXPECT_EQ("https://User@example.com:8080/Path?Q=V#Frag", url.ToString());
+}
+
+TEST(UrlTest, IpLiteralHost) {
+  wam::Url url("http://[::1]:8080/index.html");
+  EXPECT_EQ("[::1]", url.Host());
+  EXPECT_EQ("8080", url.Port());
+  EXPECT_EQ("/index.html", url.Path());
+}
+
+TEST(UrlTest, AtSignOutsideAuthority) {
+  wam::Url url("https://google.com/mail@home?to=a@b");
+  EXPECT_EQ("google.com", url.Host());
+  EXPECT_EQ("/mail@home", url.Path());
+}
+
+TEST(UrlTest, QueryAndFragmentWithoutAuthority) {
+  wam::Url url("about:blank?x=1#top");
+  EXPECT_EQ("blank", url.Path());
+  EXPECT_EQ("?x=1", url.Query());
+  EXPECT_EQ("#top", url.Fragment());
+  EXPECT_EQ("about:blank?x=1#top", url.ToString());
+}
+
+TEST(UrlTest, SetQueryWithoutFragment) {
+  wam::Url url("file:///foo.html?old");
+  url.SetQuery({{"a", "1"}});
+  EXPECT_EQ("file:///foo.html?a=1", url.ToString());
+  EXPECT_EQ("", url.Fragment());
+
+  url.SetQuery({});
+  EXPECT_EQ("file:///foo.html", url.ToString());
+  EXPECT_EQ("", url.Query());
+}
+
+TEST(UrlTest, Escape) {
+  EXPECT_EQ("azAZ09-._~", wam::Url::Escape("azAZ09-._~"));
+  EXPECT_EQ("a%20b%2F%3F%26%3D%25", wam::Url::Escape("a b/?&=%"));
+  // Valid UTF-8 is kept, malformed bytes are escaped
+  EXPECT_EQ("\xC3\xA9t\xC3\xA9", wam::Url::Escape("\xC3\xA9t\xC3\xA9"));
+  EXPECT_EQ("%FF%C3", wam::Url::Escape("\xFF\xC3"));
+  EXPECT_EQ("%C0%AF", wam::Url::Escape("\xC0\xAF"));
+  EXPECT_EQ("%ED%A0%80", wam::Url::Escape("\xED\xA0\x80"));
+  EXPECT_EQ("\xF0\x9F\x98\x80", wam::Url::Escape("\xF0\x9F\x98\x80"));
+}
+
+TEST(UrlTest, GetHostname) {
+  EXPECT_EQ("", util::GetHostname(""));
+  EXPECT_EQ("", util::GetHostname("file:///usr/share/index.html"));
+  EXPECT_EQ("www.lg.com", util::GetHostname("https://www.lg.com/uk/support"));
+  EXPECT_EQ("my-host.com",
+            util::GetHostname("http://user:pw@my-host.com:80/?a=b"));
+}
+
+TEST(UrlTest, MatchesLegacyParserOnRandomUrls) {
+  UrlGenerator generator(20211);
+  // Bounded by the cost of the legacy regex
+  for (int i = 0; i < 2000; ++i) {
+    std::string uri = generator.Next();
+    SCOPED_TRACE(uri);
+
+    wam::Url url(uri);
+    LegacyUrl legacy(uri);
+    ASSERT_EQ(legacy.scheme, url.Scheme());
+    ASSERT_EQ(legacy.host, url.Host());
+    ASSERT_EQ(legacy.port, url.Port());
+    ASSERT_EQ(legacy.path, url.Path());
+    ASSERT_EQ(legacy.query, url.Query());
+    ASSERT_EQ(legacy.fragment, url.Fragment());
+    ASSERT_EQ(legacy.base + legacy.query + legacy.fragment, url.ToString());
+    ASSERT_EQ(LegacyGetHostname(uri), util::GetHostname(uri));
+  }
+}
+
+TEST(UrlTest, ComponentsCoverArbitraryInput) {
+  UrlGenerator generator(20212);
+  for (int i = 0; i < 20000; ++i) {
+    std::string uri = generator.NextNoise();
+    SCOPED_TRACE(uri);
+
+    wam::Url url(uri);
+    const std::string& spec = url.ToString();
+    ASSERT_EQ(uri.size(), spec.size());
+    // Components are in order, and path, query and fragment end the URI
+    const char* end = spec.data();
+    for (std::string_view component : {url.Scheme(), url.Host(), url.Port(),
+                                       url.Path(), url.Query(),
+                                       url.Fragment()}) {
+      if (component.empty()) {
+        continue;
+      }
+      ASSERT_GE(component.data(), end);
+      ASSERT_LE(component.data() + component.size(), spec.data() + spec.size());
+      end = component.data() + component.size();
+    }
+    ASSERT_EQ(url.Path().size() + url.Query().size() + url.Fragment().size(),
+              spec.data() + spec.size() - url.Path().data());
+  }
+}
+
+// Not run by default: --gtest_also_run_disabled_tests --gtest_filter=*Bench*
+TEST(UrlTest, DISABLED_Benchmark) {
+  UrlGenerator generator(20213);
+  std::vector<std::string> urls;
+  for (int i = 0; i < 10000; ++i) {
+    urls.push_back(generator.Next());
+  }
+
+  auto measure = [&urls](const char* name, auto&& parse) {
+    auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (int round = 0; round < 10; ++round) {
+      for (const std::string& url : urls) {
+        checksum += parse(url);
+      }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() / 10 << " us per "
+              << urls.size() << " URLs (" << checksum << ")" << std::endl;
+  };
+
+  measure("wam::Url", [](const std::string& url) {
+    return wam::Url(url).Host().size();
+  });
+  measure("LegacyUrl", [](const std::string& url) {
+    return LegacyUrl(url).host.size();
+  });
+  measure("util::GetHostname", [](const std::string& url) {
+    return util::GetHostname(url).size();
+  });
+  measure("LegacyGetHostname", [](const std::string& url) {
+    return LegacyGetHostname(url).size();
+  });
+}
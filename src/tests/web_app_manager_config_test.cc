@@ -14,7 +14,14 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
 #include <gtest/gtest.h>
+#include <json/value.h>
 
 #include "web_app_manager_config_mock.h"
 
@@ -28,12 +35,41 @@ const std::map<std::string, std::string> kEnvironmentVariables = {
     {"LAUNCH_TIME_CHECK", "1"},
     {"USE_SYSTEM_APP_OPTIMIZATION", "1"},
     {"ENABLE_LAUNCH_OPTIMIZATION", "1"},
+    {"WAM_NETWORK_RELOAD_MAX_CONCURRENT", "4"},
+    {"WAM_NETWORK_RELOAD_INTERVAL_IN_MS", "1000"},
+    {"WAM_NETWORK_STATUS_DEBOUNCE_IN_MS", "0"},
+    {"WAM_MAX_CONCURRENT_LAUNCHES", "3"},
+    {"WAM_DEFER_PRELOADS", "1"},
+    {"WAM_PRELOAD_IDLE_THRESHOLD", "150"},
+    {"WAM_PRELOAD_RELEASE_INTERVAL_IN_MS", "2000"},
+    {"WAM_PRELOAD_ORDER", "minimal,full"},
+    {"WAM_LAUNCH_TIMELINE_COUNT", "-5"},
+    {"WAM_MAIN_LOOP_LAG_THRESHOLD_IN_MS", "150"},
+    {"WAM_LUNA_DISPATCH_THREAD", "1"},
     {"WEBAPPFACTORY", "Some.types.definition.string"},
     {"WEBAPPFACTORY_PLUGIN_PATH", "/usr/lib/webappmanager/alternate_plugins"},
     {"WEBPROCESS_CONFIGURATION_PATH", "/etc/wam/com.webos.wam.extended.json"},
     {"WAM_ERROR_PAGE", "https://www.lg.com/uk/support"},
     {"USER_SCRIPT_PATH", "webOSUserScripts/userScriptModified.js"},
-    {"WAM_NAME", "Testing"}};
+    {"WAM_NAME", "Testing"},
+    {"PRIVILEGED_PLUGIN_PATH", "/usr/lib/privileged_plugins"},
+    {"WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES", "0"},
+    {"WAM_KEEP_RTC_CONNECTIONS_ON_SUSPEND", "1"},
+    {"LAUNCH_FINISH_ASSURE_TIMEOUT", "2500"},
+    {"ENABLE_CURSOR_BY_DEFAULT", "1"}};
+
+std::string WriteTempFile(const std::string& content) {
+  char path[] = "/tmp/wam_config_testXXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    return std::string();
+  }
+  close(fd);
+
+  std::ofstream file(path);
+  file << content;
+  return path;
+}
 
 }  // namespace
 
@@ -161,3 +197,223 @@ TEST_F(WebAppManagerConfigTest, checkNameIfNotDefined) {
 TEST_F(WebAppManagerConfigTest, checkNameIfDefined) {
   EXPECT_STREQ("Testing", config_with_set_variables_.GetName().c_str());
 }
+
+TEST_F(WebAppManagerConfigTest, checkNetworkReloadMaxConcurrentIfNotDefined) {
+  EXPECT_EQ(2, config_with_no_variables_.GetNetworkReloadMaxConcurrent());
+}
+
+TEST_F(WebAppManagerConfigTest, checkNetworkReloadMaxConcurrentIfDefined) {
+  EXPECT_EQ(4, config_with_set_variables_.GetNetworkReloadMaxConcurrent());
+}
+
+TEST_F(WebAppManagerConfigTest, checkNetworkReloadIntervalMsIfNotDefined) {
+  EXPECT_EQ(300, config_with_no_variables_.GetNetworkReloadIntervalMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkNetworkReloadIntervalMsIfDefined) {
+  EXPECT_EQ(1000, config_with_set_variables_.GetNetworkReloadIntervalMs());
+}
+
+TEST_F(WebAppManagerConfigTest,
+       checkNetworkStatusDebounceIntervalMsIfNotDefined) {
+  EXPECT_EQ(500,
+            config_with_no_variables_.GetNetworkStatusDebounceIntervalMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkNetworkStatusDebounceIntervalMsIfDefined) {
+  EXPECT_EQ(0, config_with_set_variables_.GetNetworkStatusDebounceIntervalMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkMaxConcurrentLaunchesIfNotDefined) {
+  EXPECT_EQ(0, config_with_no_variables_.GetMaxConcurrentLaunches());
+}
+
+TEST_F(WebAppManagerConfigTest, checkMaxConcurrentLaunchesIfDefined) {
+  EXPECT_EQ(3, config_with_set_variables_.GetMaxConcurrentLaunches());
+}
+
+TEST_F(WebAppManagerConfigTest, checkPreloadDeferralIfNotDefined) {
+  EXPECT_FALSE(config_with_no_variables_.IsDeferPreloadsEnabled());
+  EXPECT_EQ(50, config_with_no_variables_.GetPreloadIdleThreshold());
+  EXPECT_EQ(1000, config_with_no_variables_.GetPreloadReleaseIntervalMs());
+  EXPECT_STREQ("full,semi-full,partial,minimal",
+               config_with_no_variables_.GetPreloadOrder().c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkPreloadDeferralIfDefined) {
+  EXPECT_TRUE(config_with_set_variables_.IsDeferPreloadsEnabled());
+  // Clamped to a percentage
+  EXPECT_EQ(100, config_with_set_variables_.GetPreloadIdleThreshold());
+  EXPECT_EQ(2000, config_with_set_variables_.GetPreloadReleaseIntervalMs());
+  EXPECT_STREQ("minimal,full",
+               config_with_set_variables_.GetPreloadOrder().c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLaunchTimelineCountIfNotDefined) {
+  EXPECT_EQ(50, config_with_no_variables_.GetLaunchTimelineCount());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLaunchTimelineCountIfDefined) {
+  // Negative counts disable recording
+  EXPECT_EQ(0, config_with_set_variables_.GetLaunchTimelineCount());
+}
+
+TEST_F(WebAppManagerConfigTest, checkMainLoopLagThresholdMsIfNotDefined) {
+  // The watchdog is off unless a threshold is set
+  EXPECT_EQ(0, config_with_no_variables_.GetMainLoopLagThresholdMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkMainLoopLagThresholdMsIfDefined) {
+  EXPECT_EQ(150, config_with_set_variables_.GetMainLoopLagThresholdMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLunaDispatchThreadIfNotDefined) {
+  EXPECT_FALSE(config_with_no_variables_.IsLunaDispatchThreadEnabled());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLunaDispatchThreadIfDefined) {
+  EXPECT_TRUE(config_with_set_variables_.IsLunaDispatchThreadEnabled());
+}
+
+TEST_F(WebAppManagerConfigTest, checkPrivilegedPluginPathIfNotDefined) {
+  EXPECT_STREQ("", config_with_no_variables_.GetPrivilegedPluginPath().c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkPrivilegedPluginPathIfDefined) {
+  EXPECT_STREQ("/usr/lib/privileged_plugins",
+               config_with_set_variables_.GetPrivilegedPluginPath().c_str());
+}
+
+TEST_F(WebAppManagerConfigTest,
+       checkDefaultAllowThirdPartyCookiesIfNotDefined) {
+  EXPECT_TRUE(config_with_no_variables_.IsDefaultAllowThirdPartyCookies());
+}
+
+TEST_F(WebAppManagerConfigTest, checkDefaultAllowThirdPartyCookiesIfDefined) {
+  EXPECT_FALSE(config_with_set_variables_.IsDefaultAllowThirdPartyCookies());
+}
+
+TEST_F(WebAppManagerConfigTest, checkKeepRtcConnectionsOnSuspendIfNotDefined) {
+  EXPECT_FALSE(config_with_no_variables_.IsKeepRtcConnectionsOnSuspend());
+}
+
+TEST_F(WebAppManagerConfigTest, checkKeepRtcConnectionsOnSuspendIfDefined) {
+  EXPECT_TRUE(config_with_set_variables_.IsKeepRtcConnectionsOnSuspend());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLaunchFinishAssureTimeoutIfNotDefined) {
+  EXPECT_EQ(5000, config_with_no_variables_.GetLaunchFinishAssureTimeoutMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLaunchFinishAssureTimeoutIfDefined) {
+  EXPECT_EQ(2500, config_with_set_variables_.GetLaunchFinishAssureTimeoutMs());
+}
+
+TEST_F(WebAppManagerConfigTest, checkCursorEnabledByDefaultIfNotDefined) {
+  EXPECT_FALSE(config_with_no_variables_.IsCursorEnabledByDefault());
+}
+
+TEST_F(WebAppManagerConfigTest, checkCursorEnabledByDefaultIfDefined) {
+  EXPECT_TRUE(config_with_set_variables_.IsCursorEnabledByDefault());
+}
+
+TEST_F(WebAppManagerConfigTest, checkToJson) {
+  Json::Value json = config_with_set_variables_.ToJson();
+  EXPECT_EQ("Testing", json["WAM_NAME"].asString());
+  EXPECT_EQ(4, json["WAM_NETWORK_RELOAD_MAX_CONCURRENT"].asInt());
+  EXPECT_TRUE(json["LOAD_DYNAMIC_PLUGGABLE"].asBool());
+  EXPECT_FALSE(json["WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES"].asBool());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLoadFromFileOverridesEnvironment) {
+  std::string path = WriteTempFile(
+      "{\"WAM_NAME\": \"Overridden\", \"LOAD_DYNAMIC_PLUGGABLE\": false, "
+      "\"WAM_NETWORK_RELOAD_INTERVAL_IN_MS\": 50}");
+  ASSERT_FALSE(path.empty());
+
+  EXPECT_TRUE(config_with_set_variables_.LoadFromFile(path));
+  EXPECT_STREQ(path.c_str(),
+               config_with_set_variables_.GetOverridePath().c_str());
+  EXPECT_STREQ("Overridden", config_with_set_variables_.GetName().c_str());
+  EXPECT_FALSE(config_with_set_variables_.IsDynamicPluggableLoadEnabled());
+  EXPECT_EQ(50, config_with_set_variables_.GetNetworkReloadIntervalMs());
+  // Keys missing from the file still come from the environment
+  EXPECT_EQ(4, config_with_set_variables_.GetNetworkReloadMaxConcurrent());
+
+  // An empty path drops the overrides
+  EXPECT_TRUE(config_with_set_variables_.LoadFromFile(std::string()));
+  EXPECT_STREQ("Testing", config_with_set_variables_.GetName().c_str());
+  EXPECT_TRUE(config_with_set_variables_.IsDynamicPluggableLoadEnabled());
+
+  std::remove(path.c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkOverrideFileAppliesAtConstruction) {
+  std::string path = WriteTempFile("{\"WAM_NAME\": \"Overridden\"}");
+  ASSERT_FALSE(path.empty());
+
+  WebAppManagerConfigMock config(&kEnvironmentVariables, path);
+  EXPECT_STREQ("Overridden", config.GetName().c_str());
+  EXPECT_STREQ(path.c_str(), config.GetOverridePath().c_str());
+  // Keys missing from the file still come from the environment
+  EXPECT_EQ(4, config.GetNetworkReloadMaxConcurrent());
+  std::remove(path.c_str());
+
+  // A missing file is ignored
+  WebAppManagerConfigMock without_file(&kEnvironmentVariables, path);
+  EXPECT_STREQ("Testing", without_file.GetName().c_str());
+  EXPECT_STREQ("", without_file.GetOverridePath().c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLoadFromFileKeepsInspectorAndDevMode) {
+  config_with_set_variables_.AddPreference(
+      "/var/luna/preferences/debug_system_apps");
+  config_with_set_variables_.AddPreference(
+      "/var/luna/preferences/devmode_enabled");
+  config_with_set_variables_.PostInitConfiguration();
+  ASSERT_TRUE(config_with_set_variables_.IsInspectorEnabled());
+  ASSERT_TRUE(config_with_set_variables_.IsDevModeEnabled());
+
+  std::string path = WriteTempFile(
+      "{\"WAM_NAME\": \"Overridden\", \"TELLURIUM_NUB_PATH\": \"/tmp/x\"}");
+  ASSERT_FALSE(path.empty());
+
+  EXPECT_TRUE(config_with_set_variables_.LoadFromFile(path));
+  EXPECT_STREQ("Overridden", config_with_set_variables_.GetName().c_str());
+  EXPECT_TRUE(config_with_set_variables_.IsInspectorEnabled());
+  EXPECT_TRUE(config_with_set_variables_.IsDevModeEnabled());
+  EXPECT_STREQ("", config_with_set_variables_.GetTelluriumNubPath().c_str());
+
+  // Nor does a later PostInitConfiguration() take the nub from the file
+  config_with_set_variables_.PostInitConfiguration();
+  EXPECT_STREQ("", config_with_set_variables_.GetTelluriumNubPath().c_str());
+
+  std::remove(path.c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkReloadWithoutOverrideFile) {
+  std::string path = WriteTempFile("{\"WAM_NAME\": \"Overridden\"}");
+  ASSERT_FALSE(path.empty());
+  EXPECT_TRUE(config_with_set_variables_.LoadFromFile(path));
+  std::remove(path.c_str());
+
+  if (access(WebAppManagerConfig::kOverrideFilePath, F_OK) == 0) {
+    GTEST_SKIP() << "System override file present";
+  }
+  // The overrides go away with the system override file
+  EXPECT_TRUE(config_with_set_variables_.Reload());
+  EXPECT_STREQ("", config_with_set_variables_.GetOverridePath().c_str());
+  EXPECT_STREQ("Testing", config_with_set_variables_.GetName().c_str());
+}
+
+TEST_F(WebAppManagerConfigTest, checkLoadFromFileRejectsInvalidFile) {
+  std::string path = WriteTempFile("{\"WAM_NAME\": {\"nested\": 1}}");
+  ASSERT_FALSE(path.empty());
+
+  EXPECT_FALSE(config_with_set_variables_.LoadFromFile(path));
+  EXPECT_STREQ("Testing", config_with_set_variables_.GetName().c_str());
+  EXPECT_STREQ("", config_with_set_variables_.GetOverridePath().c_str());
+
+  std::remove(path.c_str());
+  EXPECT_FALSE(config_with_set_variables_.LoadFromFile(path));
+}
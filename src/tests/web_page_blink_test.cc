@@ -16,6 +16,7 @@
 
 #include <string>
 
+#include <glib.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -99,6 +100,11 @@ class WebViewFactoryMock : public WebViewFactory {
 
 WebViewFactoryMock::WebViewFactoryMock() : web_view_(new NiceWebViewMock()) {}
 
+void RunPendingEvents() {
+  while (g_main_context_iteration(nullptr, FALSE)) {
+  }
+}
+
 }  // namespace
 
 class WebPageBlinkTestSuite : public ::testing::Test {
@@ -182,6 +188,10 @@ TEST_F(WebPageBlinkTestSuite, PriviledgetPluginPath) {
     test_value = actual_value;
   }
 
+  // The configuration resolves the environment when platform modules are set
+  WebAppManager::Instance()->SetPlatformModules(
+      std::make_unique<PlatformModuleFactoryImpl>());
+
   EXPECT_CALL(*factory->web_view_, AddAvailablePluginDir(test_value));
 
   WebPageBlink web_page(wam::Url(description->EntryPoint()), description,
@@ -243,3 +253,39 @@ TEST_F(WebPageBlinkTestSuite, addUserScript) {
     ASSERT_FALSE(result);
   }
 }
+
+TEST_F(WebPageBlinkTestSuite, PreferenceChangesAreFlushedOnce) {
+  WebViewMock* web_view = factory->web_view_;
+  WebPageBlink web_page(wam::Url(description->EntryPoint()), description,
+                        params.c_str(), std::move(factory));
+  web_page.Init();
+  RunPendingEvents();
+  ::testing::Mock::VerifyAndClearExpectations(web_view);
+
+  EXPECT_CALL(*web_view, UpdatePreferences()).Times(1);
+  web_page.SetAudioGuidanceOn(true);
+  web_page.SetKeepAliveWebApp(true);
+  RunPendingEvents();
+}
+
+TEST_F(WebPageBlinkTestSuite, PreferenceUpdateTransaction) {
+  WebViewMock* web_view = factory->web_view_;
+  WebPageBlink web_page(wam::Url(description->EntryPoint()), description,
+                        params.c_str(), std::move(factory));
+  web_page.Init();
+  RunPendingEvents();
+  ::testing::Mock::VerifyAndClearExpectations(web_view);
+
+  EXPECT_CALL(*web_view, UpdatePreferences()).Times(0);
+  web_page.BeginPreferenceUpdate();
+  web_page.BeginPreferenceUpdate();
+  web_page.SetAudioGuidanceOn(true);
+  web_page.EndPreferenceUpdate();
+  web_page.SetKeepAliveWebApp(true);
+  RunPendingEvents();
+  ::testing::Mock::VerifyAndClearExpectations(web_view);
+
+  EXPECT_CALL(*web_view, UpdatePreferences()).Times(1);
+  web_page.EndPreferenceUpdate();
+  RunPendingEvents();
+}
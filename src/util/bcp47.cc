@@ -16,45 +16,244 @@
 
 #include "bcp47.h"
 
+#include <array>
+#include <cstdint>
 #include <memory>
-#include <regex>
 #include <string>
+#include <string_view>
+
+namespace {
+
+// Character classes of the subtag grammar
+enum CharClass : uint8_t {
+  kLower = 1 << 0,
+  kUpper = 1 << 1,
+  kDigit = 1 << 2,
+  kAlpha = kLower | kUpper,
+};
+
+constexpr std::array<uint8_t, 256> MakeCharClasses() {
+  std::array<uint8_t, 256> classes{};
+  for (int c = 'a'; c <= 'z'; ++c) {
+    classes[c] = kLower;
+    classes[c - 'a' + 'A'] = kUpper;
+  }
+  for (int c = '0'; c <= '9'; ++c) {
+    classes[c] = kDigit;
+  }
+  return classes;
+}
+
+constexpr std::array<uint8_t, 256> kCharClasses = MakeCharClasses();
+
+// Kinds of subtags of a langtag, RFC 5646 section 2.1. Language, extlang
+// and region have to be in the case of the registry, like resource
+// directories: "en", "US".
+enum Kind {
+  kLanguage = 0,      // 2*8ALPHA
+  kExtlang,           // 3ALPHA, at most three after a 2*3ALPHA language
+  kScript,            // 4ALPHA
+  kRegion,            // 2ALPHA / 3DIGIT
+  kVariant,           // 5*8alphanum / (DIGIT 3alphanum)
+  kSingleton,         // alphanum but "x", starts an extension
+  kExtension,         // 2*8alphanum
+  kPrivateUse,        // "x"
+  kPrivateUseSubtag,  // 1*8alphanum
+  kKindCount
+};
+
+constexpr uint16_t Bit(Kind kind) {
+  return static_cast<uint16_t>(1 << kind);
+}
+
+// Subtag kinds which may follow each kind. The kinds allowed after any
+// given kind never match the same subtag, so their order does not matter.
+constexpr std::array<uint16_t, kKindCount> kNextKinds = {
+    /* kLanguage */ Bit(kExtlang) | Bit(kScript) | Bit(kRegion) |
+        Bit(kVariant) | Bit(kSingleton) | Bit(kPrivateUse),
+    /* kExtlang */ Bit(kExtlang) | Bit(kScript) | Bit(kRegion) |
+        Bit(kVariant) | Bit(kSingleton) | Bit(kPrivateUse),
+    /* kScript */ Bit(kRegion) | Bit(kVariant) | Bit(kSingleton) |
+        Bit(kPrivateUse),
+    /* kRegion */ Bit(kVariant) | Bit(kSingleton) | Bit(kPrivateUse),
+    /* kVariant */ Bit(kVariant) | Bit(kSingleton) | Bit(kPrivateUse),
+    /* kSingleton */ Bit(kExtension),
+    /* kExtension */ Bit(kExtension) | Bit(kSingleton) | Bit(kPrivateUse),
+    /* kPrivateUse */ Bit(kPrivateUseSubtag),
+    /* kPrivateUseSubtag */ Bit(kPrivateUseSubtag),
+};
+
+// Kinds a tag may end with: singletons need at least one subtag
+constexpr uint16_t kFinalKinds =
+    static_cast<uint16_t>(~(Bit(kSingleton) | Bit(kPrivateUse)));
+
+bool AllOf(std::string_view subtag, uint8_t classes) {
+  for (char c : subtag) {
+    if (!(kCharClasses[static_cast<unsigned char>(c)] & classes)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Matches(Kind kind, std::string_view subtag) {
+  size_t size = subtag.size();
+  switch (kind) {
+    case kLanguage:
+      return size >= 2 && size <= 8 && AllOf(subtag, kLower);
+    case kExtlang:
+      return size == 3 && AllOf(subtag, kLower);
+    case kScript:
+      return size == 4 && AllOf(subtag, kAlpha);
+    case kRegion:
+      return (size == 2 && AllOf(subtag, kUpper)) ||
+             (size == 3 && AllOf(subtag, kDigit));
+    case kVariant:
+      return ((size >= 5 && size <= 8) ||
+              (size == 4 && AllOf(subtag.substr(0, 1), kDigit))) &&
+             AllOf(subtag, kAlpha | kDigit);
+    case kSingleton:
+      return size == 1 && AllOf(subtag, kAlpha | kDigit) &&
+             subtag[0] != 'x' && subtag[0] != 'X';
+    case kExtension:
+      return size >= 2 && size <= 8 && AllOf(subtag, kAlpha | kDigit);
+    case kPrivateUse:
+      return size == 1 && (subtag[0] == 'x' || subtag[0] == 'X');
+    case kPrivateUseSubtag:
+      return size >= 1 && size <= 8 && AllOf(subtag, kAlpha | kDigit);
+    default:
+      return false;
+  }
+}
+
+char ToLower(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+char ToUpper(char c) {
+  return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (ToLower(a[i]) != ToLower(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Scripts are taken in any case and kept in the registry one: "Hant"
+void AssignTitle(std::string& to, std::string_view subtag) {
+  to.assign(subtag.data(), subtag.size());
+  for (char& c : to) {
+    c = ToLower(c);
+  }
+  to[0] = ToUpper(to[0]);
+}
+
+}  // namespace
 
 BCP47::BCP47() = default;
 BCP47::~BCP47() = default;
 
 std::unique_ptr<BCP47> BCP47::FromString(const std::string& bcp47_string) {
-  if (bcp47_string.empty()) {
+  // We parse language tags according to rfc5646 in a single pass over the
+  // subtags, checking each against the kinds allowed after the previous
+  // one. The tag format is:
+  //   language [- extlang] [- script] [- region] *(- variant)
+  //   *(- extension) [- privateuse]
+  // Only language, script and region are kept. Tags made of private use
+  // subtags only and the irregular grandfathered tags have no language
+  // and are rejected.
+  std::string_view tag(bcp47_string);
+  if (tag.empty()) {
     return nullptr;
   }
 
-  // We should parse language tag according to rfc5646
-  // In general the tag format is: language - script - region
-  // language - 2*3ALPHA - shortest ISO 639 code
-  // script - 4ALPHA - ISO 15924 code
-  // region - 2ALPHA / 3DIGIT  - ISO 3166-1 code
-
-  // Actual values of all pocible pieces located at
-  // https://www.iana.org/assignments/language-subtag-registry/language-subtag-registry
-  // But we will just use regex for parsing
-
-  // first group - mandatory 2 or 3 letters - represents language
-  // second group - optional 4 letters - represents script
-  // third group - optional 2 letters OR 3 digits - represents region
-  std::regex rfc5646_regex(
-      R"(^([a-z]{2,3})(?:[\-]{1}([A-z]{4}))?(?:[\-]{1}([A-Z]{2}|[0-9]{3}))?$)");
-  std::smatch match;
-  if (!std::regex_match(bcp47_string, match, rfc5646_regex)) {
-    return nullptr;
-  }
+  // Parsed on the stack, so that rejected tags allocate nothing
+  BCP47 parsed;
+  // Singletons seen so far, one bit per alphanum
+  uint64_t singletons = 0;
+  // Variants seen so far, to reject repeated ones
+  std::array<std::string_view, 8> variants;
+  size_t variant_count = 0;
+  int extlang_count = 0;
+  int previous = -1;
+
+  size_t begin = 0;
+  while (begin <= tag.size()) {
+    size_t end = tag.find('-', begin);
+    if (end == std::string_view::npos) {
+      end = tag.size();
+    }
+    std::string_view subtag = tag.substr(begin, end - begin);
+
+    uint16_t allowed =
+        previous < 0 ? Bit(kLanguage) : kNextKinds[previous];
+    if (previous == kLanguage && parsed.language_.size() > 3) {
+      allowed &= ~Bit(kExtlang);
+    }
+    if (extlang_count == 3) {
+      allowed &= ~Bit(kExtlang);
+    }
 
-  auto result = std::unique_ptr<BCP47>(new BCP47());
+    int kind = 0;
+    while (kind < kKindCount &&
+           !((allowed & Bit(static_cast<Kind>(kind))) &&
+             Matches(static_cast<Kind>(kind), subtag))) {
+      ++kind;
+    }
 
-  result->language_ = match[1];
-  result->script_ = match[2];
-  result->region_ = match[3];
+    switch (kind) {
+      case kLanguage:
+        parsed.language_.assign(subtag.data(), subtag.size());
+        break;
+      case kExtlang:
+        ++extlang_count;
+        break;
+      case kScript:
+        AssignTitle(parsed.script_, subtag);
+        break;
+      case kRegion:
+        parsed.region_.assign(subtag.data(), subtag.size());
+        break;
+      case kVariant:
+        for (size_t i = 0; i < variant_count; ++i) {
+          if (EqualsIgnoreCase(variants[i], subtag)) {
+            return nullptr;
+          }
+        }
+        if (variant_count < variants.size()) {
+          variants[variant_count++] = subtag;
+        }
+        break;
+      case kSingleton: {
+        char c = ToLower(subtag[0]);
+        int bit = c <= '9' ? c - '0' : c - 'a' + 10;
+        if (singletons & (uint64_t{1} << bit)) {
+          return nullptr;
+        }
+        singletons |= uint64_t{1} << bit;
+        break;
+      }
+      case kKindCount:
+        return nullptr;
+      default:
+        break;
+    }
 
-  return result;
+    previous = kind;
+    begin = end + 1;
+  }
+
+  if (!(kFinalKinds & Bit(static_cast<Kind>(previous)))) {
+    return nullptr;
+  }
+  return std::unique_ptr<BCP47>(new BCP47(parsed));
 }
 
 bool BCP47::HasLanguage() const {
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "context_task_queue.h"
+
+#include <utility>
+
+#include <glib.h>
+
+ContextTaskQueue::ContextTaskQueue(GMainContext* context)
+    : context_(context ? g_main_context_ref(context)
+                       : g_main_context_ref(g_main_context_default())) {}
+
+ContextTaskQueue::~ContextTaskQueue() {
+  GSource* source = g_main_context_find_source_by_user_data(context_, this);
+  if (source) {
+    g_source_destroy(source);
+  }
+  g_main_context_unref(context_);
+
+  Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+  while (node) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+void ContextTaskQueue::Post(Task task) {
+  Node* node = new Node{std::move(task), head_.load(std::memory_order_relaxed)};
+  while (!head_.compare_exchange_weak(node->next, node,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+  }
+
+  if (wakeup_scheduled_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  GSource* source = g_idle_source_new();
+  g_source_set_priority(source, G_PRIORITY_DEFAULT);
+  g_source_set_callback(source, &ContextTaskQueue::OnWakeup, this, nullptr);
+  g_source_attach(source, context_);
+  g_source_unref(source);
+}
+
+size_t ContextTaskQueue::RunPendingTasks() {
+  Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+
+  // The list is in reverse posting order
+  Node* ordered = nullptr;
+  while (node) {
+    Node* next = node->next;
+    node->next = ordered;
+    ordered = node;
+    node = next;
+  }
+
+  size_t count = 0;
+  while (ordered) {
+    Node* next = ordered->next;
+    ordered->task();
+    delete ordered;
+    ordered = next;
+    ++count;
+  }
+  return count;
+}
+
+int ContextTaskQueue::OnWakeup(void* data) {
+  ContextTaskQueue* queue = static_cast<ContextTaskQueue*>(data);
+  // Cleared before running so that tasks posted meanwhile schedule another
+  // wakeup rather than being left behind
+  queue->wakeup_scheduled_.store(false, std::memory_order_release);
+  queue->RunPendingTasks();
+  return G_SOURCE_REMOVE;
+}
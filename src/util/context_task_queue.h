@@ -0,0 +1,59 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_CONTEXT_TASK_QUEUE_H_
+#define UTIL_CONTEXT_TASK_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+typedef struct _GMainContext GMainContext;
+
+// Runs tasks posted from any thread on the thread iterating |context|, in
+// posting order. Posting is lock-free: tasks are pushed on an atomic list
+// the owner thread takes as a whole, and the context is only woken up when
+// the queue goes from empty to non-empty, so a burst of posts costs a single
+// wakeup.
+class ContextTaskQueue {
+ public:
+  using Task = std::function<void()>;
+
+  // A null |context| stands for the default (main) context
+  explicit ContextTaskQueue(GMainContext* context);
+  ContextTaskQueue(const ContextTaskQueue&) = delete;
+  ContextTaskQueue& operator=(const ContextTaskQueue&) = delete;
+  ~ContextTaskQueue();
+
+  void Post(Task task);
+  // Runs the tasks posted so far and returns how many there were. Only to
+  // be called on the owner thread.
+  size_t RunPendingTasks();
+
+ private:
+  struct Node {
+    Task task;
+    Node* next;
+  };
+
+  static int OnWakeup(void* data);
+
+  GMainContext* context_;
+  std::atomic<Node*> head_{nullptr};
+  std::atomic<bool> wakeup_scheduled_{false};
+};
+
+#endif  // UTIL_CONTEXT_TASK_QUEUE_H_
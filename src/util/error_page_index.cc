@@ -0,0 +1,110 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "error_page_index.h"
+
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include "log_manager.h"
+#include "utils.h"
+
+namespace {
+
+// resources/<language>/<script>/<region>/html/<file> is the deepest
+// candidate of util::GetErrorPagePaths()
+const int kMaxResourceDepth = 4;
+
+// Candidates and the walk spell paths differently ("a//b", "./a"), compare
+// them in normal form
+std::string Normalize(const std::string& path) {
+  return std::filesystem::path(path).lexically_normal().string();
+}
+
+}  // namespace
+
+void ErrorPageIndex::SetErrorPage(const std::string& error_page) {
+  if (error_page == error_page_) {
+    return;
+  }
+  error_page_ = error_page;
+  Invalidate();
+}
+
+const std::string& ErrorPageIndex::Resolve(const std::string& language) {
+  auto found = resolved_.find(language);
+  if (found != resolved_.end()) {
+    return found->second;
+  }
+
+  if (!built_) {
+    Build();
+  }
+
+  std::string& path = resolved_[language];
+  for (const auto& candidate :
+       util::GetErrorPagePaths(error_page_, language)) {
+    std::string normal = Normalize(candidate);
+    if (available_.find(normal) != available_.end()) {
+      path = std::move(normal);
+      break;
+    }
+  }
+  return path;
+}
+
+void ErrorPageIndex::Invalidate() {
+  built_ = false;
+  available_.clear();
+  resolved_.clear();
+}
+
+void ErrorPageIndex::Build() {
+  namespace fs = std::filesystem;
+
+  built_ = true;
+  if (error_page_.empty()) {
+    return;
+  }
+
+  fs::path error_page(error_page_);
+  const fs::path filename = error_page.filename();
+  std::error_code ec;
+  if (fs::is_regular_file(error_page, ec)) {
+    available_.insert(Normalize(error_page_));
+  }
+
+  // Only <dir>/html/<file> can be a candidate, anything else is skipped
+  // without being stat()ed
+  const fs::path resources = error_page.parent_path() / "resources";
+  for (fs::recursive_directory_iterator it(resources, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    if (it.depth() >= kMaxResourceDepth) {
+      it.disable_recursion_pending();
+    }
+    const fs::path& path = it->path();
+    if (path.filename() != filename ||
+        path.parent_path().filename() != "html" ||
+        !it->is_regular_file(ec)) {
+      continue;
+    }
+    available_.insert(path.lexically_normal().string());
+  }
+
+  LOG_DEBUG("Error page index for %s: %zu localizations", error_page_.c_str(),
+            available_.size());
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_ERROR_PAGE_INDEX_H_
+#define UTIL_ERROR_PAGE_INDEX_H_
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// Resolves the localized error page for a language without touching the
+// file system. The localizations available next to the error page are
+// listed once, with one directory walk, and the page picked for each
+// language is kept until Invalidate().
+class ErrorPageIndex {
+ public:
+  ErrorPageIndex() = default;
+  ErrorPageIndex(const ErrorPageIndex&) = delete;
+  ErrorPageIndex& operator=(const ErrorPageIndex&) = delete;
+  ~ErrorPageIndex() = default;
+
+  // |error_page| is a local path; changing it drops the index
+  void SetErrorPage(const std::string& error_page);
+  const std::string& ErrorPage() const { return error_page_; }
+
+  // Returns the first existing path of util::GetErrorPagePaths() for
+  // |language|, in normal form, or an empty string if there is none
+  const std::string& Resolve(const std::string& language);
+
+  // Drops the index and the resolved pages; the next Resolve() lists the
+  // localizations again. Called when the system language changes, which is
+  // also when localization packages come and go.
+  void Invalidate();
+
+  size_t AvailableCount() const { return available_.size(); }
+
+ private:
+  void Build();
+
+  std::string error_page_;
+  bool built_ = false;
+  std::unordered_set<std::string> available_;
+  std::unordered_map<std::string, std::string> resolved_;
+};
+
+#endif  // UTIL_ERROR_PAGE_INDEX_H_
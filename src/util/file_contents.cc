@@ -0,0 +1,155 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "file_contents.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Read size for files whose size stat() does not know, e.g. in /proc
+const size_t kChunkSize = 4096;
+
+class ScopedFd {
+ public:
+  ScopedFd() = default;
+  ScopedFd(const ScopedFd&) = delete;
+  ScopedFd& operator=(const ScopedFd&) = delete;
+  ~ScopedFd() { Reset(-1); }
+
+  void Reset(int fd) {
+    if (fd_ >= 0) {
+      // Keep the errno of the failure being reported, if any
+      int saved_errno = errno;
+      close(fd_);
+      errno = saved_errno;
+    }
+    fd_ = fd;
+  }
+  int get() const { return fd_; }
+
+ private:
+  int fd_ = -1;
+};
+
+bool Fail(int* error) {
+  if (error) {
+    *error = errno;
+  }
+  return false;
+}
+
+// Reads |fd| to the end. A regular file is read as |size| bytes, the size
+// it had when it was opened, so this is a single read() for it.
+bool ReadAll(int fd, size_t size, std::string& out) {
+  out.resize(size ? size : kChunkSize);
+  size_t offset = 0;
+  while (true) {
+    if (offset == out.size()) {
+      if (size) {
+        break;
+      }
+      out.resize(out.size() * 2);
+    }
+    ssize_t count = read(fd, &out[offset], out.size() - offset);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      out.clear();
+      return false;
+    }
+    if (count == 0) {
+      break;
+    }
+    offset += static_cast<size_t>(count);
+  }
+  out.resize(offset);
+  return true;
+}
+
+bool Open(const std::string& path, ScopedFd& fd, struct stat& st) {
+  fd.Reset(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd.get() < 0 || fstat(fd.get(), &st)) {
+    return false;
+  }
+  if (S_ISDIR(st.st_mode)) {
+    errno = EISDIR;
+    return false;
+  }
+  return true;
+}
+
+size_t KnownSize(const struct stat& st) {
+  return S_ISREG(st.st_mode) ? static_cast<size_t>(st.st_size) : 0;
+}
+
+}  // namespace
+
+std::shared_ptr<const FileContents> FileContents::Read(const std::string& path,
+                                                       int* error) {
+  ScopedFd fd;
+  struct stat st;
+  if (!Open(path, fd, st)) {
+    Fail(error);
+    return nullptr;
+  }
+
+  std::shared_ptr<FileContents> contents(new FileContents());
+  size_t size = KnownSize(st);
+  if (size > kMapThreshold) {
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (data != MAP_FAILED) {
+      contents->data_ = static_cast<const char*>(data);
+      contents->size_ = size;
+      contents->mapped_ = true;
+      return contents;
+    }
+  }
+
+  // Falls back to reading if the file can't be mapped
+  if (!ReadAll(fd.get(), size, contents->buffer_)) {
+    Fail(error);
+    return nullptr;
+  }
+  contents->data_ = contents->buffer_.data();
+  contents->size_ = contents->buffer_.size();
+  return contents;
+}
+
+FileContents::~FileContents() {
+  if (mapped_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+namespace util {
+
+bool ReadFileToString(const std::string& path, std::string& out, int* error) {
+  ScopedFd fd;
+  struct stat st;
+  if (!Open(path, fd, st) || !ReadAll(fd.get(), KnownSize(st), out)) {
+    out.clear();
+    return Fail(error);
+  }
+  return true;
+}
+
+}  // namespace util
@@ -0,0 +1,71 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_FILE_CONTENTS_H_
+#define UTIL_FILE_CONTENTS_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Read-only contents of a whole file. Files up to kMapThreshold are read
+// with a single read() into a buffer of the right size, larger ones are
+// mapped. Either way the contents are shared, not copied, by everyone
+// holding the pointer returned by Read().
+//
+// A mapped file which is truncated while mapped faults on access, so this
+// is meant for configuration, policies and scripts installed with the
+// image, not for files other processes are writing.
+class FileContents {
+ public:
+  static constexpr size_t kMapThreshold = 256 * 1024;
+
+  // Returns nullptr and, if |error| is given, sets it to the errno value on
+  // failure
+  static std::shared_ptr<const FileContents> Read(const std::string& path,
+                                                  int* error = nullptr);
+
+  FileContents(const FileContents&) = delete;
+  FileContents& operator=(const FileContents&) = delete;
+  ~FileContents();
+
+  std::string_view View() const { return std::string_view(data_, size_); }
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool IsMapped() const { return mapped_; }
+
+ private:
+  FileContents() = default;
+
+  std::string buffer_;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+};
+
+namespace util {
+
+// Reads the whole of |path| into |out|, with a single read() when the size
+// of the file is known. Returns false and, if |error| is given, sets it to
+// the errno value on failure.
+bool ReadFileToString(const std::string& path,
+                      std::string& out,
+                      int* error = nullptr);
+
+}  // namespace util
+
+#endif  // UTIL_FILE_CONTENTS_H_
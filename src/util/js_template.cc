@@ -0,0 +1,176 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "js_template.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+inline bool NeedsEscape(char c) {
+  return c == '\\' || c == '\'' || c == '\n' || c == '\r';
+}
+
+#if !defined(__SSE2__)
+// Non zero if one of the bytes of |word| is zero
+inline uint64_t HasZeroByte(uint64_t word) {
+  return (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+}
+
+inline uint64_t HasByte(uint64_t word, char c) {
+  return HasZeroByte(word ^
+                     (0x0101010101010101ULL * static_cast<unsigned char>(c)));
+}
+#endif
+
+// Length of the prefix of [data, data + size) which needs no escaping
+size_t PlainPrefix(const char* data, size_t size) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i quote = _mm_set1_epi8('\'');
+  const __m128i lf = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+  for (; i + 16 <= size; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, backslash),
+                     _mm_cmpeq_epi8(chunk, quote)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+    int mask = _mm_movemask_epi8(special);
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+#else
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    if (HasByte(word, '\\') | HasByte(word, '\'') | HasByte(word, '\n') |
+        HasByte(word, '\r')) {
+      break;
+    }
+  }
+#endif
+  while (i < size && !NeedsEscape(data[i])) {
+    ++i;
+  }
+  return i;
+}
+
+}  // namespace
+
+void AppendEscapedJsString(std::string& out, std::string_view value) {
+  out.reserve(out.size() + value.size());
+
+  const char* data = value.data();
+  size_t size = value.size();
+  while (size) {
+    size_t plain = PlainPrefix(data, size);
+    out.append(data, plain);
+    if (plain == size) {
+      break;
+    }
+
+    char c = data[plain];
+    out += '\\';
+    out += c == '\n' ? 'n' : c == '\r' ? 'r' : c;
+    data += plain + 1;
+    size -= plain + 1;
+  }
+}
+
+std::string EscapeJsString(std::string_view value) {
+  std::string escaped;
+  AppendEscapedJsString(escaped, value);
+  return escaped;
+}
+
+JsTemplate::JsTemplate(std::string_view source) {
+  literals_.reserve(source.size());
+  size_t offset = 0;
+  size_t i = 0;
+  while (i < source.size()) {
+    char c = source[i];
+    if (c != '$' || i + 1 == source.size()) {
+      literals_ += c;
+      ++i;
+      continue;
+    }
+
+    char next = source[i + 1];
+    if (next == '$') {
+      literals_ += '$';
+      i += 2;
+      continue;
+    }
+
+    bool quoted = next == '\'';
+    size_t digit = quoted ? i + 2 : i + 1;
+    if (digit >= source.size() || source[digit] < '0' || source[digit] > '9') {
+      literals_ += c;
+      ++i;
+      continue;
+    }
+
+    segments_.push_back(Segment{offset, literals_.size() - offset,
+                                source[digit] - '0', quoted});
+    offset = literals_.size();
+    i = digit + 1;
+  }
+  segments_.push_back(Segment{offset, literals_.size() - offset, -1, false});
+}
+
+void JsTemplate::Render(std::string& out,
+                        std::initializer_list<std::string_view> args) const {
+  size_t size = literals_.size();
+  for (const Segment& segment : segments_) {
+    if (segment.arg >= 0 && static_cast<size_t>(segment.arg) < args.size()) {
+      size += args.begin()[segment.arg].size() + (segment.quoted ? 2 : 0);
+    }
+  }
+  out.clear();
+  out.reserve(size);
+
+  for (const Segment& segment : segments_) {
+    out.append(literals_, segment.offset, segment.size);
+    if (segment.arg < 0 || static_cast<size_t>(segment.arg) >= args.size()) {
+      continue;
+    }
+
+    std::string_view arg = args.begin()[segment.arg];
+    if (segment.quoted) {
+      out += '\'';
+      AppendEscapedJsString(out, arg);
+      out += '\'';
+    } else {
+      out.append(arg.data(), arg.size());
+    }
+  }
+}
+
+std::string JsTemplate::Render(
+    std::initializer_list<std::string_view> args) const {
+  std::string out;
+  Render(out, args);
+  return out;
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_JS_TEMPLATE_H_
+#define UTIL_JS_TEMPLATE_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Appends |value| escaped for a single-quoted JavaScript string literal:
+// backslash, quote, CR and LF are escaped, everything else (UTF-8
+// included) is copied as is. Runs of plain characters are found 16 bytes
+// at a time with SSE2, 8 bytes at a time elsewhere, and appended in bulk.
+void AppendEscapedJsString(std::string& out, std::string_view value);
+std::string EscapeJsString(std::string_view value);
+
+// A script with numbered slots, split into literal chunks and slots once,
+// so that rendering it is a series of appends into a caller owned buffer:
+//
+//   static const JsTemplate kEvent(
+//       "var e = new CustomEvent($'0, { detail: $1 });");
+//   kEvent.Render(buffer, {"webOSRelaunch", params_json});
+//
+// $0..$9 expand to the argument as is (JSON, numbers, booleans), $'0..$'9
+// to the argument escaped and single quoted, and $$ to a dollar sign.
+// A missing argument expands to nothing.
+class JsTemplate {
+ public:
+  static constexpr size_t kMaxArgs = 10;
+
+  explicit JsTemplate(std::string_view source);
+  JsTemplate(const JsTemplate&) = delete;
+  JsTemplate& operator=(const JsTemplate&) = delete;
+
+  // Replaces the content of |out|, keeping its capacity
+  void Render(std::string& out,
+              std::initializer_list<std::string_view> args) const;
+  std::string Render(std::initializer_list<std::string_view> args) const;
+
+  size_t SlotCount() const { return segments_.size() - 1; }
+
+ private:
+  // Literal text followed by an optional slot
+  struct Segment {
+    size_t offset;
+    size_t size;
+    int arg;  // -1 for the trailing literal
+    bool quoted;
+  };
+
+  std::string literals_;
+  std::vector<Segment> segments_;
+};
+
+#endif  // UTIL_JS_TEMPLATE_H_
@@ -0,0 +1,199 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "json_schema.h"
+
+#include <json/value.h>
+
+#include "log_manager.h"
+
+namespace {
+
+bool HasType(const Json::Value& value, JsonSchema::Type type) {
+  switch (type) {
+    case JsonSchema::Type::kAny:
+      return true;
+    case JsonSchema::Type::kBool:
+      return value.isBool();
+    case JsonSchema::Type::kInt:
+      return value.isInt();
+    case JsonSchema::Type::kNumber:
+      return value.isNumeric();
+    case JsonSchema::Type::kString:
+      return value.isString();
+    case JsonSchema::Type::kObject:
+      return value.isObject();
+    case JsonSchema::Type::kArray:
+      return value.isArray();
+  }
+  return false;
+}
+
+}  // namespace
+
+JsonSchema::JsonSchema(std::initializer_list<Member> members) {
+  for (const Member& member : members) {
+    std::string path(member.path);
+    // Objects on the way to the member, e.g. "appDesc" for "appDesc.id"
+    for (size_t dot = path.find('.'); dot != std::string::npos;
+         dot = path.find('.', dot + 1)) {
+      FindOrAddStep(path.substr(0, dot), Type::kObject, member.required,
+                    true);
+    }
+    size_t step = FindOrAddStep(path, member.type, member.required, false);
+    if (step == kRoot || !member.one_of) {
+      continue;
+    }
+    std::string values(member.one_of);
+    for (size_t begin = 0, end = 0; end != std::string::npos;
+         begin = end + 1) {
+      end = values.find('|', begin);
+      program_[step].one_of.push_back(values.substr(begin, end - begin));
+    }
+  }
+}
+
+size_t JsonSchema::FindOrAddStep(const std::string& path,
+                                 Type type,
+                                 bool required,
+                                 bool implied) {
+  for (size_t i = 0; i < program_.size(); ++i) {
+    Step& step = program_[i];
+    if (step.path != path) {
+      continue;
+    }
+    if (!implied) {
+      step.type = type;
+      step.required = required;
+      step.implied = false;
+    } else if (step.implied) {
+      step.required = step.required || required;
+    }
+    return i;
+  }
+
+  if (program_.size() == kMaxSteps) {
+    LOG_ERROR(MSGID_LUNA_API, 1, PMLOGKS("PATH", path.c_str()),
+              "Too many members in schema, member ignored");
+    return kRoot;
+  }
+
+  size_t parent = kRoot;
+  std::string key = path;
+  size_t dot = path.rfind('.');
+  if (dot != std::string::npos) {
+    for (size_t i = 0; i < program_.size(); ++i) {
+      if (program_[i].path.compare(0, std::string::npos, path, 0, dot) == 0) {
+        parent = i;
+        break;
+      }
+    }
+    key = path.substr(dot + 1);
+  }
+
+  program_.push_back(Step{parent, key, path, type, required, implied, {}});
+  return program_.size() - 1;
+}
+
+bool JsonSchema::Validate(const Json::Value& value, std::string* error) const {
+  if (!value.isObject()) {
+    if (error) {
+      *error = "request must be an object";
+    }
+    return false;
+  }
+
+  // Parents always precede their members in the program, so each step finds
+  // its parent already resolved (or absent, in which case it is skipped).
+  const Json::Value* resolved[kMaxSteps];
+  for (size_t i = 0; i < program_.size(); ++i) {
+    const Step& step = program_[i];
+    const Json::Value* parent =
+        step.parent == kRoot ? &value : resolved[step.parent];
+    if (!parent || !parent->isObject()) {
+      resolved[i] = nullptr;
+      continue;
+    }
+
+    const Json::Value* member =
+        parent->find(step.key.data(), step.key.data() + step.key.size());
+    if (!member) {
+      if (step.required) {
+        if (error) {
+          *error = "missing required parameter '" + step.path + "'";
+        }
+        return false;
+      }
+      resolved[i] = nullptr;
+      continue;
+    }
+
+    if (!HasType(*member, step.type)) {
+      if (error) {
+        *error = "parameter '" + step.path + "' must be " +
+                 TypeName(step.type);
+      }
+      return false;
+    }
+    if (!step.one_of.empty() && !IsOneOf(*member, step.one_of)) {
+      if (error) {
+        *error = "parameter '" + step.path + "' must be one of ";
+        for (size_t v = 0; v < step.one_of.size(); ++v) {
+          *error += (v ? "|" : "") + step.one_of[v];
+        }
+      }
+      return false;
+    }
+    resolved[i] = member;
+  }
+
+  return true;
+}
+
+bool JsonSchema::IsOneOf(const Json::Value& value,
+                         const std::vector<std::string>& one_of) {
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  if (!value.getString(&begin, &end)) {
+    return false;
+  }
+  for (const std::string& allowed : one_of) {
+    if (allowed.compare(0, std::string::npos, begin, end - begin) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* JsonSchema::TypeName(Type type) {
+  switch (type) {
+    case Type::kAny:
+      return "any";
+    case Type::kBool:
+      return "boolean";
+    case Type::kInt:
+      return "integer";
+    case Type::kNumber:
+      return "number";
+    case Type::kString:
+      return "string";
+    case Type::kObject:
+      return "object";
+    case Type::kArray:
+      return "array";
+  }
+  return "unknown";
+}
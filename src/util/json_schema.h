@@ -0,0 +1,92 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_JSON_SCHEMA_H_
+#define UTIL_JSON_SCHEMA_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Json {
+class Value;
+}
+
+// Declarative description of the members a request payload may carry.
+// Members are given by dotted path ("appDesc.id"); objects on the way are
+// implied. A string member may be limited to a "|" separated list of
+// values. The description is compiled once into a flat program in which
+// every step looks up a single key in an already resolved parent, so
+// validating a request is one pass over the touched members without any
+// allocation.
+//
+//   JsonSchema schema({{"appDesc.id", JsonSchema::Type::kString, true},
+//                      {"parameters", JsonSchema::Type::kObject, false},
+//                      {"replyOn", JsonSchema::Type::kString, false,
+//                       "launch|firstFrame"}});
+//   std::string error;
+//   if (!schema.Validate(request, &error)) { ... }
+class JsonSchema {
+ public:
+  enum class Type { kAny, kBool, kInt, kNumber, kString, kObject, kArray };
+
+  struct Member {
+    const char* path;
+    Type type;
+    bool required;
+    // Allowed values of a kString member, e.g. "launch|firstFrame"
+    const char* one_of = nullptr;
+  };
+
+  // Deepest schema a program can hold, implied objects included
+  static constexpr size_t kMaxSteps = 32;
+
+  JsonSchema() = default;
+  JsonSchema(std::initializer_list<Member> members);
+
+  // Returns false for anything but an object matching the schema, with the
+  // first violation described in |error|.
+  bool Validate(const Json::Value& value, std::string* error = nullptr) const;
+
+  size_t StepCount() const { return program_.size(); }
+
+  static const char* TypeName(Type type);
+
+ private:
+  static constexpr size_t kRoot = static_cast<size_t>(-1);
+
+  struct Step {
+    size_t parent;
+    std::string key;
+    std::string path;
+    Type type;
+    bool required;
+    bool implied;
+    std::vector<std::string> one_of;
+  };
+
+  size_t FindOrAddStep(const std::string& path,
+                       Type type,
+                       bool required,
+                       bool implied);
+  static bool IsOneOf(const Json::Value& value,
+                      const std::vector<std::string>& one_of);
+
+  std::vector<Step> program_;
+};
+
+#endif  // UTIL_JSON_SCHEMA_H_
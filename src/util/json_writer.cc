@@ -0,0 +1,226 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "json_writer.h"
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+#include <json/value.h>
+
+namespace {
+
+const char kHexDigits[] = "0123456789abcdef";
+
+template <typename T>
+void AppendInteger(std::string& buffer, T value) {
+  char digits[24];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  buffer.append(digits, result.ptr);
+}
+
+}  // namespace
+
+JsonWriter& JsonWriter::BeginObject() {
+  Open('{');
+  return *this;
+}
+
+JsonWriter& JsonWriter::EndObject() {
+  Close('}');
+  return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+  Open('[');
+  return *this;
+}
+
+JsonWriter& JsonWriter::EndArray() {
+  Close(']');
+  return *this;
+}
+
+JsonWriter& JsonWriter::Key(std::string_view key) {
+  BeginValue();
+  AppendEscaped(key);
+  buffer_ += ':';
+  after_key_ = true;
+  return *this;
+}
+
+JsonWriter& JsonWriter::String(std::string_view value) {
+  BeginValue();
+  AppendEscaped(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Int(int64_t value) {
+  BeginValue();
+  AppendInteger(buffer_, value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Uint(uint64_t value) {
+  BeginValue();
+  AppendInteger(buffer_, value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Double(double value) {
+  if (!std::isfinite(value)) {
+    // JSON has no representation for these, jsoncpp writes null as well
+    return Null();
+  }
+  BeginValue();
+  char digits[32];
+  int length = snprintf(digits, sizeof(digits), "%.17g", value);
+  buffer_.append(digits, length);
+  return *this;
+}
+
+JsonWriter& JsonWriter::Bool(bool value) {
+  BeginValue();
+  buffer_ += value ? "true" : "false";
+  return *this;
+}
+
+JsonWriter& JsonWriter::Null() {
+  BeginValue();
+  buffer_ += "null";
+  return *this;
+}
+
+JsonWriter& JsonWriter::Value(const Json::Value& value) {
+  switch (value.type()) {
+    case Json::nullValue:
+      return Null();
+    case Json::intValue:
+      return Int(value.asInt64());
+    case Json::uintValue:
+      return Uint(value.asUInt64());
+    case Json::realValue:
+      return Double(value.asDouble());
+    case Json::booleanValue:
+      return Bool(value.asBool());
+    case Json::stringValue: {
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      value.getString(&begin, &end);
+      return String(std::string_view(begin, end - begin));
+    }
+    case Json::arrayValue:
+      BeginArray();
+      for (const Json::Value& element : value) {
+        Value(element);
+      }
+      return EndArray();
+    case Json::objectValue:
+      BeginObject();
+      for (auto it = value.begin(); it != value.end(); ++it) {
+        Key(it.name());
+        Value(*it);
+      }
+      return EndObject();
+  }
+  return *this;
+}
+
+void JsonWriter::Clear() {
+  buffer_.clear();
+  has_elements_ = 0;
+  depth_ = 0;
+  after_key_ = false;
+}
+
+void JsonWriter::BeginValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ == 0) {
+    return;
+  }
+
+  const uint64_t bit = uint64_t{1} << (depth_ - 1);
+  if (has_elements_ & bit) {
+    buffer_ += ',';
+  }
+  has_elements_ |= bit;
+}
+
+void JsonWriter::Open(char bracket) {
+  assert(depth_ < kMaxDepth);
+  BeginValue();
+  buffer_ += bracket;
+  ++depth_;
+  has_elements_ &= ~(uint64_t{1} << (depth_ - 1));
+}
+
+void JsonWriter::Close(char bracket) {
+  assert(depth_ > 0 && !after_key_);
+  --depth_;
+  buffer_ += bracket;
+}
+
+void JsonWriter::AppendEscaped(std::string_view value) {
+  buffer_ += '"';
+
+  // Copy runs of characters which need no escaping in one go
+  size_t run_start = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(value[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    buffer_.append(value.data() + run_start, i - run_start);
+    run_start = i + 1;
+    switch (c) {
+      case '"':
+        buffer_ += "\\\"";
+        break;
+      case '\\':
+        buffer_ += "\\\\";
+        break;
+      case '\b':
+        buffer_ += "\\b";
+        break;
+      case '\f':
+        buffer_ += "\\f";
+        break;
+      case '\n':
+        buffer_ += "\\n";
+        break;
+      case '\r':
+        buffer_ += "\\r";
+        break;
+      case '\t':
+        buffer_ += "\\t";
+        break;
+      default:
+        buffer_ += "\\u00";
+        buffer_ += kHexDigits[c >> 4];
+        buffer_ += kHexDigits[c & 0xf];
+        break;
+    }
+  }
+  buffer_.append(value.data() + run_start, value.size() - run_start);
+
+  buffer_ += '"';
+}
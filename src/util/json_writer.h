@@ -0,0 +1,81 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_JSON_WRITER_H_
+#define UTIL_JSON_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Json {
+class Value;
+}
+
+// Writes compact JSON straight into a string buffer, without building a
+// Json::Value tree first. Commas are inserted automatically; keys and
+// strings are escaped, UTF-8 is passed through as is. Clear() keeps the
+// buffer's capacity, so a writer kept around for a reply builder stops
+// allocating once it has seen its largest reply.
+//
+//   writer.BeginObject().Key("returnValue").Bool(true).EndObject();
+//
+// Misuse (a value without a key inside an object, unbalanced End*()) is
+// not detected beyond debug assertions; the caller owns the structure.
+class JsonWriter {
+ public:
+  static constexpr size_t kMaxDepth = 64;
+
+  JsonWriter() = default;
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+
+  JsonWriter& BeginObject();
+  JsonWriter& EndObject();
+  JsonWriter& BeginArray();
+  JsonWriter& EndArray();
+  JsonWriter& Key(std::string_view key);
+
+  JsonWriter& String(std::string_view value);
+  JsonWriter& Int(int64_t value);
+  JsonWriter& Uint(uint64_t value);
+  JsonWriter& Double(double value);
+  JsonWriter& Bool(bool value);
+  JsonWriter& Null();
+  // Embeds an existing tree, e.g. a piece of an application description
+  JsonWriter& Value(const Json::Value& value);
+
+  void Clear();
+  const std::string& str() const { return buffer_; }
+  size_t size() const { return buffer_.size(); }
+  // True once every opened object and array has been closed
+  bool IsComplete() const { return depth_ == 0 && !buffer_.empty(); }
+
+ private:
+  void BeginValue();
+  void Open(char bracket);
+  void Close(char bracket);
+  void AppendEscaped(std::string_view value);
+
+  std::string buffer_;
+  // Bit |i| is set when the container at depth |i| already has an element
+  uint64_t has_elements_ = 0;
+  size_t depth_ = 0;
+  bool after_key_ = false;
+};
+
+#endif  // UTIL_JSON_WRITER_H_
@@ -0,0 +1,194 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "main_loop_watchdog.h"
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <glib.h>
+
+namespace {
+
+int64_t MonotonicUs() {
+  return g_get_monotonic_time();
+}
+
+// Timer receivers are named by their mangled typeid() name, demangled only
+// for the few callbacks which were slow
+std::string CallbackName(const char* name) {
+  if (!name) {
+    return std::string();
+  }
+
+  int status = -1;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result(demangled);
+    std::free(demangled);
+    return result;
+  }
+  std::free(demangled);
+  return std::string(name);
+}
+
+}  // namespace
+
+MainLoopWatchdog* MainLoopWatchdog::current_ = nullptr;
+
+MainLoopWatchdog::MainLoopWatchdog(Clock clock)
+    : has_own_clock_(static_cast<bool>(clock)),
+      clock_(clock ? std::move(clock) : Clock(&MonotonicUs)) {}
+
+MainLoopWatchdog::~MainLoopWatchdog() {
+  // Scopes still running report to nobody
+  for (Scope* scope = scopes_; scope; scope = scope->outer_) {
+    scope->watchdog_ = nullptr;
+  }
+  SetThresholdMs(0);
+}
+
+void MainLoopWatchdog::SetThresholdMs(int threshold_ms) {
+  threshold_us_ = std::max(threshold_ms, 0) * int64_t{1000};
+  if (!threshold_us_) {
+    DetachHeartbeat();
+    if (current_ == this) {
+      current_ = nullptr;
+    }
+    return;
+  }
+
+  current_ = this;
+  if (!has_own_clock_ && !heartbeat_) {
+    AttachHeartbeat();
+  }
+}
+
+void MainLoopWatchdog::Heartbeat() {
+  int64_t now = clock_();
+  if (expected_us_) {
+    int64_t lag = std::max<int64_t>(now - expected_us_, 0);
+    lag_ms_.Record(static_cast<uint64_t>(lag / 1000));
+    if (threshold_us_ && lag >= threshold_us_ && !slow_since_heartbeat_) {
+      AddOffender("unattributed", nullptr, -1, lag, now);
+    }
+  }
+  slow_since_heartbeat_ = false;
+  expected_us_ = now + kHeartbeatIntervalMs * int64_t{1000};
+}
+
+Json::Value MainLoopWatchdog::ToJson() const {
+  Json::Value result(Json::objectValue);
+  result["thresholdMs"] = ThresholdMs();
+  result["heartbeatIntervalMs"] = kHeartbeatIntervalMs;
+  result["lagMs"] = lag_ms_.ToJson();
+  result["slowCallbacks"] = static_cast<Json::UInt64>(slow_callbacks_);
+
+  int64_t now = clock_();
+  Json::Value& offenders = result["offenders"] = Json::arrayValue;
+  for (size_t i = 0; i < offenders_.size(); ++i) {
+    size_t index = (next_ + offenders_.size() - 1 - i) % offenders_.size();
+    const Offender& offender = offenders_[index];
+    Json::Value entry(Json::objectValue);
+    entry["kind"] = offender.kind;
+    entry["name"] = offender.name;
+    if (offender.detail >= 0) {
+      entry["detail"] = offender.detail;
+    }
+    entry["durationMs"] = static_cast<Json::Int64>(offender.duration_us / 1000);
+    entry["agoMs"] = static_cast<Json::Int64>((now - offender.at_us) / 1000);
+    offenders.append(std::move(entry));
+  }
+  return result;
+}
+
+void MainLoopWatchdog::Reset() {
+  lag_ms_.Reset();
+  slow_callbacks_ = 0;
+  next_ = 0;
+  offenders_.clear();
+}
+
+int MainLoopWatchdog::OnHeartbeat(void* data) {
+  static_cast<MainLoopWatchdog*>(data)->Heartbeat();
+  return G_SOURCE_CONTINUE;
+}
+
+void MainLoopWatchdog::Enter(Scope* scope) {
+  scope->start_us_ = clock_();
+  scope->outer_ = scopes_;
+  scopes_ = scope;
+}
+
+void MainLoopWatchdog::Exit(Scope* scope) {
+  scopes_ = scope->outer_;
+  if (!threshold_us_) {
+    return;
+  }
+
+  int64_t now = clock_();
+  int64_t duration = now - scope->start_us_;
+  if (duration < threshold_us_) {
+    return;
+  }
+
+  // The innermost slow callback takes the blame
+  if (!scope->attributed_) {
+    AddOffender(scope->kind_, scope->name_, scope->detail_, duration, now);
+  }
+  if (scope->outer_) {
+    scope->outer_->attributed_ = true;
+  }
+}
+
+void MainLoopWatchdog::AddOffender(const char* kind,
+                                   const char* name,
+                                   int detail,
+                                   int64_t duration_us,
+                                   int64_t at_us) {
+  ++slow_callbacks_;
+  slow_since_heartbeat_ = true;
+
+  Offender offender{kind, CallbackName(name), detail, duration_us, at_us};
+  if (offenders_.size() < kMaxOffenders) {
+    offenders_.push_back(std::move(offender));
+  } else {
+    offenders_[next_] = std::move(offender);
+  }
+  next_ = (next_ + 1) % kMaxOffenders;
+}
+
+void MainLoopWatchdog::AttachHeartbeat() {
+  heartbeat_ = g_timeout_source_new(kHeartbeatIntervalMs);
+  // Ahead of the default priority sources it is meant to wait for
+  g_source_set_priority(heartbeat_, G_PRIORITY_HIGH);
+  g_source_set_callback(heartbeat_, &MainLoopWatchdog::OnHeartbeat, this,
+                        nullptr);
+  g_source_attach(heartbeat_, g_main_context_default());
+  expected_us_ = clock_() + kHeartbeatIntervalMs * int64_t{1000};
+}
+
+void MainLoopWatchdog::DetachHeartbeat() {
+  if (!heartbeat_) {
+    return;
+  }
+  g_source_destroy(heartbeat_);
+  g_source_unref(heartbeat_);
+  heartbeat_ = nullptr;
+  expected_us_ = 0;
+}
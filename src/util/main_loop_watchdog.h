@@ -0,0 +1,145 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_MAIN_LOOP_WATCHDOG_H_
+#define UTIL_MAIN_LOOP_WATCHDOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <json/value.h>
+
+#include "service_stats.h"
+
+typedef struct _GSource GSource;
+
+// Tells what keeps the main loop from input and frames. A high priority
+// heartbeat measures how late the loop gets to it, and the callbacks the
+// loop runs (bus methods and replies, timers, window events) are timed
+// within a Scope. A callback running longer than the threshold, or a late
+// heartbeat with no such callback to blame, is kept as an offender.
+//
+// Main thread only. A Scope costs two clock reads while a watchdog runs
+// and a null check otherwise.
+class MainLoopWatchdog {
+ public:
+  // Monotonic microseconds
+  using Clock = std::function<int64_t()>;
+
+  static constexpr int kHeartbeatIntervalMs = 250;
+  static constexpr size_t kMaxOffenders = 32;
+
+  // Times the callback it lives in. |kind| and |name| must outlive it;
+  // |detail| qualifies |name|, e.g. an event type.
+  class Scope {
+   public:
+    Scope(const char* kind, const char* name, int detail = -1)
+        : watchdog_(current_), kind_(kind), name_(name), detail_(detail) {
+      if (watchdog_) {
+        watchdog_->Enter(this);
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+      if (watchdog_) {
+        watchdog_->Exit(this);
+      }
+    }
+
+   private:
+    friend class MainLoopWatchdog;
+
+    MainLoopWatchdog* watchdog_;
+    const char* kind_;
+    const char* name_;
+    int detail_;
+    int64_t start_us_ = 0;
+    Scope* outer_ = nullptr;
+    // A nested callback has been blamed already
+    bool attributed_ = false;
+  };
+
+  // Only a watchdog on the default clock has a heartbeat source, others
+  // get Heartbeat() called by hand
+  explicit MainLoopWatchdog(Clock clock = {});
+  MainLoopWatchdog(const MainLoopWatchdog&) = delete;
+  MainLoopWatchdog& operator=(const MainLoopWatchdog&) = delete;
+  ~MainLoopWatchdog();
+
+  // The watchdog the scopes report to, if any
+  static MainLoopWatchdog* Current() { return current_; }
+
+  // Starts watching, or stops with 0. A single watchdog runs at a time.
+  void SetThresholdMs(int threshold_ms);
+  int ThresholdMs() const { return static_cast<int>(threshold_us_ / 1000); }
+  bool IsRunning() const { return threshold_us_ > 0; }
+
+  // Called every kHeartbeatIntervalMs by the heartbeat source
+  void Heartbeat();
+
+  // {"thresholdMs", "heartbeatIntervalMs", "lagMs", "slowCallbacks",
+  //  "offenders": [{"kind", "name", "detail", "durationMs", "agoMs"}]}
+  // lagMs is the Histogram of how late the heartbeats were. Offenders are
+  // newest first; "unattributed" ones were seen by the heartbeat only.
+  Json::Value ToJson() const;
+  void Reset();
+
+ private:
+  struct Offender {
+    std::string kind;
+    std::string name;
+    int detail;
+    int64_t duration_us;
+    int64_t at_us;
+  };
+
+  static int OnHeartbeat(void* data);
+
+  void Enter(Scope* scope);
+  void Exit(Scope* scope);
+  void AddOffender(const char* kind,
+                   const char* name,
+                   int detail,
+                   int64_t duration_us,
+                   int64_t at_us);
+  void AttachHeartbeat();
+  void DetachHeartbeat();
+
+  static MainLoopWatchdog* current_;
+
+  bool has_own_clock_;
+  Clock clock_;
+  int64_t threshold_us_ = 0;
+  GSource* heartbeat_ = nullptr;
+  // When the next heartbeat is due, 0 before the first one
+  int64_t expected_us_ = 0;
+  // Some callback has been blamed since the last heartbeat
+  bool slow_since_heartbeat_ = false;
+  // Innermost scope running
+  Scope* scopes_ = nullptr;
+
+  Histogram lag_ms_;
+  uint64_t slow_callbacks_ = 0;
+  // Slot the next offender is written to
+  size_t next_ = 0;
+  std::vector<Offender> offenders_;
+};
+
+#endif  // UTIL_MAIN_LOOP_WATCHDOG_H_
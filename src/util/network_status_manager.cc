@@ -16,51 +16,77 @@
 
 #include "network_status_manager.h"
 
+#include <algorithm>
+
 #include "log_manager.h"
 
-void NetworkStatusManager::UpdateNetworkStatus(const NetworkStatus& status) {
-  if (current_.Type() != status.Type()) {
-    AppendLogList(status.Type(), current_.Type(), status.Type());
+void NetworkStatusManager::SetDebounceIntervalMs(int interval_ms) {
+  debounce_interval_ms_ = std::max(interval_ms, 0);
+}
+
+void NetworkStatusManager::UpdateNetworkStatus(NetworkStatus status) {
+  // Later events of a burst simply replace the pending one, the diff is
+  // taken against the last committed status once the window closes.
+  pending_ = std::move(status);
+  has_pending_ = true;
+
+  if (debounce_interval_ms_ == 0) {
+    CommitPendingStatus();
+    return;
   }
 
-  CheckInformationChange(status.GetInformation());
-  if (log_list_.size() > 0) {  // one more information was changed
-    AppendLogList("date", current_.SavedDate(), status.SavedDate());
-    PrintLog();
-    current_ = status;
+  if (!debounce_timer_.IsRunning()) {
+    debounce_timer_.StartWithReceiver(
+        debounce_interval_ms_, this,
+        &NetworkStatusManager::CommitPendingStatus);
   }
 }
 
-void NetworkStatusManager::CheckInformationChange(
-    const NetworkStatus::Information& info) {
-  if (current_.GetInformation().IpAddress() != info.IpAddress()) {
-    AppendLogList("ipAddress", current_.GetInformation().IpAddress(),
-                  info.IpAddress());
-  }
-  if (current_.GetInformation().Dns1() != info.Dns1()) {
-    AppendLogList("dns1", current_.GetInformation().Dns1(), info.Dns1());
-  }
-  if (current_.GetInformation().Dns2() != info.Dns2()) {
-    AppendLogList("dns2", current_.GetInformation().Dns2(), info.Dns2());
-  }
-  if (current_.GetInformation().Method() != info.Method()) {
-    AppendLogList("method", current_.GetInformation().Method(), info.Method());
-  }
-  if (current_.GetInformation().State() != info.State()) {
-    AppendLogList("state", current_.GetInformation().State(), info.State());
+void NetworkStatusManager::CommitPendingStatus() {
+  if (!has_pending_) {
+    return;
   }
-  if (current_.GetInformation().Gateway() != info.Gateway()) {
-    AppendLogList("gateway", current_.GetInformation().Gateway(),
-                  info.Gateway());
-  }
-  if (current_.GetInformation().InterfaceName() != info.InterfaceName()) {
-    AppendLogList("interfaceName", current_.GetInformation().InterfaceName(),
-                  info.InterfaceName());
+  has_pending_ = false;
+
+  CheckFieldChange("type", current_.Type(), pending_.Type());
+  CheckFieldChange(
+      "isInternetConnectionAvailable",
+      current_.IsInternetConnectionAvailable() ? "true" : "false",
+      pending_.IsInternetConnectionAvailable() ? "true" : "false");
+  CheckInformationChange(pending_.GetInformation());
+
+  if (log_list_.empty()) {
+    return;
   }
-  if (current_.GetInformation().OnInternet() != info.OnInternet()) {
-    AppendLogList("onInternet", current_.GetInformation().OnInternet(),
-                  info.OnInternet());
+
+  // one more information was changed
+  AppendLogList("date", current_.SavedDate(), pending_.SavedDate());
+  PrintLog();
+  std::swap(current_, pending_);
+}
+
+void NetworkStatusManager::CheckInformationChange(
+    const NetworkStatus::Information& info) {
+  const NetworkStatus::Information& current = current_.GetInformation();
+  CheckFieldChange("netmask", current.Netmask(), info.Netmask());
+  CheckFieldChange("ipAddress", current.IpAddress(), info.IpAddress());
+  CheckFieldChange("dns1", current.Dns1(), info.Dns1());
+  CheckFieldChange("dns2", current.Dns2(), info.Dns2());
+  CheckFieldChange("method", current.Method(), info.Method());
+  CheckFieldChange("state", current.State(), info.State());
+  CheckFieldChange("gateway", current.Gateway(), info.Gateway());
+  CheckFieldChange("interfaceName", current.InterfaceName(),
+                   info.InterfaceName());
+  CheckFieldChange("onInternet", current.OnInternet(), info.OnInternet());
+}
+
+void NetworkStatusManager::CheckFieldChange(const char* key,
+                                            const std::string& previous,
+                                            const std::string& current) {
+  if (previous == current) {
+    return;
   }
+  AppendLogList(key, previous, current);
 }
 
 void NetworkStatusManager::AppendLogList(const std::string& key,
@@ -23,9 +23,24 @@
 #include <unordered_map>
 #include <utility>
 
+#include "timer.h"
+
+// Keeps the last known network status for logging. Bursts of
+// connectionmanager events (e.g. Wi-Fi roaming) are coalesced into a single
+// update per debounce window, which logs the fields that differ from the
+// last committed status.
 class NetworkStatusManager {
  public:
-  void UpdateNetworkStatus(const NetworkStatus& status);
+  NetworkStatusManager() = default;
+  NetworkStatusManager(const NetworkStatusManager&) = delete;
+  NetworkStatusManager& operator=(const NetworkStatusManager&) = delete;
+
+  void SetDebounceIntervalMs(int interval_ms);
+
+  void UpdateNetworkStatus(NetworkStatus status);
+
+  const NetworkStatus& Current() const { return current_; }
+
   void CheckInformationChange(const NetworkStatus::Information& information);
   void AppendLogList(const std::string& key,
                      const std::string& previous,
@@ -33,7 +48,16 @@ class NetworkStatusManager {
   void PrintLog();
 
  private:
+  void CommitPendingStatus();
+  void CheckFieldChange(const char* key,
+                        const std::string& previous,
+                        const std::string& current);
+
   NetworkStatus current_;
+  NetworkStatus pending_;
+  bool has_pending_ = false;
+  int debounce_interval_ms_ = 0;
+  OneShotTimer<NetworkStatusManager> debounce_timer_;
   std::unordered_map<std::string, std::pair<std::string, std::string>>
       log_list_;
 };
@@ -18,25 +18,100 @@
 #define UTIL_OBSERVER_LIST_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 
+// Observers may be added and removed, and the list itself destroyed, while
+// it is being iterated. Observers added during an iteration are not
+// notified by it, removed ones are no longer notified. Removal during an
+// iteration leaves a null tombstone, compacted once the outermost
+// iteration is over, so that iterating neither copies nor allocates.
 template <class ObserverType>
 class ObserverList {
  public:
+  class Iterator {
+   public:
+    explicit Iterator(ObserverList* list);
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+    ~Iterator();
+
+    // nullptr once every observer has been returned
+    ObserverType* GetNext();
+
+   private:
+    friend class ObserverList;
+
+    ObserverList* list_;
+    Iterator* outer_;
+    size_t index_ = 0;
+    // Observers added after this iterator was created are not visited
+    size_t end_;
+  };
+
+  ObserverList() = default;
+  ObserverList(const ObserverList&) = delete;
+  ObserverList& operator=(const ObserverList&) = delete;
+  ~ObserverList();
+
   void AddObserver(ObserverType* observer);
   void RemoveObserver(ObserverType* observer);
   bool HasObserver(ObserverType* observer);
   void Clear();
-  void Compact();
-  size_t Size() { return observers_.size(); }
-
-  typename std::vector<ObserverType*>::iterator Begin();
-  typename std::vector<ObserverType*>::iterator End();
+  size_t Size() { return size_; }
 
  private:
+  bool IsIterating() const { return iterators_ != nullptr; }
+  void Compact();
+
   std::vector<ObserverType*> observers_;
+  size_t size_ = 0;
+  // Innermost iteration in progress, linked to the enclosing ones
+  Iterator* iterators_ = nullptr;
+  bool has_tombstones_ = false;
 };
 
+template <class ObserverType>
+ObserverList<ObserverType>::Iterator::Iterator(ObserverList* list)
+    : list_(list), outer_(list->iterators_), end_(list->observers_.size()) {
+  list->iterators_ = this;
+}
+
+template <class ObserverType>
+ObserverList<ObserverType>::Iterator::~Iterator() {
+  if (!list_) {
+    return;
+  }
+
+  list_->iterators_ = outer_;
+  if (!list_->IsIterating() && list_->has_tombstones_) {
+    list_->Compact();
+  }
+}
+
+template <class ObserverType>
+ObserverType* ObserverList<ObserverType>::Iterator::GetNext() {
+  if (!list_) {
+    return nullptr;
+  }
+
+  while (index_ < end_) {
+    ObserverType* observer = list_->observers_[index_++];
+    if (observer) {
+      return observer;
+    }
+  }
+  return nullptr;
+}
+
+template <class ObserverType>
+ObserverList<ObserverType>::~ObserverList() {
+  // Iterations in progress end with the list
+  for (Iterator* it = iterators_; it; it = it->outer_) {
+    it->list_ = nullptr;
+  }
+}
+
 template <class ObserverType>
 void ObserverList<ObserverType>::AddObserver(ObserverType* observer) {
   if (!observer) {
@@ -48,15 +123,27 @@ void ObserverList<ObserverType>::AddObserver(ObserverType* observer) {
   }
 
   observers_.push_back(observer);
+  ++size_;
 }
 
 template <class ObserverType>
 void ObserverList<ObserverType>::RemoveObserver(ObserverType* observer) {
-  if (!observer || !HasObserver(observer)) {
+  if (!observer) {
+    return;
+  }
+
+  auto it = std::find(observers_.begin(), observers_.end(), observer);
+  if (it == observers_.end()) {
     return;
   }
 
-  observers_.erase(std::find(observers_.begin(), observers_.end(), observer));
+  --size_;
+  if (IsIterating()) {
+    *it = nullptr;
+    has_tombstones_ = true;
+  } else {
+    observers_.erase(it);
+  }
 }
 
 template <class ObserverType>
@@ -65,16 +152,19 @@ bool ObserverList<ObserverType>::HasObserver(ObserverType* observer) {
     return false;
   }
 
-  if (std::find(observers_.begin(), observers_.end(), observer) !=
-      observers_.end()) {
-    return true;
-  }
-  return false;
+  return std::find(observers_.begin(), observers_.end(), observer) !=
+         observers_.end();
 }
 
 template <class ObserverType>
 void ObserverList<ObserverType>::Clear() {
-  observers_.clear();
+  size_ = 0;
+  if (IsIterating()) {
+    std::fill(observers_.begin(), observers_.end(), nullptr);
+    has_tombstones_ = true;
+  } else {
+    observers_.clear();
+  }
 }
 
 template <class ObserverType>
@@ -82,28 +172,17 @@ void ObserverList<ObserverType>::Compact() {
   observers_.erase(std::remove(observers_.begin(), observers_.end(),
                                static_cast<ObserverType*>(nullptr)),
                    observers_.end());
+  has_tombstones_ = false;
 }
 
-template <class ObserverType>
-typename std::vector<ObserverType*>::iterator
-ObserverList<ObserverType>::Begin() {
-  return observers_.begin();
-}
-
-template <class ObserverType>
-typename std::vector<ObserverType*>::iterator
-ObserverList<ObserverType>::End() {
-  return observers_.end();
-}
-
-#define FOR_EACH_OBSERVER(ObserverType, observer_list, func)                \
-  {                                                                         \
-    auto buffered_list = observer_list;                                     \
-    if (buffered_list.Size()) {                                             \
-      for (std::vector<ObserverType*>::iterator it = buffered_list.Begin(); \
-           it != buffered_list.End(); ++it)                                 \
-        (*it)->func;                                                        \
-    }                                                                       \
+#define FOR_EACH_OBSERVER(ObserverType, observer_list, func)          \
+  {                                                                   \
+    ObserverList<ObserverType>::Iterator observer_list_iterator(      \
+        &(observer_list));                                            \
+    while (ObserverType* observer_list_entry =                        \
+               observer_list_iterator.GetNext()) {                    \
+      observer_list_entry->func;                                      \
+    }                                                                 \
   }
 
 #endif  // UTIL_OBSERVER_LIST_H_
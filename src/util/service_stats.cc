@@ -0,0 +1,164 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "service_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void Histogram::Record(uint64_t value) {
+  buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (value > max &&
+         !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+void Histogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+size_t Histogram::BucketIndex(uint64_t value) {
+  size_t index = 0;
+  while (value && index < kBucketCount - 1) {
+    value >>= 1;
+    ++index;
+  }
+  return index;
+}
+
+uint64_t Histogram::BucketUpperBound(size_t index) {
+  if (index >= kBucketCount - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return (uint64_t{1} << index) - 1;
+}
+
+uint64_t Histogram::Percentile(double percentile) const {
+  uint64_t count = Count();
+  if (!count) {
+    return 0;
+  }
+
+  uint64_t rank = static_cast<uint64_t>(
+      std::ceil(percentile / 100.0 * static_cast<double>(count)));
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += BucketCount(i);
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), Max());
+    }
+  }
+  return Max();
+}
+
+Json::Value Histogram::ToJson() const {
+  Json::Value json(Json::objectValue);
+  json["count"] = static_cast<Json::UInt64>(Count());
+  json["sum"] = static_cast<Json::UInt64>(Sum());
+  json["max"] = static_cast<Json::UInt64>(Max());
+  json["p50"] = static_cast<Json::UInt64>(Percentile(50));
+  json["p90"] = static_cast<Json::UInt64>(Percentile(90));
+  json["p99"] = static_cast<Json::UInt64>(Percentile(99));
+
+  Json::Value buckets(Json::arrayValue);
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    uint64_t count = BucketCount(i);
+    if (!count) {
+      continue;
+    }
+    Json::Value bucket(Json::arrayValue);
+    bucket.append(static_cast<Json::UInt64>(BucketUpperBound(i)));
+    bucket.append(static_cast<Json::UInt64>(count));
+    buckets.append(bucket);
+  }
+  json["buckets"] = buckets;
+  return json;
+}
+
+void CallStats::Reset() {
+  latency_us.Reset();
+  request_bytes.Reset();
+  reply_bytes.Reset();
+}
+
+Json::Value CallStats::ToJson() const {
+  Json::Value json(Json::objectValue);
+  json["latencyUs"] = latency_us.ToJson();
+  json["requestBytes"] = request_bytes.ToJson();
+  json["replyBytes"] = reply_bytes.ToJson();
+  return json;
+}
+
+CallStats& ServiceStats::Find(CallStatsMap& map, const std::string& name) {
+  auto& stats = map[name];
+  if (!stats) {
+    stats = std::make_unique<CallStats>();
+  }
+  return *stats;
+}
+
+CallStats& ServiceStats::ForMethod(const std::string& name) {
+  return Find(methods_, name);
+}
+
+CallStats* ServiceStats::FindMethod(const std::string& name) const {
+  auto method = methods_.find(name);
+  return method != methods_.end() ? method->second.get() : nullptr;
+}
+
+CallStats& ServiceStats::ForSubscription(const std::string& name) {
+  return Find(subscriptions_, name);
+}
+
+void ServiceStats::Reset() {
+  for (auto& method : methods_) {
+    method.second->Reset();
+  }
+  for (auto& subscription : subscriptions_) {
+    subscription.second->Reset();
+  }
+}
+
+Json::Value ServiceStats::ToJson() const {
+  Json::Value methods(Json::objectValue);
+  for (const auto& method : methods_) {
+    methods[method.first] = method.second->ToJson();
+  }
+
+  Json::Value subscriptions(Json::objectValue);
+  for (const auto& subscription : subscriptions_) {
+    subscriptions[subscription.first] = subscription.second->ToJson();
+  }
+
+  Json::Value json(Json::objectValue);
+  json["methods"] = methods;
+  json["subscriptions"] = subscriptions;
+  return json;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_SERVICE_STATS_H_
+#define UTIL_SERVICE_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <json/value.h>
+
+// Histogram with fixed power-of-two buckets: bucket 0 counts zeros, bucket i
+// counts values in [2^(i-1), 2^i) and the last bucket everything above.
+// Recording is a handful of relaxed atomic operations, so it is cheap enough
+// for every bus call and can be read or reset from any thread.
+class Histogram {
+ public:
+  static constexpr size_t kBucketCount = 24;
+
+  Histogram() { Reset(); }
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void Record(uint64_t value);
+  void Reset();
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t Sum() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+  uint64_t BucketCount(size_t index) const {
+    return buckets_[index].load(std::memory_order_relaxed);
+  }
+  // Upper bound of the bucket holding the |percentile|th value, capped by
+  // the largest recorded value. Returns 0 when nothing was recorded.
+  uint64_t Percentile(double percentile) const;
+
+  // {"count", "sum", "max", "p50", "p90", "p99", "buckets"}, where buckets
+  // lists the non empty buckets as [upper bound, count] pairs.
+  Json::Value ToJson() const;
+
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketUpperBound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+// Call statistics of a single bus method or subscription.
+struct CallStats {
+  Histogram latency_us;
+  Histogram request_bytes;
+  Histogram reply_bytes;
+
+  void Reset();
+  Json::Value ToJson() const;
+};
+
+// Per method and per subscription statistics of a luna service. Entries are
+// created on first use from the service's main loop and never removed, so
+// the returned references stay valid for the lifetime of the registry.
+class ServiceStats {
+ public:
+  ServiceStats() = default;
+  ServiceStats(const ServiceStats&) = delete;
+  ServiceStats& operator=(const ServiceStats&) = delete;
+
+  CallStats& ForMethod(const std::string& name);
+  CallStats& ForSubscription(const std::string& name);
+  // Lookup only, safe from other threads once every method is registered
+  // with ForMethod()
+  CallStats* FindMethod(const std::string& name) const;
+
+  void Reset();
+  // {"methods": {name: CallStats}, "subscriptions": {name: CallStats}}
+  Json::Value ToJson() const;
+
+ private:
+  using CallStatsMap =
+      std::unordered_map<std::string, std::unique_ptr<CallStats>>;
+
+  static CallStats& Find(CallStatsMap& map, const std::string& name);
+
+  CallStatsMap methods_;
+  CallStatsMap subscriptions_;
+};
+
+#endif  // UTIL_SERVICE_STATS_H_
@@ -18,35 +18,33 @@
 
 #include <glib.h>
 
-static int TimeoutCallback(void* data) {
-  Timer* timer = static_cast<Timer*>(data);
-  bool is_repeating = timer->IsRepeating();
-  timer->HandleCallback();
-  return is_repeating;
-}
-
-static int TimeoutCallbackDestroy(void* data) {
-  Timer* timer = static_cast<Timer*>(data);
-  timer->HandleCallback();
-  delete timer;
-  return 0;
-}
+#include "main_loop_watchdog.h"
 
 void Timer::Start(int delay_in_milli_seconds, bool will_destroy) {
   is_running_ = true;
-  if (!will_destroy) {
-    source_id_ = g_timeout_add(delay_in_milli_seconds, TimeoutCallback, this);
-  } else {
-    source_id_ =
-        g_timeout_add(delay_in_milli_seconds, TimeoutCallbackDestroy, this);
-  }
+  will_destroy_ = will_destroy;
+  interval_ms_ = delay_in_milli_seconds;
+  TimerWheel::Default()->Schedule(this, delay_in_milli_seconds, slack_ms_);
 }
 
 void Timer::Stop() {
   is_running_ = false;
-  if (source_id_) {
-    g_source_remove(source_id_);
-    source_id_ = 0;
+  if (IsScheduled()) {
+    TimerWheel::Default()->Cancel(this);
+  }
+}
+
+void Timer::Fire(TimerWheel* wheel) {
+  if (is_repeating_) {
+    wheel->Schedule(this, interval_ms_, slack_ms_);
+  }
+
+  // The callback may delete the receiver and this timer with it
+  bool will_destroy = will_destroy_;
+  MainLoopWatchdog::Scope scope("timer", ReceiverName());
+  HandleCallback();
+  if (will_destroy) {
+    delete this;
   }
 }
 
@@ -17,12 +17,19 @@
 #ifndef UTIL_TIMER_H_
 #define UTIL_TIMER_H_
 
+#include <cstdint>
+#include <typeinfo>
+
+#include "timer_wheel.h"
+
 typedef struct _GTimer GTimer;
 
-class Timer {
+// Timers are multiplexed onto TimerWheel::Default(), so starting, stopping
+// and restarting one is cheap. Starting a running timer restarts it.
+class Timer : public TimerWheel::Entry {
  public:
   explicit Timer(bool is_repeating) : is_repeating_(is_repeating) {}
-  virtual ~Timer() = default;
+  ~Timer() override = default;
 
   // Timer
   virtual void HandleCallback() = 0;
@@ -32,13 +39,26 @@ class Timer {
   bool IsRepeating() { return is_repeating_; }
   void Stop();
 
+  // Lets the timer fire up to |slack_ms| late, together with other timers,
+  // for timers whose exact deadline does not matter. Applies from the next
+  // Start().
+  void SetSlackMs(int slack_ms) { slack_ms_ = slack_ms; }
+
  protected:
   void Running(bool is_running) { is_running_ = is_running; }
 
+  // TimerWheel::Entry
+  void Fire(TimerWheel* wheel) override;
+
+  // Names the timer to the main loop watchdog
+  virtual const char* ReceiverName() const { return nullptr; }
+
  private:
-  int source_id_ = 0;
   bool is_running_ = false;
   bool is_repeating_;
+  bool will_destroy_ = false;
+  int interval_ms_ = 0;
+  int slack_ms_ = 0;
 };
 
 template <class Receiver, bool kIsRepeating>
@@ -59,6 +79,10 @@ class BaseTimer : public Timer {
     (receiver_->*method_)();
   }
 
+  const char* ReceiverName() const override {
+    return typeid(Receiver).name();
+  }
+
   void StartWithReceiver(int delay_in_milli_seconds,
                          Receiver* receiver,
                          ReceiverMethod method,
@@ -68,7 +92,7 @@ class BaseTimer : public Timer {
     Start(delay_in_milli_seconds, will_destroy);
   }
 
- private:
+ protected:
   Receiver* receiver_ = nullptr;
   ReceiverMethod method_ = nullptr;
 };
@@ -95,6 +119,49 @@ class SingleShotTimer : public BaseTimer<Receiver, false> {
   SingleShotTimer() = default;
 };
 
+// One-shot timer for a deadline pushed back over and over, e.g. "nothing
+// happened for a while" checked on every frame. Pushing the deadline back
+// only records it; when the scheduled timeout fires before the recorded
+// deadline, the timer waits for the rest instead of calling back.
+template <class Receiver>
+class DeadlineTimer : public BaseTimer<Receiver, false> {
+ public:
+  typedef void (Receiver::*ReceiverMethod)();
+
+  // Calls |method| once |delay_in_milli_seconds| have passed since the
+  // last call, starting the timer if it is not running
+  void ExtendWithReceiver(int delay_in_milli_seconds,
+                          Receiver* receiver,
+                          ReceiverMethod method) {
+    this->receiver_ = receiver;
+    this->method_ = method;
+    int64_t deadline = TimerWheel::Default()->DeadlineIn(
+        delay_in_milli_seconds);
+    if (this->IsScheduled() && deadline >= this->Deadline()) {
+      deadline_ms_ = deadline;
+      return;
+    }
+    this->Start(delay_in_milli_seconds);
+  }
+
+  void Start(int delay_in_milli_seconds, bool will_destroy = false) override {
+    Timer::Start(delay_in_milli_seconds, will_destroy);
+    deadline_ms_ = this->Deadline();
+  }
+
+ protected:
+  void Fire(TimerWheel* wheel) override {
+    if (deadline_ms_ > wheel->Now()) {
+      wheel->ScheduleAt(this, deadline_ms_);
+      return;
+    }
+    Timer::Fire(wheel);
+  }
+
+ private:
+  int64_t deadline_ms_ = 0;
+};
+
 class ElapsedTimer {
  public:
   ElapsedTimer();
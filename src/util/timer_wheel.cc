@@ -0,0 +1,378 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <glib.h>
+
+namespace {
+
+constexpr uint64_t kSlotMask = TimerWheel::kSlots - 1;
+// Farther deadlines are parked in the last level and placed again when
+// they get there
+constexpr int64_t kRange = int64_t{1}
+                           << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+
+TimerWheel* g_wheel_for_testing = nullptr;
+
+int64_t MonotonicMs() {
+  return g_get_monotonic_time() / 1000;
+}
+
+inline int Shift(int level) {
+  return TimerWheel::kSlotBits * level;
+}
+
+inline uint64_t RotateRight(uint64_t bits, unsigned count) {
+  count &= 63;
+  return count ? (bits >> count) | (bits << (64 - count)) : bits;
+}
+
+}  // namespace
+
+TimerWheel::Entry::~Entry() {
+  if (wheel_) {
+    wheel_->Cancel(this);
+  }
+}
+
+TimerWheel::TimerWheel(Clock clock)
+    : clock_(clock ? std::move(clock) : Clock(&MonotonicMs)) {
+  now_ = clock_();
+  for (auto& level : slots_) {
+    for (Link& head : level) {
+      head.prev = head.next = &head;
+    }
+  }
+  due_.prev = due_.next = &due_;
+}
+
+TimerWheel::~TimerWheel() {
+  // Entries outliving the wheel are simply no longer scheduled
+  auto forget = [](Link& head) {
+    for (Link* link = head.next; link != &head;) {
+      Link* next = link->next;
+      link->entry->wheel_ = nullptr;
+      link->prev = link->next = nullptr;
+      link = next;
+    }
+  };
+  for (auto& level : slots_) {
+    for (Link& head : level) {
+      forget(head);
+    }
+  }
+  forget(due_);
+
+  if (source_) {
+    g_source_destroy(source_);
+    g_source_unref(source_);
+  }
+}
+
+TimerWheel* TimerWheel::Default() {
+  if (g_wheel_for_testing) {
+    return g_wheel_for_testing;
+  }
+
+  // Lives as long as the main loop
+  static TimerWheel* wheel = [] {
+    TimerWheel* default_wheel = new TimerWheel();
+    default_wheel->AttachSource();
+    return default_wheel;
+  }();
+  return wheel;
+}
+
+void TimerWheel::SetDefaultForTesting(TimerWheel* wheel) {
+  g_wheel_for_testing = wheel;
+}
+
+void TimerWheel::AttachSource() {
+  // No prepare() or check(): the source is driven by its ready time
+  static GSourceFuncs funcs = [] {
+    GSourceFuncs source_funcs = {};
+    source_funcs.dispatch = [](GSource*, GSourceFunc callback,
+                               gpointer data) -> gboolean {
+      return callback(data);
+    };
+    return source_funcs;
+  }();
+
+  source_ = g_source_new(&funcs, sizeof(GSource));
+  g_source_set_callback(source_, &TimerWheel::OnReady, this, nullptr);
+  g_source_attach(source_, g_main_context_default());
+}
+
+int TimerWheel::OnReady(void* data) {
+  TimerWheel* wheel = static_cast<TimerWheel*>(data);
+  wheel->armed_ = kStale;
+  wheel->AdvanceTo(wheel->clock_());
+  return G_SOURCE_CONTINUE;
+}
+
+void TimerWheel::Schedule(Entry* entry, int64_t delay_ms, int64_t slack_ms) {
+  if (delay_ms > 0) {
+    int64_t deadline = DeadlineIn(delay_ms);
+    ScheduleAt(entry, slack_ms > 0 ? ApplySlack(deadline, slack_ms) : deadline);
+    return;
+  }
+
+  if (entry->wheel_) {
+    entry->wheel_->Cancel(entry);
+  }
+
+  int64_t now = clock_();
+  entry->deadline_ = now;
+  entry->wheel_ = this;
+  Link& link = entry->link_;
+  link.entry = entry;
+  link.prev = due_.prev;
+  link.next = &due_;
+  due_.prev->next = &link;
+  due_.prev = &link;
+  ++size_;
+
+  if (!advancing_) {
+    ArmSource(now);
+  }
+}
+
+void TimerWheel::ScheduleAt(Entry* entry, int64_t deadline_ms) {
+  if (entry->wheel_) {
+    entry->wheel_->Cancel(entry);
+  }
+
+  // Nothing to cascade, the wheel can catch up with the clock right away
+  if (!size_ && !advancing_) {
+    now_ = std::max(now_, clock_());
+  }
+
+  int64_t deadline = std::max(deadline_ms, now_ + 1);
+  entry->deadline_ = deadline;
+  entry->wheel_ = this;
+  entry->link_.entry = entry;
+  Insert(entry);
+  ++size_;
+
+  if (!advancing_ && (armed_ < 0 || deadline < armed_)) {
+    ArmSource(deadline);
+  }
+}
+
+void TimerWheel::Cancel(Entry* entry) {
+  if (entry->wheel_ != this) {
+    if (entry->wheel_) {
+      entry->wheel_->Cancel(entry);
+    }
+    return;
+  }
+
+  // The source stays armed for the entry's deadline; the wakeup finds
+  // nothing due and arms it for the next one
+  Unlink(entry);
+  entry->wheel_ = nullptr;
+  --size_;
+}
+
+void TimerWheel::AdvanceTo(int64_t now_ms) {
+  // Callbacks may not advance the wheel they are fired from
+  if (advancing_) {
+    return;
+  }
+
+  advancing_ = true;
+  // Entries scheduled from here on without delay wait for the next call
+  Link pending;
+  pending.prev = pending.next = &pending;
+  Splice(due_, pending);
+  Fire(pending);
+
+  while (now_ < now_ms) {
+    int64_t tick = size_ ? NextEventTick() : now_ms;
+    if (tick > now_ms) {
+      now_ = now_ms;
+      break;
+    }
+
+    now_ = tick;
+    for (int level = kLevels - 1; level > 0; --level) {
+      if (!(tick & ((int64_t{1} << Shift(level)) - 1))) {
+        Cascade(level, (tick >> Shift(level)) & kSlotMask);
+      }
+    }
+    Expire(tick & kSlotMask);
+  }
+  advancing_ = false;
+
+  ArmSource(NextDeadline());
+}
+
+int64_t TimerWheel::NextDeadline() const {
+  if (due_.next != &due_) {
+    return due_.next->entry->deadline_;
+  }
+
+  int64_t next = -1;
+  for (int level = 0; level < kLevels; ++level) {
+    if (!occupied_[level]) {
+      continue;
+    }
+
+    // Slots after the current one hold the earlier deadlines
+    int64_t block = now_ >> Shift(level);
+    size_t start = (block + 1) & kSlotMask;
+    size_t slot =
+        (start + __builtin_ctzll(RotateRight(occupied_[level], start))) &
+        kSlotMask;
+    const Link& head = slots_[level][slot];
+    for (const Link* link = head.next; link != &head; link = link->next) {
+      if (next < 0 || link->entry->deadline_ < next) {
+        next = link->entry->deadline_;
+      }
+    }
+  }
+  return next;
+}
+
+int64_t TimerWheel::ApplySlack(int64_t deadline, int64_t slack_ms) {
+  int64_t limit = deadline + slack_ms;
+  uint64_t differing = static_cast<uint64_t>(deadline ^ limit);
+  if (!differing) {
+    return deadline;
+  }
+  int64_t mask = (int64_t{1} << (63 - __builtin_clzll(differing))) - 1;
+  return limit & ~mask;
+}
+
+void TimerWheel::Insert(Entry* entry) {
+  int64_t deadline = entry->deadline_;
+  int64_t delta = deadline - now_;
+  if (delta >= kRange) {
+    deadline = now_ + kRange - 1;
+    delta = kRange - 1;
+  }
+
+  int level = 0;
+  while (level < kLevels - 1 && delta >= (int64_t{1} << Shift(level + 1))) {
+    ++level;
+  }
+  size_t slot = (deadline >> Shift(level)) & kSlotMask;
+
+  // Appended, so that entries with the same deadline fire in order
+  Link& head = slots_[level][slot];
+  Link& link = entry->link_;
+  link.prev = head.prev;
+  link.next = &head;
+  head.prev->next = &link;
+  head.prev = &link;
+  occupied_[level] |= uint64_t{1} << slot;
+}
+
+void TimerWheel::Unlink(Entry* entry) {
+  Link& link = entry->link_;
+  Link* prev = link.prev;
+  Link* next = link.next;
+  prev->next = next;
+  next->prev = prev;
+  link.prev = link.next = nullptr;
+
+  // Only a list head has no entry
+  if (prev == next && !prev->entry) {
+    ClearOccupied(prev);
+  }
+}
+
+void TimerWheel::ClearOccupied(const Link* head) {
+  const Link* first = &slots_[0][0];
+  std::less<const Link*> less;
+  if (less(head, first) || !less(head, first + kLevels * kSlots)) {
+    return;
+  }
+  size_t index = static_cast<size_t>(head - first);
+  occupied_[index / kSlots] &= ~(uint64_t{1} << (index % kSlots));
+}
+
+void TimerWheel::Splice(Link& from, Link& to) {
+  if (from.next == &from) {
+    return;
+  }
+  from.next->prev = to.prev;
+  to.prev->next = from.next;
+  from.prev->next = &to;
+  to.prev = from.prev;
+  from.prev = from.next = &from;
+  ClearOccupied(&from);
+}
+
+void TimerWheel::Cascade(int level, size_t slot) {
+  Link pending;
+  pending.prev = pending.next = &pending;
+  Splice(slots_[level][slot], pending);
+
+  while (pending.next != &pending) {
+    Entry* entry = pending.next->entry;
+    Unlink(entry);
+    Insert(entry);
+  }
+}
+
+void TimerWheel::Expire(size_t slot) {
+  Link pending;
+  pending.prev = pending.next = &pending;
+  Splice(slots_[0][slot], pending);
+  Fire(pending);
+}
+
+void TimerWheel::Fire(Link& pending) {
+  // One at a time, a callback may cancel or delete the entries after it
+  while (pending.next != &pending) {
+    Entry* entry = pending.next->entry;
+    Unlink(entry);
+    entry->wheel_ = nullptr;
+    --size_;
+    entry->Fire(this);
+  }
+}
+
+int64_t TimerWheel::NextEventTick() const {
+  int64_t next = std::numeric_limits<int64_t>::max();
+  for (int level = 0; level < kLevels; ++level) {
+    if (!occupied_[level]) {
+      continue;
+    }
+
+    // The first block after the current one whose slot is occupied; for
+    // levels above 0 that is where the slot is cascaded
+    int64_t block = now_ >> Shift(level);
+    size_t start = (block + 1) & kSlotMask;
+    int64_t distance = __builtin_ctzll(RotateRight(occupied_[level], start));
+    next = std::min(next, (block + 1 + distance) << Shift(level));
+  }
+  return next;
+}
+
+void TimerWheel::ArmSource(int64_t deadline) {
+  if (!source_ || deadline == armed_) {
+    return;
+  }
+  armed_ = deadline;
+  g_source_set_ready_time(source_, deadline < 0 ? -1 : deadline * 1000);
+}
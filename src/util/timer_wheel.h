@@ -0,0 +1,142 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_TIMER_WHEEL_H_
+#define UTIL_TIMER_WHEEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+typedef struct _GSource GSource;
+
+// Hierarchical timer wheel: kLevels wheels of kSlots slots, level L slots
+// kSlots^L milliseconds wide. Scheduling, cancelling and rescheduling are
+// O(1) list operations, and entries move down a level at most once per
+// level as their deadline comes closer. The wheel returned by Default()
+// drives every Timer from a single GSource on the default main context,
+// woken up for the earliest deadline only.
+//
+// A wheel is not thread safe; Default() belongs to the main thread.
+class TimerWheel {
+ public:
+  // Monotonic milliseconds
+  using Clock = std::function<int64_t()>;
+
+  static constexpr int kSlotBits = 6;
+  static constexpr size_t kSlots = size_t{1} << kSlotBits;
+  static constexpr int kLevels = 4;
+
+  class Entry {
+   public:
+    Entry() = default;
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+    virtual ~Entry();
+
+    bool IsScheduled() const { return wheel_ != nullptr; }
+    int64_t Deadline() const { return deadline_; }
+
+   protected:
+    // Called once the deadline has passed, the entry is no longer
+    // scheduled by then and may be scheduled again or deleted
+    virtual void Fire(TimerWheel* wheel) = 0;
+
+   private:
+    friend class TimerWheel;
+
+    struct Link {
+      Link* prev = nullptr;
+      Link* next = nullptr;
+      Entry* entry = nullptr;
+    };
+
+    Link link_;
+    TimerWheel* wheel_ = nullptr;
+    int64_t deadline_ = 0;
+  };
+
+  // The default clock is g_get_monotonic_time(). Only Default() fires on
+  // its own, other wheels fire from AdvanceTo().
+  explicit TimerWheel(Clock clock = {});
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+  ~TimerWheel();
+
+  static TimerWheel* Default();
+  // Timers started while |wheel| is set use it instead of the default one;
+  // nullptr restores the default
+  static void SetDefaultForTesting(TimerWheel* wheel);
+
+  // Fires |entry| once |delay_ms| have passed, that is at Now() +
+  // |delay_ms| + 1, or up to |slack_ms| later so that it fires together
+  // with other entries. Like g_timeout_add(0), a delay of 0 fires on the
+  // next AdvanceTo() whatever the time. Reschedules |entry| if already
+  // scheduled.
+  void Schedule(Entry* entry, int64_t delay_ms, int64_t slack_ms = 0);
+  // Fires |entry| at |deadline_ms|, or on the next tick if that has passed
+  void ScheduleAt(Entry* entry, int64_t deadline_ms);
+  void Cancel(Entry* entry);
+
+  // Fires the entries scheduled without delay, then, in deadline order,
+  // every entry due by |now_ms|
+  void AdvanceTo(int64_t now_ms);
+  // Earliest deadline, -1 when nothing is scheduled
+  int64_t NextDeadline() const;
+  size_t Size() const { return size_; }
+  int64_t Now() const { return clock_(); }
+  // The current millisecond has partly elapsed already: the first tick a
+  // full |delay_ms| away is the one after, so that nothing fires early
+  int64_t DeadlineIn(int64_t delay_ms) const { return Now() + delay_ms + 1; }
+
+  // Deadline moved later, up to |slack_ms|, to the coarsest boundary in
+  // reach, so that deadlines close to each other end up equal
+  static int64_t ApplySlack(int64_t deadline, int64_t slack_ms);
+
+ private:
+  using Link = Entry::Link;
+
+  static int OnReady(void* data);
+
+  void AttachSource();
+  void Insert(Entry* entry);
+  void Unlink(Entry* entry);
+  void ClearOccupied(const Link* head);
+  void Splice(Link& from, Link& to);
+  void Cascade(int level, size_t slot);
+  void Expire(size_t slot);
+  void Fire(Link& pending);
+  int64_t NextEventTick() const;
+  void ArmSource(int64_t deadline);
+
+  Clock clock_;
+  // Ticks up to and including |now_| have been processed
+  int64_t now_ = 0;
+  Link slots_[kLevels][kSlots];
+  // Entries scheduled without delay
+  Link due_;
+  uint64_t occupied_[kLevels] = {};
+  size_t size_ = 0;
+  bool advancing_ = false;
+
+  GSource* source_ = nullptr;
+  // Ready time of |source_| in milliseconds, -1 when not armed and
+  // kStale once it has fired
+  static constexpr int64_t kStale = -2;
+  int64_t armed_ = -1;
+};
+
+#endif  // UTIL_TIMER_WHEEL_H_
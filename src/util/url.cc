@@ -16,43 +16,123 @@
 
 #include "url.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #include <glib.h>
 
 namespace {
 
-std::string GetSubString(const std::string& str,
-                         std::size_t start,
-                         std::size_t end) {
-  return str.substr(
-      start, end == std::string::npos ? str.size() - start : end - start);
+bool IsUnreserved(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' ||
+         c == '~';
+}
+
+// Length of the well-formed UTF-8 sequence at the start of |str|, or 0
+size_t Utf8SequenceLength(std::string_view str) {
+  auto byte = [&str](size_t i) { return static_cast<unsigned char>(str[i]); };
+
+  size_t length;
+  uint32_t code_point;
+  uint32_t min_code_point;
+  if (byte(0) >= 0xC0 && byte(0) <= 0xDF) {
+    length = 2;
+    code_point = byte(0) & 0x1F;
+    min_code_point = 0x80;
+  } else if (byte(0) >= 0xE0 && byte(0) <= 0xEF) {
+    length = 3;
+    code_point = byte(0) & 0x0F;
+    min_code_point = 0x800;
+  } else if (byte(0) >= 0xF0 && byte(0) <= 0xF4) {
+    length = 4;
+    code_point = byte(0) & 0x07;
+    min_code_point = 0x10000;
+  } else {
+    return 0;
+  }
+  if (str.size() < length) {
+    return 0;
+  }
+
+  for (size_t i = 1; i < length; ++i) {
+    if ((byte(i) & 0xC0) != 0x80) {
+      return 0;
+    }
+    code_point = (code_point << 6) | (byte(i) & 0x3F);
+  }
+
+  // Overlong forms, surrogates and values past U+10FFFF are malformed
+  if (code_point < min_code_point || code_point > 0x10FFFF ||
+      (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+    return 0;
+  }
+  return length;
+}
+
+void ToLowerInPlace(std::string& str, size_t begin, size_t size) {
+  auto first = str.begin() + begin;
+  std::transform(first, first + size, first, [](unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a')
+                                : static_cast<char>(c);
+  });
 }
 
 }  // namespace
 
 namespace wam {
 
-Url::Url(const std::string& uri) {
-  ParseUri(uri);
+Url::Url(std::string uri) : uri_(std::move(uri)) {
+  ParseUri();
+}
+
+std::string Url::Escape(std::string_view str) {
+  static const char kHexDigits[] = "0123456789ABCDEF";
+
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (size_t i = 0; i < str.size();) {
+    auto c = static_cast<unsigned char>(str[i]);
+    if (c >= 0x80) {
+      size_t length = Utf8SequenceLength(str.substr(i));
+      if (length) {
+        escaped.append(str.data() + i, length);
+        i += length;
+        continue;
+      }
+    }
+    if (IsUnreserved(c)) {
+      escaped += static_cast<char>(c);
+    } else {
+      escaped += '%';
+      escaped += kHexDigits[c >> 4];
+      escaped += kHexDigits[c & 0x0F];
+    }
+    ++i;
+  }
+  return escaped;
 }
 
 void Url::SetQuery(const UrlQuery& query) {
-  query_.clear();
+  std::string new_query;
   for (const auto& q : query) {
-    gchar* escaped_key = g_uri_escape_string(q.first.c_str(), nullptr, true);
-    gchar* escaped_val = g_uri_escape_string(q.second.c_str(), nullptr, true);
-    query_ += query_.empty() ? '?' : '&';
-    query_ += std::string(escaped_key) + "=" + escaped_val;
-    g_free(escaped_key);
-    g_free(escaped_val);
+    new_query += new_query.empty() ? '?' : '&';
+    new_query += Escape(q.first);
+    new_query += '=';
+    new_query += Escape(q.second);
   }
-}
 
-std::string Url::ToString() const {
-  return uri_ + query_ + fragment_;
+  size_t query_begin = path_.begin + path_.size;
+  uri_.replace(query_begin, query_.size, new_query);
+  query_ = {query_begin, new_query.size()};
+  if (fragment_.size) {
+    fragment_.begin = query_begin + new_query.size();
+  }
 }
 
 std::string Url::ToLocalFile() const {
-  g_autofree gchar* cpath = g_filename_from_uri(uri_.c_str(), nullptr, nullptr);
+  std::string uri(uri_, 0, path_.begin + path_.size);
+  g_autofree gchar* cpath = g_filename_from_uri(uri.c_str(), nullptr, nullptr);
   return cpath ? std::string(cpath) : std::string();
 }
 
@@ -62,7 +142,7 @@ Url Url::FromLocalFile(const std::string& path) {
 }
 
 bool Url::IsLocalFile() const {
-  return scheme_ == "file";
+  return Scheme() == "file";
 }
 
 std::string Url::FileName() const {
@@ -77,55 +157,64 @@ std::string Url::FileName() const {
   return local.substr(found + 1, local.size() - found);
 }
 
-void Url::ParseUri(const std::string& uri) {
-  auto scheme_delimiter = uri.find(':');
-  if (scheme_delimiter != std::string::npos) {
-    scheme_ = uri.substr(0, scheme_delimiter);
+// Single pass over the URI following the component split of RFC 3986
+// appendix B, with the authority further split into host and port.
+void Url::ParseUri() {
+  const size_t size = uri_.size();
+  size_t pos = 0;
+
+  size_t scheme_end = uri_.find_first_of(":/?#");
+  if (scheme_end != std::string::npos && scheme_end > 0 &&
+      uri_[scheme_end] == ':') {
+    scheme_ = {0, scheme_end};
+    pos = scheme_end + 1;
   }
 
-  auto authority_start = uri.find("//");
-  if (authority_start != std::string::npos) {
-    authority_start += 2;
-  }
-  auto authority_end = uri.find_first_of("/?#", authority_start);
-
-  if (authority_start != std::string::npos) {
-    auto host_start = authority_start;
-    auto user_info_end = uri.find('@', authority_start);
-    if (user_info_end != std::string::npos) {
-      host_start = user_info_end + 1;
+  if (uri_.compare(pos, 2, "//") == 0) {
+    size_t authority_begin = pos + 2;
+    size_t authority_end =
+        std::min(uri_.find_first_of("/?#", authority_begin), size);
+    std::string_view authority(uri_.data() + authority_begin,
+                               authority_end - authority_begin);
+
+    size_t host_begin = authority_begin;
+    size_t user_info_end = authority.rfind('@');
+    if (user_info_end != std::string_view::npos) {
+      host_begin += user_info_end + 1;
     }
-    auto host_end = uri.find_first_of(":/?#", host_start);
-    if (host_start != std::string::npos) {
-      host_ = GetSubString(uri, host_start, host_end);
+
+    size_t host_end;
+    if (host_begin < authority_end && uri_[host_begin] == '[') {
+      // IP literal, its colons don't start the port
+      host_end = uri_.find(']', host_begin);
+      host_end = host_end < authority_end ? host_end + 1 : authority_end;
+    } else {
+      host_end = std::min(uri_.find(':', host_begin), authority_end);
     }
-    if (host_end != std::string::npos && uri[host_end] == ':') {
-      port_ = GetSubString(uri, host_end + 1, authority_end);
+    host_ = {host_begin, host_end - host_begin};
+
+    if (host_end < authority_end && uri_[host_end] == ':') {
+      port_ = {host_end + 1, authority_end - host_end - 1};
     }
+    pos = authority_end;
   }
 
-  auto path_end = uri.find_first_of("?#", authority_end);
-  // Save part of the original uri without query and fragment.
-  uri_ = GetSubString(uri, 0, path_end);
-
-  if (authority_start == std::string::npos) {
-    path_ = uri.substr(scheme_delimiter + 1, uri.size() - scheme_delimiter);
-  } else if (authority_end != std::string::npos) {
-    if (uri[authority_end] == '/') {
-      path_ = GetSubString(uri, authority_end, path_end);
-    }
+  size_t path_end = std::min(uri_.find_first_of("?#", pos), size);
+  path_ = {pos, path_end - pos};
+  pos = path_end;
 
-    auto query_start = uri.find("?", authority_end);
-    if (query_start != std::string::npos) {
-      auto query_end = uri.find("#", query_start);
-      query_ = GetSubString(uri, query_start, query_end);
-    }
+  if (pos < size && uri_[pos] == '?') {
+    size_t query_end = std::min(uri_.find('#', pos), size);
+    query_ = {pos, query_end - pos};
+    pos = query_end;
+  }
 
-    auto fragment_start = uri.find("#", authority_end);
-    if (fragment_start != std::string::npos) {
-      fragment_ = GetSubString(uri, fragment_start, uri.size());
-    }
+  if (pos < size) {
+    fragment_ = {pos, size - pos};
   }
+
+  ToLowerInPlace(uri_, scheme_.begin, scheme_.size);
+  ToLowerInPlace(uri_, host_.begin, host_.size);
 }
 
 }  // namespace wam
@@ -17,41 +17,63 @@
 #ifndef UTIL_URL_H_
 #define UTIL_URL_H_
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace wam {
 
+// URI split into its RFC 3986 components. The components are views into
+// the owned URI, so parsing allocates nothing beyond taking the string and
+// the views stay valid until the Url is modified or destroyed. Scheme and
+// host, which are case insensitive, are lowercased in place.
 class Url {
  public:
   typedef std::vector<std::pair<std::string, std::string>> UrlQuery;
-  explicit Url(const std::string& uri);
+  explicit Url(std::string uri);
   ~Url() = default;
 
-  std::string Scheme() const { return scheme_; }
-  std::string Host() const { return host_; }
-  std::string Port() const { return port_; }
-  std::string Path() const { return path_; }
-  std::string Query() const { return query_; }
-  std::string Fragment() const { return fragment_; }
+  std::string_view Scheme() const { return View(scheme_); }
+  std::string_view Host() const { return View(host_); }
+  std::string_view Port() const { return View(port_); }
+  std::string_view Path() const { return View(path_); }
+  // With the leading '?', if any
+  std::string_view Query() const { return View(query_); }
+  // With the leading '#', if any
+  std::string_view Fragment() const { return View(fragment_); }
 
+  // Replaces the query with |query|, percent-encoding keys and values
   void SetQuery(const UrlQuery& query);
-  std::string ToString() const;
+  const std::string& ToString() const { return uri_; }
   std::string ToLocalFile() const;
   static Url FromLocalFile(const std::string& path);
   bool IsLocalFile() const;
   std::string FileName() const;
 
+  // Percent-encodes everything but unreserved characters and valid UTF-8
+  // sequences, like g_uri_escape_string(str, nullptr, true)
+  static std::string Escape(std::string_view str);
+
  private:
-  void ParseUri(const std::string& uri);
+  struct Component {
+    size_t begin = 0;
+    size_t size = 0;
+  };
+
+  std::string_view View(Component component) const {
+    return std::string_view(uri_).substr(component.begin, component.size);
+  }
+  void ParseUri();
+
   std::string uri_;
-  std::string scheme_;
-  std::string host_;
-  std::string port_;
-  std::string path_;
-  std::string query_;
-  std::string fragment_;
+  Component scheme_;
+  Component host_;
+  Component port_;
+  Component path_;
+  Component query_;
+  Component fragment_;
 };
 
 }  // namespace wam
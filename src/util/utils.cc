@@ -18,11 +18,11 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <limits>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -34,6 +34,16 @@
 #include "log_manager.h"
 
 #include "bcp47.h"
+#include "file_contents.h"
+#include "url.h"
+
+namespace {
+
+inline bool IsSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+}  // namespace
 
 namespace util {
 
@@ -102,24 +112,7 @@ std::string GetHostname(const std::string& url) {
   if (url.empty()) {
     return std::string();
   }
-
-  // source https://datatracker.ietf.org/doc/html/rfc3986#appendix-B
-
-  std::regex rfc3986_regex(
-      R"(^(([^:\/?#]+):)?(\/\/([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
-  std::regex authority_regex(R"(^(?:[\w\:]+[@])?([\w.]+)(?:[:])?(?:[0-9]+)?)");
-  std::smatch matches;
-
-  if (!std::regex_match(url, matches, rfc3986_regex)) {
-    return std::string();
-  }
-
-  std::string authority = matches[4];
-  if (!std::regex_match(authority, matches, authority_regex)) {
-    return std::string();
-  }
-
-  return matches[1];
+  return std::string(wam::Url(url).Host());
 }
 
 bool DoesPathExist(const std::string& path) {
@@ -136,13 +129,9 @@ bool DoesPathExist(const std::string& path) {
 }
 
 std::string ReadFile(const std::string& path) {
-  if (!DoesPathExist(path)) {
-    return std::string();
-  }
-
-  std::ifstream file(path);
-  return std::string(std::istreambuf_iterator<char>(file),
-                     std::istreambuf_iterator<char>());
+  std::string contents;
+  ReadFileToString(path, contents);
+  return contents;
 }
 
 std::string UriToLocal(const std::string& uri) {
@@ -189,52 +178,146 @@ int StrToIntWithDefault(const std::string& str, int default_value) {
 
 std::vector<std::string> SplitString(const std::string& str, char delimiter) {
   std::vector<std::string> res_list;
-  std::stringstream ss(str);
-  std::string s;
-
-  while (std::getline(ss, s, delimiter)) {
-    res_list.push_back(s);
+  for (std::string_view piece : Split(str, delimiter)) {
+    res_list.emplace_back(piece);
   }
-
   return res_list;
 }
 
 std::string TrimString(const std::string& str) {
-  auto begin = str.begin();
-  auto end = str.end();
+  return std::string(Trim(str));
+}
 
-  while (begin != end && isspace(static_cast<unsigned char>(*begin))) {
-    ++begin;
+void ReplaceSubstr(std::string& in,
+                   const std::string& to_search,
+                   const std::string& replace_str /* ="" */) {
+  if (to_search.empty() || in.find(to_search) == std::string::npos) {
+    return;
   }
 
-  while (begin != end && isspace(static_cast<unsigned char>(*(end - 1)))) {
+  std::string replaced;
+  ReplaceAll(in, {{to_search, replace_str}}, replaced);
+  in.swap(replaced);
+}
+
+std::string_view Trim(std::string_view str) {
+  size_t begin = 0;
+  size_t end = str.size();
+  while (begin != end && IsSpace(str[begin])) {
+    ++begin;
+  }
+  while (begin != end && IsSpace(str[end - 1])) {
     --end;
   }
+  return str.substr(begin, end - begin);
+}
 
-  std::string trimmed(begin, end);
-  return trimmed;
+void TrimInPlace(std::string& str) {
+  std::string_view trimmed = Trim(str);
+  if (trimmed.size() == str.size()) {
+    return;
+  }
+  size_t begin = static_cast<size_t>(trimmed.data() - str.data());
+  str.erase(begin + trimmed.size());
+  str.erase(0, begin);
 }
 
-void ReplaceSubstr(std::string& in,
-                   const std::string& to_search,
-                   const std::string& replace_str /* ="" */) {
-  size_t pos = in.find(to_search);
-  while (pos != std::string::npos) {
-    in.replace(pos, to_search.size(), replace_str);
-    pos = in.find(to_search, pos + replace_str.size());
+void ReplaceAll(std::string_view in,
+                std::initializer_list<Replacement> replacements,
+                std::string& out) {
+  // Candidates are found by their first byte: with memchr() per distinct
+  // first byte when there are few of them, with a table lookup per byte
+  // otherwise
+  const size_t kMaxScanned = 4;
+  char firsts[kMaxScanned];
+  size_t next[kMaxScanned];
+  size_t first_count = 0;
+  bool starts[256] = {};
+  size_t slack = 0;
+  for (const Replacement& replacement : replacements) {
+    if (replacement.first.empty()) {
+      continue;
+    }
+    unsigned char first = static_cast<unsigned char>(replacement.first[0]);
+    if (!starts[first] && first_count <= kMaxScanned) {
+      if (first_count < kMaxScanned) {
+        firsts[first_count] = static_cast<char>(first);
+      }
+      ++first_count;
+    }
+    starts[first] = true;
+    slack = std::max(slack, replacement.second.size());
+  }
+  out.reserve(out.size() + in.size() + slack);
+
+  // |next| holds the position of each first byte at or after the last
+  // lookup, in.size() if there is none
+  auto find_next = [&](size_t k, size_t from) {
+    const void* found = memchr(in.data() + from, firsts[k], in.size() - from);
+    next[k] = found ? static_cast<size_t>(static_cast<const char*>(found) -
+                                          in.data())
+                    : in.size();
+  };
+  for (size_t k = 0; k < first_count && k < kMaxScanned; ++k) {
+    find_next(k, 0);
+  }
+
+  auto find_candidate = [&](size_t from) {
+    if (first_count > kMaxScanned) {
+      while (from < in.size() &&
+             !starts[static_cast<unsigned char>(in[from])]) {
+        ++from;
+      }
+      return from;
+    }
+    size_t candidate = in.size();
+    for (size_t k = 0; k < first_count; ++k) {
+      if (next[k] < from) {
+        find_next(k, from);
+      }
+      candidate = std::min(candidate, next[k]);
+    }
+    return candidate;
+  };
+
+  size_t plain = 0;
+  size_t i = find_candidate(0);
+  while (i < in.size()) {
+    const Replacement* match = nullptr;
+    for (const Replacement& replacement : replacements) {
+      const std::string_view& pattern = replacement.first;
+      if (!pattern.empty() && pattern.size() <= in.size() - i &&
+          pattern[0] == in[i] &&
+          std::char_traits<char>::compare(in.data() + i, pattern.data(),
+                                          pattern.size()) == 0) {
+        match = &replacement;
+        break;
+      }
+    }
+    if (!match) {
+      i = find_candidate(i + 1);
+      continue;
+    }
+
+    out.append(in.data() + plain, i - plain);
+    out.append(match->second.data(), match->second.size());
+    i += match->first.size();
+    plain = i;
+    i = find_candidate(i);
   }
+  out.append(in.data() + plain, in.size() - plain);
 }
 
 // JSON
-bool StringToJson(const std::string& str, Json::Value& value) {
+bool StringToJson(std::string_view str, Json::Value& value) {
   Json::CharReaderBuilder builder;
   Json::CharReaderBuilder::strictMode(&builder.settings_);
   std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
 
-  return reader->parse(str.c_str(), str.c_str() + str.size(), &value, nullptr);
+  return reader->parse(str.data(), str.data() + str.size(), &value, nullptr);
 }
 
-Json::Value StringToJson(const std::string& str) {
+Json::Value StringToJson(std::string_view str) {
   Json::Value result;
   return StringToJson(str, result) ? std::move(result)
                                    : Json::Value(Json::nullValue);
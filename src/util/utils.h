@@ -17,7 +17,12 @@
 #ifndef UTIL_UTILS_H_
 #define UTIL_UTILS_H_
 
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <json/json.h>
@@ -48,9 +53,94 @@ void ReplaceSubstr(std::string& in,
                    const std::string& to_search,
                    const std::string& replace_str = {});
 
+// Pieces of a string between delimiters, found one at a time while
+// iterating and pointing into the string. Like SplitString(): "a,,b" gives
+// "a", "", "b", a trailing delimiter gives no empty piece and "" nothing.
+//
+//   for (std::string_view piece : util::Split(list, ',')) { ... }
+class SplitRange {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    Iterator() = default;
+    Iterator(std::string_view str, char delimiter)
+        : rest_(str), delimiter_(delimiter), at_end_(false) {
+      Advance();
+    }
+
+    reference operator*() const { return piece_; }
+    pointer operator->() const { return &piece_; }
+    Iterator& operator++() {
+      Advance();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      Advance();
+      return previous;
+    }
+    bool operator==(const Iterator& other) const {
+      return at_end_ == other.at_end_ &&
+             (at_end_ || piece_.data() == other.piece_.data());
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    void Advance() {
+      if (rest_.empty()) {
+        at_end_ = true;
+        return;
+      }
+      size_t delimiter = rest_.find(delimiter_);
+      piece_ = rest_.substr(0, delimiter);
+      rest_ = delimiter == std::string_view::npos
+                  ? std::string_view()
+                  : rest_.substr(delimiter + 1);
+    }
+
+    std::string_view rest_;
+    std::string_view piece_;
+    char delimiter_ = 0;
+    bool at_end_ = true;
+  };
+
+  SplitRange(std::string_view str, char delimiter)
+      : str_(str), delimiter_(delimiter) {}
+
+  Iterator begin() const { return Iterator(str_, delimiter_); }
+  Iterator end() const { return Iterator(); }
+
+ private:
+  std::string_view str_;
+  char delimiter_;
+};
+
+inline SplitRange Split(std::string_view str, char delimiter) {
+  return SplitRange(str, delimiter);
+}
+
+// Without leading and trailing whitespace, as isspace() in the C locale
+std::string_view Trim(std::string_view str);
+void TrimInPlace(std::string& str);
+
+// Appends |in| to |out| with every occurrence of the patterns replaced, in
+// one pass from left to right. Where several patterns match, the first
+// listed wins; empty patterns never match. Keeps |out|'s capacity, so a
+// buffer reused across calls stops allocating.
+using Replacement = std::pair<std::string_view, std::string_view>;
+void ReplaceAll(std::string_view in,
+                std::initializer_list<Replacement> replacements,
+                std::string& out);
+
 // JSON
-bool StringToJson(const std::string& str, Json::Value& value);
-Json::Value StringToJson(const std::string& str);
+bool StringToJson(std::string_view str, Json::Value& value);
+Json::Value StringToJson(std::string_view str);
 std::string JsonToString(const Json::Value& value);
 
 }  // namespace util
@@ -26,6 +26,7 @@
 #include "platform_module_factory_impl.h"
 #include "utils.h"
 #include "web_app_manager.h"
+#include "web_app_manager_config.h"
 #include "web_app_manager_service_luna.h"
 
 static void ChangeUserIDGroupID() {
@@ -61,6 +62,10 @@ static void StartWebAppManager() {
 
   WebAppManagerServiceLuna* luna_service = WebAppManagerServiceLuna::Instance();
   assert(luna_service);
+  // The platform modules are only set up once the service is registered, so
+  // the dispatch setting is read from a configuration of its own
+  luna_service->SetDispatchOnBusThread(
+      WebAppManagerConfig().IsLunaDispatchThreadEnabled());
   [[maybe_unused]] bool result = luna_service->StartService();
   assert(result);
   WebAppManager::Instance()->SetPlatformModules(
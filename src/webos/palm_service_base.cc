@@ -17,12 +17,14 @@
 #include "palm_service_base.h"
 
 #include "log_manager.h"
+#include "main_loop_watchdog.h"
 #include "utils.h"
 
 PalmServiceBase::PalmServiceBase() = default;
 
 PalmServiceBase::~PalmServiceBase() {
   StopService();
+  StopBusThread();
 }
 
 bool PalmServiceBase::StartService() {
@@ -54,14 +56,24 @@ bool PalmServiceBase::StartService() {
     return false;
   }
 
-  if (!LSGmainAttach(service_handle_, MainLoop(), &ls_error)) {
+  // Known up front so that the bus thread only ever looks entries up
+  for (const LSMethod* method = Methods(); method && method->name; ++method) {
+    stats_.ForMethod(method->name);
+  }
+
+  bool attached = dispatch_on_bus_thread_
+                      ? StartBusThread(ls_error)
+                      : LSGmainAttach(service_handle_, MainLoop(), &ls_error);
+  if (!attached) {
     LOG_ERROR(MSGID_REG_LS2_ATTACH_FAIL, 2,
               PMLOGKS("SERVICE", service_name_.c_str()),
               PMLOGKS("ERROR", ls_error.message), "");
     StopService();
     return false;
   }
-  LOG_DEBUG("Successfully registered %s on service bus", service_name_.c_str());
+  LOG_DEBUG("Successfully registered %s on service bus%s",
+            service_name_.c_str(),
+            bus_thread_.joinable() ? " (dispatched on own thread)" : "");
 
   DidConnect();
 
@@ -73,6 +85,9 @@ bool PalmServiceBase::StopService() {
     return true;
   }
 
+  // The handle must not be dispatched while being unregistered
+  StopBusThread();
+
   LSErrorSafe ls_error;
   if (!LSUnregister(service_handle_, &ls_error)) {
     service_handle_ = nullptr;
@@ -99,6 +114,10 @@ bool PalmServiceBase::Call(LSHandle* handle,
     return false;
   }
 
+  if (context) {
+    context->service_base_ = this;
+  }
+
   LSErrorSafe ls_error;
   bool call_ret;
   if (parameters["subscribe"] == true || parameters["watch"] == true) {
@@ -137,6 +156,253 @@ bool PalmServiceBase::Call(LSHandle* handle,
   return true;
 }
 
+bool PalmServiceBase::PostSubscription(const char* subscription,
+                                       Json::Value reply) {
+  CallStats* stats = &stats_.ForSubscription(subscription);
+  auto post = [this, subscription = std::string(subscription), stats](
+                  const Json::Value& reply) {
+    auto start = std::chrono::steady_clock::now();
+    return SendSubscriptionUpdate(subscription.c_str(), stats,
+                                  util::JsonToString(reply), start);
+  };
+
+  if (!bus_tasks_) {
+    return post(reply);
+  }
+
+  // Serialized and posted from the bus thread, the result isn't known here
+  bus_tasks_->Post([post, reply = std::move(reply)]() { post(reply); });
+  return true;
+}
+
+bool PalmServiceBase::PostSubscription(const char* subscription,
+                                       const JsonWriter& reply) {
+  CallStats* stats = &stats_.ForSubscription(subscription);
+  if (!bus_tasks_) {
+    return SendSubscriptionUpdate(subscription, stats, reply.str(),
+                                  std::chrono::steady_clock::now());
+  }
+
+  bus_tasks_->Post([this, subscription = std::string(subscription), stats,
+                    payload = reply.str()]() {
+    SendSubscriptionUpdate(subscription.c_str(), stats, payload,
+                           std::chrono::steady_clock::now());
+  });
+  return true;
+}
+
+bool PalmServiceBase::DispatchMethodCall(LSHandle* handle,
+                                         LSMessage* message,
+                                         MethodHandler handler) {
+  const char* payload = LSMessageGetPayload(message);
+  CallStatsRecorder recorder(
+      stats_.FindMethod(util::GetString(LSMessageGetMethod(message))),
+      payload);
+
+  Json::Value request;
+  if (!util::StringToJson(payload, request)) {
+    LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
+    return false;
+  }
+
+  if (!main_tasks_) {
+    Json::Value value;
+    if (!RunMethodHandler(handle, message, recorder, handler, request,
+                          &value)) {
+      return true;
+    }
+    return SendReply(handle, message, util::JsonToString(value), recorder);
+  }
+
+  // Only the parsed request goes to the main thread, the reply comes back
+  // here to be serialized and sent
+  LSMessageRef(message);
+  main_tasks_->Post([this, handle, message, recorder,
+                     handler = std::move(handler),
+                     request = std::move(request)]() {
+    Json::Value value;
+    if (!RunMethodHandler(handle, message, recorder, handler, request,
+                          &value)) {
+      LSMessageUnref(message);
+      return;
+    }
+    bus_tasks_->Post([handle, message, recorder, value = std::move(value)]() {
+      SendReply(handle, message, util::JsonToString(value), recorder);
+      LSMessageUnref(message);
+    });
+  });
+  return true;
+}
+
+bool PalmServiceBase::DispatchStreamedMethodCall(LSHandle* handle,
+                                                 LSMessage* message,
+                                                 WriterHandler handler) {
+  const char* payload = LSMessageGetPayload(message);
+  CallStatsRecorder recorder(
+      stats_.FindMethod(util::GetString(LSMessageGetMethod(message))),
+      payload);
+
+  Json::Value request;
+  if (!util::StringToJson(payload, request)) {
+    LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
+    return false;
+  }
+
+  if (!main_tasks_) {
+    reply_writer_.Clear();
+    {
+      MainLoopWatchdog::Scope scope("luna", LSMessageGetMethod(message));
+      handler(request, &reply_writer_);
+    }
+    return SendReply(handle, message, reply_writer_.str(), recorder);
+  }
+
+  // The handler reads main thread state, so the reply is written there and
+  // only the finished payload is handed back to the bus thread
+  LSMessageRef(message);
+  main_tasks_->Post([this, handle, message, recorder,
+                     handler = std::move(handler),
+                     request = std::move(request)]() {
+    reply_writer_.Clear();
+    {
+      MainLoopWatchdog::Scope scope("luna", LSMessageGetMethod(message));
+      handler(request, &reply_writer_);
+    }
+    bus_tasks_->Post(
+        [handle, message, recorder, payload = reply_writer_.str()]() {
+          SendReply(handle, message, payload, recorder);
+          LSMessageUnref(message);
+        });
+  });
+  return true;
+}
+
+PalmServiceBase::ReplySender PalmServiceBase::DeferReply() {
+  if (!current_call_ || current_call_->deferred) {
+    return ReplySender();
+  }
+
+  current_call_->deferred = true;
+  LSHandle* handle = current_call_->handle;
+  LSMessage* message = current_call_->message;
+  CallStatsRecorder recorder = *current_call_->recorder;
+  LSMessageRef(message);
+  return [this, handle, message, recorder](const Json::Value& reply) {
+    if (!bus_tasks_) {
+      SendReply(handle, message, util::JsonToString(reply), recorder);
+      LSMessageUnref(message);
+      return;
+    }
+    bus_tasks_->Post([handle, message, recorder, reply]() {
+      SendReply(handle, message, util::JsonToString(reply), recorder);
+      LSMessageUnref(message);
+    });
+  };
+}
+
+bool PalmServiceBase::RunMethodHandler(LSHandle* handle,
+                                       LSMessage* message,
+                                       const CallStatsRecorder& recorder,
+                                       const MethodHandler& handler,
+                                       const Json::Value& request,
+                                       Json::Value* reply) {
+  CurrentCall call{handle, message, &recorder, false};
+  CurrentCall* outer_call = current_call_;
+  current_call_ = &call;
+  {
+    MainLoopWatchdog::Scope scope("luna", LSMessageGetMethod(message));
+    *reply = handler(request);
+  }
+  current_call_ = outer_call;
+  return !call.deferred;
+}
+
+void PalmServiceBase::RunOnMainThread(ContextTaskQueue::Task task) {
+  if (!main_tasks_) {
+    task();
+    return;
+  }
+  main_tasks_->Post(std::move(task));
+}
+
+bool PalmServiceBase::SendReply(LSHandle* handle,
+                                LSMessage* message,
+                                const std::string& payload,
+                                const CallStatsRecorder& recorder) {
+  LSErrorSafe ls_error;
+  bool result = LSMessageReply(handle, message, payload.c_str(), &ls_error);
+  recorder.Finish(payload.size());
+  return result;
+}
+
+bool PalmServiceBase::SendSubscriptionUpdate(
+    const char* subscription,
+    CallStats* stats,
+    const std::string& payload,
+    std::chrono::steady_clock::time_point start) {
+  LSErrorSafe ls_error;
+  bool result = LSSubscriptionPost(service_handle_, Category(), subscription,
+                                   payload.c_str(), &ls_error);
+
+  stats->reply_bytes.Record(payload.size());
+  stats->latency_us.Record(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  return result;
+}
+
+bool PalmServiceBase::StartBusThread(LSErrorSafe& ls_error) {
+  bus_context_ = g_main_context_new();
+  if (!LSGmainContextAttach(service_handle_, bus_context_, &ls_error)) {
+    g_main_context_unref(bus_context_);
+    bus_context_ = nullptr;
+    return false;
+  }
+
+  bus_loop_ = g_main_loop_new(bus_context_, FALSE);
+  main_tasks_ = std::make_unique<ContextTaskQueue>(
+      g_main_loop_get_context(MainLoop()));
+  bus_tasks_ = std::make_unique<ContextTaskQueue>(bus_context_);
+
+  bus_thread_ = std::thread([this]() {
+    g_main_context_push_thread_default(bus_context_);
+    g_main_loop_run(bus_loop_);
+    g_main_context_pop_thread_default(bus_context_);
+  });
+  return true;
+}
+
+void PalmServiceBase::StopBusThread() {
+  if (bus_thread_.joinable()) {
+    // Quit from within the loop, it may not be running yet
+    GMainLoop* loop = bus_loop_;
+    bus_tasks_->Post([loop]() { g_main_loop_quit(loop); });
+    bus_thread_.join();
+  }
+
+  // Calls still queued are run to the end rather than dropped, so that
+  // every caller gets its reply and every message its LSMessageUnref().
+  // With the bus thread gone, its queue is run from here.
+  if (main_tasks_) {
+    size_t ran = 0;
+    do {
+      ran = main_tasks_->RunPendingTasks();
+      ran += bus_tasks_->RunPendingTasks();
+    } while (ran);
+  }
+  bus_tasks_.reset();
+  main_tasks_.reset();
+  if (bus_loop_) {
+    g_main_loop_unref(bus_loop_);
+    bus_loop_ = nullptr;
+  }
+  if (bus_context_) {
+    g_main_context_unref(bus_context_);
+    bus_context_ = nullptr;
+  }
+}
+
 GMainLoop* PalmServiceBase::MainLoop() const {
   static GMainLoop* s_main_loop = nullptr;
   if (!s_main_loop) {
@@ -145,6 +411,51 @@ GMainLoop* PalmServiceBase::MainLoop() const {
   return s_main_loop;
 }
 
+bool LSCallbackHandler::Callback(LSHandle* handle,
+                                 LSMessage* message,
+                                 void* user_data) {
+  LSErrorSafe ls_error;
+
+  Json::Value request;
+  if (!message ||
+      !util::StringToJson(LSMessageGetPayload(message), request)) {
+    return LSMessageReply(handle, message, "{\"returnValue\": false}",
+                          &ls_error);
+  }
+
+  auto* handler = static_cast<LSCallbackHandler*>(user_data);
+  PalmServiceBase* service_base = handler->service_base_;
+  if (!service_base || !service_base->main_tasks_) {
+    Json::Value reply = handler->Called(std::move(request));
+    if (reply.isNull()) {
+      return true;
+    }
+    return LSMessageReply(handle, message, util::JsonToString(reply).c_str(),
+                          &ls_error);
+  }
+
+  LSMessageRef(message);
+  service_base->main_tasks_->Post([service_base, handler, handle, message,
+                                   alive = handler->alive_,
+                                   request = std::move(request)]() {
+    Json::Value reply;
+    if (*alive) {
+      reply = handler->Called(request);
+    }
+    if (reply.isNull()) {
+      LSMessageUnref(message);
+      return;
+    }
+    service_base->bus_tasks_->Post(
+        [handle, message, payload = util::JsonToString(reply)]() {
+          LSErrorSafe ls_error;
+          LSMessageReply(handle, message, payload.c_str(), &ls_error);
+          LSMessageUnref(message);
+        });
+  });
+  return true;
+}
+
 bool LSCalloutContext::Cancel() {
   if (token_ == LSMESSAGE_TOKEN_INVALID || service_ == nullptr) {
     LOG_WARNING(MSGID_LS2_CANCEL_NOT_ACTIVE, 0,
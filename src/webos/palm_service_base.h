@@ -17,13 +17,23 @@
 #ifndef WEBOS_PALM_SERVICE_BASE_H_
 #define WEBOS_PALM_SERVICE_BASE_H_
 
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
+#include <string>
+#include <thread>
 
 #include <glib.h>
 #include <json/json.h>
 #include <luna-service2/lunaservice.h>
 
+#include "context_task_queue.h"
+#include "json_writer.h"
 #include "log_manager.h"
+#include "main_loop_watchdog.h"
+#include "service_stats.h"
 #include "utils.h"
 
 class LSHandle;
@@ -53,46 +63,21 @@ class LSCallbackHandler {
       std::function<Json::Value(const Json::Value&)>& func)
       : func_(func) {}
 
-  virtual ~LSCallbackHandler() = default;
+  virtual ~LSCallbackHandler() { *alive_ = false; }
   friend class PalmServiceBase;
 
  protected:
   Json::Value Called(Json::Value payload) { return func_(payload); }
 
-  static bool Callback(LSHandle* handle, LSMessage* message, void* user_data) {
-    LSErrorSafe ls_error;
-
-    if (!message) {
-      if (!LSMessageReply(handle, message, "{\"returnValue\": false}",
-                          &ls_error)) {
-        return false;
-      }
-      return true;
-    }
-
-    Json::Value request;
-    if (!util::StringToJson(LSMessageGetPayload(message), request)) {
-      if (!LSMessageReply(handle, message, "{\"returnValue\": false}",
-                          &ls_error)) {
-        return false;
-      }
-      return true;
-    }
-
-    Json::Value reply;
-
-    reply =
-        static_cast<LSCallbackHandler*>(user_data)->Called(std::move(request));
-
-    if (!reply.isNull()) {
-      return LSMessageReply(handle, message, util::JsonToString(reply).c_str(),
-                            &ls_error);
-    } else {
-      return true;
-    }
-  }
+  // Runs |func_| on the main thread, and sends its reply from the thread the
+  // bus is dispatched on
+  static bool Callback(LSHandle* handle, LSMessage* message, void* user_data);
 
   std::function<Json::Value(const Json::Value&)> func_;
+  // Set by PalmServiceBase::Call(), whose threads the callback runs on
+  PalmServiceBase* service_base_ = nullptr;
+  // Replies queued for the main thread are dropped once the handler is gone
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
 };
 
 /**
@@ -114,6 +99,36 @@ class LSCalloutContext : public LSCallbackHandler {
   LSMessageToken token_ = LSMESSAGE_TOKEN_INVALID;
 };
 
+/**
+ * Measures a bus method invocation, from parsing the request to sending the
+ * reply, into the CallStats of the method. Copyable so that it can follow
+ * a call dispatched to the main thread and back.
+ */
+class CallStatsRecorder {
+ public:
+  CallStatsRecorder(CallStats* stats, const char* payload)
+      : stats_(stats), start_(std::chrono::steady_clock::now()) {
+    if (stats_) {
+      stats_->request_bytes.Record(payload ? std::strlen(payload) : 0);
+    }
+  }
+
+  void Finish(size_t reply_size) const {
+    if (!stats_) {
+      return;
+    }
+    stats_->reply_bytes.Record(reply_size);
+    stats_->latency_us.Record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_)
+            .count());
+  }
+
+ private:
+  CallStats* stats_;
+  std::chrono::steady_clock::time_point start_;
+};
+
 /**
  * a function template that wraps a given function expecting and returning
  * Json::Value in a static function that is compatible with the LunaService
@@ -140,21 +155,11 @@ static bool bus_callback_json(LSHandle* handle,
     return true;
   }
 
-  Json::Value request;
-  if (!util::StringToJson(LSMessageGetPayload(message), request)) {
-    LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
-    return false;
-  }
-  Json::Value reply;
-
-  reply = (static_cast<CLASS*>(user_data)->*FUNCTION)(request);
-
-  if (!LSMessageReply(handle, message, util::JsonToString(reply).c_str(),
-                      &ls_error)) {
-    return false;
-  }
-
-  return true;
+  CLASS* service = static_cast<CLASS*>(user_data);
+  return service->DispatchMethodCall(
+      handle, message, [service](const Json::Value& request) {
+        return (service->*FUNCTION)(request);
+      });
 }
 
 template <class CLASS,
@@ -179,25 +184,91 @@ static bool bus_subscription_callback_json(LSHandle* handle,
     }
   }
 
-  Json::Value request;
-  if (!util::StringToJson(LSMessageGetPayload(message), request)) {
-    LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
-    return false;
+  CLASS* service = static_cast<CLASS*>(user_data);
+  return service->DispatchMethodCall(
+      handle, message, [service, subscribed](const Json::Value& request) {
+        Json::Value reply = (service->*FUNCTION)(request, subscribed);
+        if (subscribed) {
+          reply["subscribed"] = true;
+        }
+        return reply;
+      });
+}
+
+/*
+ * same as above, for functions writing their reply with a JsonWriter.
+ * FUNCTION writes the members of the reply object, which is opened and
+ * closed here.
+ */
+template <class CLASS,
+          void (CLASS::*FUNCTION)(const Json::Value&, JsonWriter* reply)>
+static bool bus_callback_writer(LSHandle* handle,
+                                LSMessage* message,
+                                void* user_data) {
+  LSErrorSafe ls_error;
+
+  if (!message) {
+    if (!LSMessageReply(handle, message, "{\"returnValue\": false}",
+                        &ls_error)) {
+      return false;
+    }
+    return true;
   }
-  Json::Value reply;
 
-  reply = (static_cast<CLASS*>(user_data)->*FUNCTION)(request, subscribed);
+  CLASS* service = static_cast<CLASS*>(user_data);
+  return service->DispatchStreamedMethodCall(
+      handle, message,
+      [service](const Json::Value& request, JsonWriter* reply) {
+        reply->BeginObject();
+        (service->*FUNCTION)(request, reply);
+        reply->EndObject();
+      });
+}
+
+template <class CLASS,
+          void (CLASS::*FUNCTION)(const Json::Value&,
+                                  bool subscribed,
+                                  JsonWriter* reply)>
+static bool bus_subscription_callback_writer(LSHandle* handle,
+                                             LSMessage* message,
+                                             void* user_data) {
+  LSErrorSafe ls_error;
 
-  if (subscribed) {
-    reply["subscribed"] = true;
+  if (!message) {
+    if (!LSMessageReply(handle, message, "{\"returnValue\": false}",
+                        &ls_error)) {
+      return false;
+    }
+    return true;
   }
 
-  if (!LSMessageReply(handle, message, util::JsonToString(reply).c_str(),
-                      &ls_error)) {
-    return false;
+  bool subscribed = false;
+  if (LSMessageIsSubscription(message)) {
+    if (!LSSubscriptionProcess(handle, message, &subscribed, &ls_error)) {
+      return false;
+    }
   }
 
-  return true;
+  CLASS* service = static_cast<CLASS*>(user_data);
+  return service->DispatchStreamedMethodCall(
+      handle, message,
+      [service, subscribed](const Json::Value& request, JsonWriter* reply) {
+        reply->BeginObject();
+        (service->*FUNCTION)(request, subscribed, reply);
+        if (subscribed) {
+          reply->Key("subscribed").Bool(true);
+        }
+        reply->EndObject();
+      });
+}
+
+/*
+ * name of FUNCTION, as passed to PalmServiceBase::Call(), for the watchdog
+ */
+template <class CLASS, void (CLASS::*FUNCTION)(const Json::Value&)>
+const char*& bus_callback_name() {
+  static const char* name = "";
+  return name;
 }
 
 /*
@@ -214,7 +285,12 @@ static bool bus_callback_json(LSHandle* /*handle*/,
     }
   }
 
-  (static_cast<CLASS*>(user_data)->*FUNCTION)(reply);
+  const char* name = bus_callback_name<CLASS, FUNCTION>();
+  CLASS* receiver = static_cast<CLASS*>(user_data);
+  receiver->RunOnMainThread([receiver, reply, name]() {
+    MainLoopWatchdog::Scope scope("luna-reply", name);
+    (receiver->*FUNCTION)(reply);
+  });
 
   return true;
 }
@@ -245,14 +321,48 @@ class PalmServiceBase {
    * methods to post subscription updates TODO make subscriptions represented
    *through objects
    **/
-  bool PostSubscription(const char* subscription, Json::Value reply) {
-    LSErrorSafe ls_error;
-    return LSSubscriptionPost(service_handle_, Category(), subscription,
-                              util::JsonToString(reply).c_str(), &ls_error);
-  }
+  bool PostSubscription(const char* subscription, Json::Value reply);
+  // Posts a reply written with a JsonWriter, which the caller may reuse
+  // right away
+  bool PostSubscription(const char* subscription, const JsonWriter& reply);
 
   virtual void DidConnect() = 0;
 
+  // Latency and payload size histograms of the methods called on this
+  // service and of the subscription updates it posts
+  ServiceStats& Stats() { return stats_; }
+
+  // Runs bus I/O, request parsing and reply serialization on a thread with
+  // its own GMainContext, so that bus traffic can't delay input and
+  // rendering on the main loop. Method handlers and reply callbacks still
+  // run on the main thread. Must be set before StartService().
+  void SetDispatchOnBusThread(bool enabled) {
+    dispatch_on_bus_thread_ = enabled;
+  }
+
+  // Parses the request of |message|, runs |handler| on the main thread and
+  // replies with its result
+  using MethodHandler = std::function<Json::Value(const Json::Value&)>;
+  bool DispatchMethodCall(LSHandle* handle,
+                          LSMessage* message,
+                          MethodHandler handler);
+  // Same for handlers writing their reply straight into a JsonWriter, which
+  // spares building a Json::Value tree for large replies. The reply is sent
+  // as soon as the handler returns: DeferReply() is not available to them.
+  using WriterHandler = std::function<void(const Json::Value&, JsonWriter*)>;
+  bool DispatchStreamedMethodCall(LSHandle* handle,
+                                  LSMessage* message,
+                                  WriterHandler handler);
+  void RunOnMainThread(ContextTaskQueue::Task task);
+
+  // Called from a MethodHandler to reply later instead of with its return
+  // value, which is then ignored. The returned sender must be run exactly
+  // once, on the main thread. Returns an empty function outside of a bus
+  // method call, e.g. when the handler is called directly, and in a
+  // WriterHandler.
+  using ReplySender = std::function<void(const Json::Value&)>;
+  ReplySender DeferReply();
+
  protected:
   /*
    * helper methods for simple calls that come back into methods using a bit of
@@ -261,12 +371,15 @@ class PalmServiceBase {
    * invocations from the bus has to happen through individual callback
    * handlers. Using these template, we create a new static callback function
    * for each HANDLER_CLASS::CALLBACK_METHOD to forward the call to.
+   * |callback_name| names CALLBACK_METHOD in main loop lag reports.
    * */
   template <class HANDLER_CLASS,
             void (HANDLER_CLASS::*CALLBACK_METHOD)(const Json::Value&)>
   bool Call(const char* what,
             Json::Value parameters,
-            HANDLER_CLASS* callback_receiver) {
+            HANDLER_CLASS* callback_receiver,
+            const char* callback_name) {
+    bus_callback_name<HANDLER_CLASS, CALLBACK_METHOD>() = callback_name;
     LSErrorSafe ls_error;
     bool err = false;
     if (parameters.isObject() &&
@@ -296,6 +409,8 @@ class PalmServiceBase {
   LSHandle* service_handle_ = nullptr;
 
  private:
+  friend class LSCallbackHandler;
+
   static bool ServiceConnectCallback(LSHandle* sh,
                                      LSMessage* message,
                                      void* ctx);
@@ -305,7 +420,47 @@ class PalmServiceBase {
             Json::Value parameters,
             const char* application_id,
             LSCalloutContext* context);
+  static bool SendReply(LSHandle* handle,
+                        LSMessage* message,
+                        const std::string& payload,
+                        const CallStatsRecorder& recorder);
+  bool SendSubscriptionUpdate(const char* subscription,
+                              CallStats* stats,
+                              const std::string& payload,
+                              std::chrono::steady_clock::time_point start);
+  // Runs |handler| with DeferReply() bound to |message|. Returns false if
+  // the handler deferred its reply.
+  bool RunMethodHandler(LSHandle* handle,
+                        LSMessage* message,
+                        const CallStatsRecorder& recorder,
+                        const MethodHandler& handler,
+                        const Json::Value& request,
+                        Json::Value* reply);
+  bool StartBusThread(LSErrorSafe& ls_error);
+  // Joins the bus thread, then runs the calls and replies still queued on
+  // the calling (main) thread
+  void StopBusThread();
+
   std::string service_name_;
+  ServiceStats stats_;
+  // Reused for every streamed reply, only touched on the main thread
+  JsonWriter reply_writer_;
+
+  // The bus method call whose handler is running, for DeferReply()
+  struct CurrentCall {
+    LSHandle* handle;
+    LSMessage* message;
+    const CallStatsRecorder* recorder;
+    bool deferred;
+  };
+  CurrentCall* current_call_ = nullptr;
+
+  bool dispatch_on_bus_thread_ = false;
+  GMainContext* bus_context_ = nullptr;
+  GMainLoop* bus_loop_ = nullptr;
+  std::thread bus_thread_;
+  std::unique_ptr<ContextTaskQueue> main_tasks_;
+  std::unique_ptr<ContextTaskQueue> bus_tasks_;
 };
 
 #endif  // WEBOS_PALM_SERVICE_BASE_H_
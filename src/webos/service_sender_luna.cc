@@ -25,20 +25,30 @@
 
 void ServiceSenderLuna::PostlistRunningApps(
     std::vector<ApplicationInfo>& apps) {
-  Json::Value reply;
-  Json::Value running_apps;
-  for (const ApplicationInfo& app_info : apps) {
-    Json::Value app_json;
-    app_json["id"] = app_info.app_id_;
-    app_json["instanceid"] = app_info.instance_id_;
-    app_json["webprocessid"] = std::to_string(app_info.pid_);
-    running_apps.append(app_json);
+  // Posted on every app launch and close, so the buffer is kept around
+  writer_.Clear();
+  // Subscribers get null, not an empty array, when nothing runs
+  writer_.BeginObject().Key("running");
+  if (apps.empty()) {
+    writer_.Null();
+  } else {
+    writer_.BeginArray();
+    for (const ApplicationInfo& app_info : apps) {
+      writer_.BeginObject()
+          .Key("id")
+          .String(app_info.app_id_)
+          .Key("instanceid")
+          .String(app_info.instance_id_)
+          .Key("webprocessid")
+          .String(std::to_string(app_info.pid_))
+          .EndObject();
+    }
+    writer_.EndArray();
   }
-  reply["running"] = std::move(running_apps);
-  reply["returnValue"] = true;
+  writer_.Key("returnValue").Bool(true).EndObject();
 
   WebAppManagerServiceLuna::Instance()->PostSubscription("listRunningApps",
-                                                         std::move(reply));
+                                                         writer_);
 }
 
 void ServiceSenderLuna::PostWebProcessCreated(const std::string& app_id,
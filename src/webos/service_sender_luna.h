@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include "json_writer.h"
 #include "service_sender.h"
 
 class ServiceSenderLuna : public ServiceSender {
@@ -31,6 +32,9 @@ class ServiceSenderLuna : public ServiceSender {
                    const std::string& payload,
                    const std::string& app_id) override;
   void CloseApp(const std::string& id) override;
+
+ private:
+  JsonWriter writer_;
 };
 
 #endif  // WEBOS_SERVICE_SENDER_LUNA_H_
@@ -16,13 +16,16 @@
 
 #include "web_app_manager_service_luna.h"
 
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <json/json.h>
 #include "webos/public/runtime.h"
 #include "webos/webview_base.h"
 
+#include "json_schema.h"
 #include "log_manager.h"
 #include "utils.h"
 #include "web_app_manager_tracer.h"
@@ -37,16 +40,28 @@
   { #FUNC, QCB(FUNC), LUNA_METHOD_FLAGS_NONE }
 #define LS2_SUBSCRIPTION_ENTRY(FUNC) \
   { #FUNC, QCB_subscription(FUNC), LUNA_METHOD_FLAGS_NONE }
-
-#define GET_LS2_SERVER_STATUS(FUNC, PARAMS)                        \
-  Call<WebAppManagerServiceLuna, &WebAppManagerServiceLuna::FUNC>( \
-      "luna://com.palm.lunabus/signal/registerServerStatus", PARAMS, this)
+// for methods writing their reply with a JsonWriter
+#define QCB_writer(FUNC) \
+  bus_callback_writer<WebAppManagerServiceLuna, &WebAppManagerServiceLuna::FUNC>
+#define QCB_writer_subscription(FUNC)                        \
+  bus_subscription_callback_writer<WebAppManagerServiceLuna, \
+                                   &WebAppManagerServiceLuna::FUNC>
+#define LS2_WRITER_METHOD_ENTRY(FUNC) \
+  { #FUNC, QCB_writer(FUNC), LUNA_METHOD_FLAGS_NONE }
+#define LS2_WRITER_SUBSCRIPTION_ENTRY(FUNC) \
+  { #FUNC, QCB_writer_subscription(FUNC), LUNA_METHOD_FLAGS_NONE }
+
+#define GET_LS2_SERVER_STATUS(FUNC, PARAMS)                                \
+  Call<WebAppManagerServiceLuna, &WebAppManagerServiceLuna::FUNC>(         \
+      "luna://com.palm.lunabus/signal/registerServerStatus", PARAMS, this, \
+      #FUNC)
 #define LS2_CALL(FUNC, SERVICE, PARAMS)                            \
   Call<WebAppManagerServiceLuna, &WebAppManagerServiceLuna::FUNC>( \
-      SERVICE, PARAMS, this)
+      SERVICE, PARAMS, this, #FUNC)
 
 LSMethod WebAppManagerServiceLuna::methods_[] = {
     LS2_METHOD_ENTRY(launchApp),
+    LS2_METHOD_ENTRY(launchApps),
     LS2_METHOD_ENTRY(killApp),
     LS2_METHOD_ENTRY(pauseApp),
     LS2_METHOD_ENTRY(closeAllApps),
@@ -54,13 +69,61 @@ LSMethod WebAppManagerServiceLuna::methods_[] = {
     LS2_METHOD_ENTRY(setInspectorEnable),
 #endif
     LS2_METHOD_ENTRY(logControl),
-    LS2_METHOD_ENTRY(getWebProcessSize),
+    LS2_WRITER_METHOD_ENTRY(getWebProcessSize),
     LS2_METHOD_ENTRY(clearBrowsingData),
-    LS2_SUBSCRIPTION_ENTRY(listRunningApps),
+    LS2_METHOD_ENTRY(getConfig),
+    LS2_METHOD_ENTRY(reloadConfig),
+    LS2_METHOD_ENTRY(getServiceStats),
+    LS2_METHOD_ENTRY(getLaunchTimelines),
+    LS2_METHOD_ENTRY(getMainLoopLag),
+    LS2_WRITER_SUBSCRIPTION_ENTRY(listRunningApps),
     LS2_SUBSCRIPTION_ENTRY(webProcessCreated),
     {}};
 
-WebAppManagerServiceLuna::WebAppManagerServiceLuna() = default;
+namespace {
+
+using Type = JsonSchema::Type;
+
+// Fills |reply| with |error_code| and |error_text| if |request| doesn't
+// match |schema|. What is wrong is only logged, clients get the same
+// error text as ever.
+bool CheckRequest(const JsonSchema& schema,
+                  const Json::Value& request,
+                  ErrorCode error_code,
+                  const std::string& error_text,
+                  Json::Value& reply) {
+  std::string error;
+  if (schema.Validate(request, &error)) {
+    return true;
+  }
+
+  LOG_DEBUG("Invalid request: %s", error.c_str());
+  reply["returnValue"] = false;
+  reply["errorCode"] = error_code;
+  reply["errorText"] = error_text;
+  return false;
+}
+
+}  // namespace
+
+WebAppManagerServiceLuna::WebAppManagerServiceLuna()
+    : launch_app_schema_({{"appDesc.id", Type::kString, true},
+                          {"parameters", Type::kObject, false},
+                          {"launchingAppId", Type::kString, false},
+                          {"launchingProcId", Type::kString, false},
+                          {"instanceId", Type::kString, true},
+                          {"replyOn", Type::kString, false,
+                           "launch|firstFrame"}}),
+      launch_apps_schema_({{"launches", Type::kArray, true}}),
+      kill_app_schema_({{"instanceId", Type::kString, false},
+                        {"appId", Type::kString, false},
+                        {"reason", Type::kString, false}}),
+      pause_app_schema_({{"instanceId", Type::kString, true}}),
+      log_control_schema_({{"keys", Type::kString, true},
+                           {"value", Type::kString, true}}),
+      get_service_stats_schema_({{"reset", Type::kBool, false}}),
+      get_launch_timelines_schema_({{"reset", Type::kBool, false}}),
+      get_main_loop_lag_schema_({{"reset", Type::kBool, false}}) {}
 
 WebAppManagerServiceLuna::~WebAppManagerServiceLuna() = default;
 
@@ -71,24 +134,170 @@ bool WebAppManagerServiceLuna::StartService() {
 Json::Value WebAppManagerServiceLuna::launchApp(const Json::Value& request) {
   PMTRACE_FUNCTION;
 
-  int err_code;
-  std::string err_msg;
   Json::Value reply;
+  if (!CheckLaunchRequest(request, reply)) {
+    return reply;
+  }
+
+  // "launch" replies as soon as the launch is started, "firstFrame" once the
+  // app has something on screen. A launch queued by admission control is
+  // replied to once it has started either way.
+  std::string reply_on = request.get("replyOn", "launch").asString();
+
+  reply = Launch(request);
+  if (!reply["returnValue"].asBool()) {
+    return reply;
+  }
+  std::string instance_id = reply["instanceId"].asString();
+  bool queued = IsLaunchQueued(instance_id);
+  if (!queued && reply_on != "firstFrame") {
+    return reply;
+  }
+
+  ReplySender send = DeferReply();
+  if (!send) {
+    return reply;
+  }
+  if (!queued) {
+    SendOnFirstFrame(instance_id, std::move(send), std::move(reply));
+    return Json::Value();
+  }
+  OnReplyWhenLaunched(
+      instance_id, [this, instance_id, send, reply,
+                    reply_on](const Json::Value& result) mutable {
+        for (const std::string& key : result.getMemberNames()) {
+          reply[key] = result[key];
+        }
+        if (reply_on == "firstFrame" && reply["returnValue"].asBool()) {
+          SendOnFirstFrame(instance_id, std::move(send), std::move(reply));
+          return;
+        }
+        send(reply);
+      });
+  return Json::Value();
+}
 
-  if (!request.isObject() ||
-      (!request.isMember("appDesc") || !request["appDesc"].isObject() ||
-       !request["appDesc"]["id"].isString()) ||
-      (request.isMember("parameters") && !request["parameters"].isObject()) ||
-      (request.isMember("launchingAppId") &&
-       !request["launchingAppId"].isString()) ||
-      (request.isMember("launchingProcId") &&
-       !request["launchingProcId"].isString()) ||
-      (!request.isMember("instanceId") || !request["instanceId"].isString())) {
+void WebAppManagerServiceLuna::SendOnFirstFrame(const std::string& instance_id,
+                                                ReplySender send,
+                                                Json::Value reply) {
+  bool deferred = OnReplyOnFirstFrame(
+      instance_id, [send, reply](const Json::Value& result) mutable {
+        for (const std::string& key : result.getMemberNames()) {
+          reply[key] = result[key];
+        }
+        send(reply);
+      });
+  // Relaunch of an app which is on screen already
+  if (!deferred) {
+    send(reply);
+  }
+}
+
+Json::Value WebAppManagerServiceLuna::launchApps(const Json::Value& request) {
+  PMTRACE_FUNCTION;
+
+  Json::Value reply;
+  if (!CheckRequest(launch_apps_schema_, request, kErrCodeInvalidParam,
+                    kErrInvalidParam, reply)) {
+    return reply;
+  }
+
+  const Json::Value& launches = request["launches"];
+  if (launches.empty()) {
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeInvalidParam;
+    reply["errorText"] = kErrEmptyArray;
+    return reply;
+  }
+
+  // Checked all together first, a bad entry fails the batch before any app
+  // is launched
+  std::unordered_set<std::string> instance_ids;
+  for (Json::ArrayIndex i = 0; i < launches.size(); ++i) {
+    if (!CheckLaunchRequest(launches[i], reply)) {
+      reply["index"] = i;
+      return reply;
+    }
+    if (!instance_ids.insert(launches[i]["instanceId"].asString()).second) {
+      reply["returnValue"] = false;
+      reply["errorCode"] = kErrCodeInvalidParam;
+      reply["errorText"] = kErrInvalidParam + " (duplicate instanceId)";
+      reply["index"] = i;
+      return reply;
+    }
+  }
+
+  OnLaunchBatchBegin();
+  Json::Value results(Json::arrayValue);
+  std::vector<std::string> launched;
+  std::vector<Json::ArrayIndex> queued;
+  for (const Json::Value& launch : launches) {
+    Json::Value result = Launch(launch);
+    if (result["returnValue"].asBool()) {
+      launched.push_back(result["instanceId"].asString());
+      if (IsLaunchQueued(launched.back())) {
+        queued.push_back(results.size());
+      }
+    }
+    results.append(std::move(result));
+  }
+  OnLaunchBatchEnd(launched);
+
+  reply["returnValue"] = true;
+  reply["results"] = std::move(results);
+  if (queued.empty()) {
+    return reply;
+  }
+
+  // Held until every queued launch of the batch has started or failed
+  ReplySender send = DeferReply();
+  if (!send) {
+    return reply;
+  }
+  auto batch = std::make_shared<Json::Value>(std::move(reply));
+  auto outstanding = std::make_shared<size_t>(queued.size());
+  for (Json::ArrayIndex i : queued) {
+    bool waiting = OnReplyWhenLaunched(
+        (*batch)["results"][i]["instanceId"].asString(),
+        [send, batch, outstanding, i](const Json::Value& result) {
+          Json::Value& entry = (*batch)["results"][i];
+          for (const std::string& key : result.getMemberNames()) {
+            entry[key] = result[key];
+          }
+          if (--*outstanding == 0) {
+            send(*batch);
+          }
+        });
+    if (!waiting) {
+      --*outstanding;
+    }
+  }
+  if (*outstanding == 0) {
+    send(*batch);
+  }
+  return Json::Value();
+}
+
+bool WebAppManagerServiceLuna::CheckLaunchRequest(const Json::Value& request,
+                                                  Json::Value& reply) {
+  if (!CheckRequest(launch_app_schema_, request, kErrCodeLaunchappMissParam,
+                    kErrMissParam, reply)) {
+    return false;
+  }
+
+  if (!IsValidInstanceId(request["instanceId"].asString())) {
     reply["returnValue"] = false;
     reply["errorCode"] = kErrCodeLaunchappMissParam;
     reply["errorText"] = kErrMissParam;
-    return reply;
+    return false;
   }
+  return true;
+}
+
+Json::Value WebAppManagerServiceLuna::Launch(const Json::Value& request) {
+  int err_code;
+  std::string err_msg;
+  Json::Value reply;
 
   Json::Value json_params = request["parameters"];
   if (request.isMember("launchHidden") && request["launchHidden"] == true) {
@@ -106,12 +315,6 @@ Json::Value WebAppManagerServiceLuna::launchApp(const Json::Value& request) {
   }
 
   std::string instance_id = request["instanceId"].asString();
-  if (!IsValidInstanceId(instance_id)) {
-    reply["returnValue"] = false;
-    reply["errorCode"] = kErrCodeLaunchappMissParam;
-    reply["errorText"] = kErrMissParam;
-    return reply;
-  }
   json_params["instanceId"] = instance_id;
 
   std::string str_params = util::JsonToString(json_params);
@@ -148,13 +351,8 @@ bool WebAppManagerServiceLuna::IsValidInstanceId(
 Json::Value WebAppManagerServiceLuna::killApp(const Json::Value& request) {
   Json::Value reply;
 
-  if (!request.isObject() ||
-      (request.isMember("instanceId") && !request["instanceId"].isString()) ||
-      (request.isMember("appId") && !request["appId"].isString()) ||
-      (request.isMember("reason") && !request["reason"].isString())) {
-    reply["returnValue"] = false;
-    reply["errorCode"] = kErrCodeInvalidParam;
-    reply["errorText"] = kErrInvalidParam;
+  if (!CheckRequest(kill_app_schema_, request, kErrCodeInvalidParam,
+                    kErrInvalidParam, reply)) {
     return reply;
   }
 
@@ -191,11 +389,8 @@ Json::Value WebAppManagerServiceLuna::killApp(const Json::Value& request) {
 Json::Value WebAppManagerServiceLuna::pauseApp(const Json::Value& request) {
   Json::Value reply;
 
-  if (!request.isObject() ||
-      (!request.isMember("instanceId") || !request["instanceId"].isString())) {
-    reply["returnValue"] = false;
-    reply["errorCode"] = kErrCodeInvalidParam;
-    reply["errorText"] = kErrInvalidParam;
+  if (!CheckRequest(pause_app_schema_, request, kErrCodeInvalidParam,
+                    kErrInvalidParam, reply)) {
     return reply;
   }
 
@@ -238,13 +433,9 @@ Json::Value WebAppManagerServiceLuna::closeAllApps(
 }
 
 Json::Value WebAppManagerServiceLuna::logControl(const Json::Value& request) {
-  if (!request.isObject() ||
-      (!request.isMember("keys") || !request["keys"].isString()) ||
-      (!request.isMember("value") || !request["value"].isString())) {
-    Json::Value reply;
-    reply["returnValue"] = false;
-    reply["errorCode"] = kErrCodeInvalidParam;
-    reply["errorText"] = kErrInvalidParam;
+  Json::Value reply;
+  if (!CheckRequest(log_control_schema_, request, kErrCodeInvalidParam,
+                    kErrInvalidParam, reply)) {
     return reply;
   }
 
@@ -252,33 +443,119 @@ Json::Value WebAppManagerServiceLuna::logControl(const Json::Value& request) {
                                             request["value"].asString());
 }
 
-Json::Value WebAppManagerServiceLuna::getWebProcessSize(
+void WebAppManagerServiceLuna::getWebProcessSize(
+    const Json::Value& /*request*/,
+    JsonWriter* reply) {
+  WebAppManagerService::GetWebProcessProfiling(reply);
+}
+
+Json::Value WebAppManagerServiceLuna::getConfig(
     const Json::Value& /*request*/) {
-  return WebAppManagerService::GetWebProcessProfiling();
+  Json::Value reply;
+  reply["config"] = WebAppManagerService::GetConfiguration();
+  reply["overridePath"] = WebAppManagerService::GetConfigurationOverridePath();
+  reply["returnValue"] = true;
+  return reply;
 }
 
-Json::Value WebAppManagerServiceLuna::listRunningApps(
-    const Json::Value& request,
-    bool /*subscribed*/) {
-  bool include_sys_apps = request["includeSysApps"] == true;
+Json::Value WebAppManagerServiceLuna::reloadConfig(
+    const Json::Value& /*request*/) {
+  Json::Value reply;
 
-  std::vector<ApplicationInfo> apps =
-      WebAppManagerService::List(include_sys_apps);
+  // Only the system override file is read: the configuration decides where
+  // plugins and scripts are loaded from
+  if (!WebAppManagerService::OnReloadConfiguration()) {
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeReloadConfigFailed;
+    reply["errorText"] = kErrReloadConfigFailed;
+    return reply;
+  }
+
+  reply["config"] = WebAppManagerService::GetConfiguration();
+  reply["overridePath"] = WebAppManagerService::GetConfigurationOverridePath();
+  reply["returnValue"] = true;
+  return reply;
+}
+
+Json::Value WebAppManagerServiceLuna::getServiceStats(
+    const Json::Value& request) {
+  Json::Value reply;
+
+  if (!CheckRequest(get_service_stats_schema_, request, kErrCodeInvalidParam,
+                    kErrInvalidParam, reply)) {
+    return reply;
+  }
+
+  // Latencies are in microseconds, payload sizes in bytes, launch queue
+  // waits in milliseconds
+  bool reset = request["reset"].asBool();
+  reply = Stats().ToJson();
+  reply["launches"] = WebAppManagerService::GetLaunchStats(reset);
+  if (reset) {
+    Stats().Reset();
+  }
+  reply["returnValue"] = true;
+  return reply;
+}
 
+Json::Value WebAppManagerServiceLuna::getLaunchTimelines(
+    const Json::Value& request) {
   Json::Value reply;
-  Json::Value running_apps;
-  for (const ApplicationInfo& app_info : apps) {
-    Json::Value app_json;
-    app_json["id"] = app_info.app_id_;
-    app_json["instanceId"] = app_info.instance_id_;
-    app_json["webprocessid"] = std::to_string(app_info.pid_);
-    running_apps.append(app_json);
-  }
-  reply["running"] = std::move(running_apps);
+
+  if (!CheckRequest(get_launch_timelines_schema_, request,
+                    kErrCodeInvalidParam, kErrInvalidParam, reply)) {
+    return reply;
+  }
+
+  // Stage times are in milliseconds
+  reply = WebAppManagerService::GetLaunchTimelines(request["reset"].asBool());
   reply["returnValue"] = true;
   return reply;
 }
 
+Json::Value WebAppManagerServiceLuna::getMainLoopLag(
+    const Json::Value& request) {
+  Json::Value reply;
+
+  if (!CheckRequest(get_main_loop_lag_schema_, request, kErrCodeInvalidParam,
+                    kErrInvalidParam, reply)) {
+    return reply;
+  }
+
+  reply = WebAppManagerService::GetMainLoopLag(request["reset"].asBool());
+  reply["returnValue"] = true;
+  return reply;
+}
+
+void WebAppManagerServiceLuna::listRunningApps(const Json::Value& request,
+                                               bool /*subscribed*/,
+                                               JsonWriter* reply) {
+  bool include_sys_apps = request["includeSysApps"] == true;
+
+  std::vector<ApplicationInfo> apps =
+      WebAppManagerService::List(include_sys_apps);
+
+  // Clients get null, not an empty array, when nothing runs
+  reply->Key("running");
+  if (apps.empty()) {
+    reply->Null();
+  } else {
+    reply->BeginArray();
+    for (const ApplicationInfo& app_info : apps) {
+      reply->BeginObject()
+          .Key("id")
+          .String(app_info.app_id_)
+          .Key("instanceId")
+          .String(app_info.instance_id_)
+          .Key("webprocessid")
+          .String(std::to_string(app_info.pid_))
+          .EndObject();
+    }
+    reply->EndArray();
+  }
+  reply->Key("returnValue").Bool(true);
+}
+
 Json::Value WebAppManagerServiceLuna::clearBrowsingData(
     const Json::Value& request) {
   Json::Value reply;
@@ -456,7 +733,7 @@ void WebAppManagerServiceLuna::MemoryManagerConnectCallback(
     if (!Call<WebAppManagerServiceLuna,
               &WebAppManagerServiceLuna::GetCloseAppIdCallback>(
             "luna://com.webos.service.memorymanager/getManagerEvent",
-            std::move(close_app_obj), this)) {
+            std::move(close_app_obj), this, "GetCloseAppIdCallback")) {
       LOG_WARNING(MSGID_MEM_MGR_API_CALL_FAIL, 0,
                   "Failed to get close application identifier");
     }
@@ -468,7 +745,7 @@ void WebAppManagerServiceLuna::MemoryManagerConnectCallback(
     if (!Call<WebAppManagerServiceLuna,
               &WebAppManagerServiceLuna::ThresholdChangedCallback>(
             "luna://com.palm.bus/signal/addmatch", std::move(threshold_changed),
-            this)) {
+            this, "ThresholdChangedCallback")) {
       LOG_WARNING(MSGID_SIGNAL_REGISTRATION_FAIL, 0,
                   "Failed to register a client for thresholdChanged");
     }
@@ -530,7 +807,8 @@ void WebAppManagerServiceLuna::ApplicationManagerConnectCallback(
 
     if (!Call<WebAppManagerServiceLuna,
               &WebAppManagerServiceLuna::GetAppStatusCallback>(
-            "luna://com.webos.applicationManager/listApps", params, this)) {
+            "luna://com.webos.applicationManager/listApps", params, this,
+            "GetAppStatusCallback")) {
       LOG_WARNING(MSGID_APP_MGR_API_CALL_FAIL, 0,
                   "Failed to get an application list");
     }
@@ -539,7 +817,7 @@ void WebAppManagerServiceLuna::ApplicationManagerConnectCallback(
     if (!Call<WebAppManagerServiceLuna,
               &WebAppManagerServiceLuna::GetForegroundAppInfoCallback>(
             "luna://com.webos.applicationManager/getForegroundAppInfo",
-            std::move(params), this)) {
+            std::move(params), this, "GetForegroundAppInfoCallback")) {
       LOG_WARNING(MSGID_APP_MGR_API_CALL_FAIL, 0,
                   "Failed to get foreground application Information");
     }
@@ -621,7 +899,11 @@ void WebAppManagerServiceLuna::GetBootStatusCallback(const Json::Value& reply) {
     return;
   }
 
-  boot_done_ = reply["signals"]["boot-done"] == true;
+  bool boot_done = reply["signals"]["boot-done"] == true;
+  if (boot_done != boot_done_) {
+    boot_done_ = boot_done;
+    OnBootDone(boot_done_);
+  }
 }
 
 void WebAppManagerServiceLuna::CloseApp(const std::string& id) {
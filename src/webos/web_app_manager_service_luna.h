@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include "json_schema.h"
 #include "palm_service_base.h"
 #include "web_app_manager_service.h"
 
@@ -40,17 +41,25 @@ class WebAppManagerServiceLuna : public PalmServiceBase,
   // NOTE: Names of the functions are used for LUNA mapping so, we keep them in
   // lowerCamelCase for compatibility with LUNA definitions
   Json::Value launchApp(const Json::Value& request) override;
+  Json::Value launchApps(const Json::Value& request) override;
   Json::Value killApp(const Json::Value& request) override;
   Json::Value logControl(const Json::Value& request) override;
   Json::Value setInspectorEnable(const Json::Value& request) override;
   Json::Value closeAllApps(const Json::Value& request) override;
-  Json::Value listRunningApps(const Json::Value& request,
-                              bool subscribed) override;
-  Json::Value getWebProcessSize(const Json::Value& request) override;
+  void listRunningApps(const Json::Value& request,
+                       bool subscribed,
+                       JsonWriter* reply) override;
+  void getWebProcessSize(const Json::Value& request,
+                         JsonWriter* reply) override;
   Json::Value pauseApp(const Json::Value& request) override;
   Json::Value clearBrowsingData(const Json::Value& request) override;
   Json::Value webProcessCreated(const Json::Value& request,
                                 bool subscribed) override;
+  Json::Value getConfig(const Json::Value& request) override;
+  Json::Value reloadConfig(const Json::Value& request) override;
+  Json::Value getServiceStats(const Json::Value& request) override;
+  Json::Value getLaunchTimelines(const Json::Value& request) override;
+  Json::Value getMainLoopLag(const Json::Value& request) override;
 
   // PlamServiceBase
   void DidConnect() override;
@@ -89,6 +98,24 @@ class WebAppManagerServiceLuna : public PalmServiceBase,
 
  private:
   bool IsValidInstanceId(const std::string& instance_id);
+  // Checks a single launchApp request, filling |reply| with the error
+  bool CheckLaunchRequest(const Json::Value& request, Json::Value& reply);
+  // Launches a request which passed CheckLaunchRequest()
+  Json::Value Launch(const Json::Value& request);
+  // Sends |reply| once the first frame of |instance_id| is shown
+  void SendOnFirstFrame(const std::string& instance_id,
+                        ReplySender send,
+                        Json::Value reply);
+
+  // Request schemas, compiled once with the service
+  const JsonSchema launch_app_schema_;
+  const JsonSchema launch_apps_schema_;
+  const JsonSchema kill_app_schema_;
+  const JsonSchema pause_app_schema_;
+  const JsonSchema log_control_schema_;
+  const JsonSchema get_service_stats_schema_;
+  const JsonSchema get_launch_timelines_schema_;
+  const JsonSchema get_main_loop_lag_schema_;
 };
 
 #endif  // WEBOS_WEB_APP_MANAGER_SERVICE_LUNA_H_
@@ -23,7 +23,7 @@
 
 #define LS2_CALL(FUNC, SERVICE, PARAMS)                                    \
   Call<WebAppManagerServiceLunaImpl, &WebAppManagerServiceLunaImpl::FUNC>( \
-      SERVICE, PARAMS, this)
+      SERVICE, PARAMS, this, #FUNC)
 
 WebAppManagerServiceLuna* WebAppManagerServiceLuna::Instance() {
   static WebAppManagerServiceLuna* service = new WebAppManagerServiceLunaImpl();